@@ -8,7 +8,8 @@
  * This file contains the main routine for the NVT program that is part of
  * the Very Coarse Grained disc simulation programmes.
  *
- * The programme loads a configuration and then runs a monte carlo integration
+ * The programme loads a configuration, removes any hard core overlaps (see the
+ * relaxer class), and then runs a monte carlo integration
  * in the NVT ensemble in which for each move a random object is selected and
  * moved to a new location and rotated to a new orientation. This modified
  * configuration is accepted according to the Metropolis criterion, the
@@ -20,10 +21,88 @@
  *
  * To use the program the command line is:
  *
- *      NVT n_steps print_frequency beta pressure initial_config final_config
+ *      NVT [options] n_steps print_frequency beta pressure initial_config final_config
+ *
+ * The options, that come before the other parameters, are:
+ *      --coarse n      Start with n steps in which each object is replaced by
+ *                      a single disc proxy (see topology::proxy()), this is
+ *                      much faster and gets the density and packing close to
+ *                      equilibrium before the full topology is used for the
+ *                      n_steps of production. Overlaps of the full objects,
+ *                      if any, are removed between the two stages.
+ *      --delayed       Use delayed acceptance, the moves are first screened
+ *                      with a cheap object level surrogate energy and only
+ *                      those that pass are evaluated atom by atom (see
+ *                      integrator). The sampling is unchanged.
+ *      --sample k      The analyses are made every k sweeps (of n_objects
+ *                      steps) during the production run (1).
+ *      --rdf file      Accumulate the radial distribution function, total and
+ *                      for each pair of object types, in file (see rdf).
+ *      --rdf-range r   The range of the radial distribution function (10).
+ *      --rdf-bin dr    The bin width of the radial distribution function (0.1).
+ *      --opcf file     Accumulate the orientation resolved pair correlation
+ *                      function g(r, dtheta, phi) in file (see opcf).
+ *      --opcf-range r  Its range (6).
+ *      --opcf-bin dr   Its distance bin width (0.2).
+ *      --opcf-angles n Its number of bins for each angle (36).
+ *      --cluster file  Find the clusters of objects in contact and write their
+ *                      statistics and size histogram in file (see cluster).
+ *      --cluster-gap f Objects are in contact if two atoms are closer than f
+ *                      times their hard core distance (1.1).
+ *      --cluster-energy e  Objects are in contact if their interaction energy
+ *                      is below e (instead of the distance criterion).
+ *      --order file    Calculate the bond orientational (psi6, psi4) and
+ *                      nematic order parameters, write their averages and the
+ *                      local fields of the last sample in file and the global
+ *                      values to the log at each report (see order).
+ *      --order-range r Neighbours are the objects closer than r (default the
+ *                      nearest six, or four for psi4).
+ *      --order-voronoi The neighbours are those in the Voronoi tessellation.
+ *      --voronoi file  Tessellate the configuration and write the mean cell
+ *                      area, neighbour distribution and defects of each type
+ *                      in file and to the log at each report (see tessellation).
+ *      --voronoi-radical   Use the radical tessellation, weighted by the reach
+ *                      of the objects.
+ *      --sk file       Accumulate the structure factor S(k), total and for
+ *                      each pair of object types, in file (see sfactor).
+ *      --sk-grid n     The number of grid points along each side of the box
+ *                      for S(k), a power of two (128).
+ *      --sk-atoms      Use the atoms for S(k) rather than the object centers.
+ *      --msd file      Calculate the mean squared displacement of the objects,
+ *                      for each type, with a multiple tau correlator, write it
+ *                      to file and the longest lag to the log (see msd).
+ *      --sampling file Estimate the autocorrelation time and effective number
+ *                      of samples of the energy and of the summary value of
+ *                      each other analysis, with the effective samples per
+ *                      processor second, in file and the log (see sampling).
+ *      --frames file   Record the energy and the summary value of each other
+ *                      analysis for every sample in file, for histogram
+ *                      reweighting (see frames and the reweight program).
+ *      --trajectory file   Append each sampled configuration to file (see
+ *                      trajectory and the ffreweight program).
+ *      --converge file Stop the run, at a report, once it has equilibrated and
+ *                      the errors of the means of the energy and of the
+ *                      summary values of the other analyses are small enough,
+ *                      the reason is written to the log and the estimates to
+ *                      file (see convergence). The final configuration is
+ *                      then written as usual.
+ *      --converge-error tol    The error target relative to the mean, or to
+ *                      the standard deviation if larger (0.01).
+ *      --converge-drift z  Largest difference, in errors, of the means of the
+ *                      two halves of an equilibrated run (2).
+ *      --converge-min n    Fewest samples before stopping (100).
+ *      --converge-watch names  Comma separated names of the analyses watched
+ *                      with the energy (default all those with a summary value).
+ *      --forces file   Change the force field parameters given in file (see
+ *                      force_field::read()).
+ *      --threads n     The number of threads used by the analyses (1).
+ *
+ * The analysis results are written at each report and at the end, when the
+ * log also gives the number of samples and the time used by each analysis.
  *
  * Where the various parameters are:
- *      n_steps         The number of simulation steps to make.
+ *      n_steps         The number of simulation steps to make (at most with
+ *                      --converge).
  *      print_frequency The number of steps between reports to the log file
  *                      of how the integration is progressing.
  *      beta            The temperature parameter 1/(kb T) that scales the
@@ -42,13 +121,26 @@
  * program ends with the standard exit codes EXIT_SUCCESS or EXIT_FAILURE.
  *
  * Log file format:
- * The format of the log file is determined in this file by the print statements:
- *      lines 196-201   After loading the file.
- *      lines 228-232   After the initial adjustments
- *      lines 249-257   Every print_frequency steps during the integration.
- *      line 268        At the end of the program.
+ * The format of the log file is determined in this file by the print statements
+ * of the functions:
+ *      report()            Report of the state.
+ *      main()              After loading the file, followed by a report.
+ *      main()              Before and after the coarse stage, followed by a report.
+ *      remove_overlaps()   After the removal of overlaps (if any), followed by a report.
+ *      integrate()         Every print_frequency steps during the integration.
+ *      main()              With --converge, after the integration, why it stopped.
+ *      main()              After the integration, one line for each analysis.
+ *      main()              At the end of the program.
  *
  * Each report, except the last, contains 3 lines of slightly variable content.
+ * The report after the removal of overlaps has an extra line with the number
+ * of overlapping objects, the relaxation iterations and the time taken. With
+ * delayed acceptance the integration reports have an extra line with the
+ * number of moves rejected by the surrogate and of full energy evaluations.
+ * Analyses that follow global values during the run add their own lines to
+ * the integration reports (see analyzer::log()), for example one line per
+ * object type with the order parameters, or the status of the convergence
+ * controller.
  *
  * \todo log file       Use a dedicated function for writing data so it is easier
  *                      to parse after and control the structure.  Perhaps in
@@ -98,11 +190,25 @@
  *      my_length       The length scale for interactions.
  *
  * \todo force_field    Convert lengths to by interaction basis (a matrix).
- * \todo force_field    Read force_field from a control file or a force field file.
+ * The parameters can be changed with a force field file (option --forces),
+ * see force_field::read() for its format.
  */
 
 #include <cstdlib>
+#include <string.h>
 #include "integrator.h"
+#include "relaxer.h"
+#include "rdf.h"
+#include "opcf.h"
+#include "cluster.h"
+#include "order.h"
+#include "sfactor.h"
+#include "msd.h"
+#include "tessellation.h"
+#include "sampling.h"
+#include "frames.h"
+#include "trajectory.h"
+#include "convergence.h"
 #include "common.h"
 
 using namespace std;
@@ -115,7 +221,145 @@ using namespace std;
 
 void usage(){
     fprintf(stderr, "Usage: NVT %s\n",
-        "n_steps print_frequency beta pressure initial_config final_config");
+        "[--coarse n] [--delayed] [--sample k] [--threads n]\n"
+        "           [--rdf file [--rdf-range r] [--rdf-bin dr]]\n"
+        "           [--opcf file [--opcf-range r] [--opcf-bin dr] [--opcf-angles n]]\n"
+        "           [--cluster file [--cluster-gap f | --cluster-energy e]]\n"
+        "           [--order file [--order-range r | --order-voronoi]]\n"
+        "           [--voronoi file [--voronoi-radical]]\n"
+        "           [--sk file [--sk-grid n] [--sk-atoms]] [--msd file]\n"
+        "           [--sampling file] [--frames file] [--trajectory file]\n"
+        "           [--converge file [--converge-error tol] [--converge-drift z]\n"
+        "           [--converge-min n] [--converge-watch names]] [--forces file]\n"
+        "           n_steps print_frequency beta pressure initial_config final_config");
+}
+
+/**
+ * @brief Report the state of the configuration to the log.
+ * @param the_log   The log file.
+ * @param state     The configuration.
+ * @param the_forces    The force field.
+ * @param P1        The pressure.
+ * @param beta      The temperature parameter.
+ */
+void report(FILE *the_log, config *state, force_field *the_forces,
+            double P1, double beta){
+    double  U1 = state->energy(the_forces);
+    double  V1 = state->area();
+    int     N1 = state->n_objects();
+
+    fprintf( the_log, "N objects = %9d Pressure = %9g   Beta = %9g\n",
+            N1, P1, beta);
+    fprintf( the_log, "Area      = %9g  Density = %9g Energy = %9g\n",
+            V1, N1/V1, U1);
+}
+
+/**
+ * @brief Remove the hard core overlaps, if any, and report.
+ * @param the_log   The log file.
+ * @param state     The configuration, modified.
+ * @param the_forces    The force field.
+ * @param P1        The pressure.
+ * @param beta      The temperature parameter.
+ */
+void remove_overlaps(FILE *the_log, config *state, force_field *the_forces,
+                     double P1, double beta){
+    relaxer     *the_relaxer;
+
+    if(state->energy(the_forces) > the_forces->big_energy){
+        the_relaxer = new relaxer(the_forces);
+        if(the_relaxer->run(state, 1000*state->n_objects()) < 0){
+            fatal_error(
+                "Unable to remove overlaps in %d iterations\n",
+                the_relaxer->n_iter );
+        }
+        fprintf( the_log, "After initial adjustments:\n");
+        fprintf( the_log, "Overlaps  = %9d  Iterations = %9d Time = %9g s\n",
+            the_relaxer->n_overlap, the_relaxer->n_iter,
+            the_relaxer->seconds);
+        report(the_log, state, the_forces, P1, beta);
+        delete the_relaxer;
+    }
+}
+
+/**
+ * @brief Run the Monte Carlo integration with reports to the log.
+ *
+ * The integration is made in chunks that end at the reports and at the
+ * samples of the analyzers. The analyzer results are saved at each report.
+ * With a convergence controller the integration stops at the first report
+ * at which it has converged.
+ *
+ * @param the_log   The log file.
+ * @param state_h   Handle to the configuration, updated.
+ * @param the_forces    The force field.
+ * @param P1        The pressure.
+ * @param beta      The temperature parameter.
+ * @param it_max    The number of steps.
+ * @param n_print   The number of steps between reports.
+ * @param delayed   Use delayed acceptance.
+ * @param analyzers The analyses to make (can be empty).
+ * @param n_sample  The number of steps between analyzer samples.
+ * @param controller    The convergence controller, one of the analyzers (or
+ *                  NULL).
+ * @return          The number of steps made.
+ */
+int integrate(FILE *the_log, config **state_h, force_field *the_forces,
+              double P1, double beta, int it_max, int n_print, bool delayed,
+              vector<analyzer *> &analyzers, int n_sample,
+              convergence *controller){
+    integrator  *the_integrator = new integrator(the_forces);
+    config      *current_state = *state_h;
+    double      U1, V1;
+    int         N1, i, step;
+    int         next_print, next_sample;
+    bool        done = false;
+
+    the_integrator->dl_max = min(current_state->x_size, current_state->y_size)/2.0;
+    the_integrator->delayed = delayed;
+    if(n_print < 1) n_print = it_max;
+    if(analyzers.empty() || n_sample < 1) n_sample = it_max + 1;
+    next_print  = n_print;
+    next_sample = n_sample;
+    for(i=0;i<it_max && !done;i+=step){
+        step = min(it_max-i, min(next_print-i, next_sample-i));
+        the_integrator->run(&current_state, beta, P1, step);
+
+        if(i+step == next_sample){
+            for(unsigned int k = 0; k < analyzers.size(); k++)
+                analyzers[k]->measure(current_state);
+            next_sample += n_sample;
+        }
+        if(i+step < next_print && i+step < it_max) continue;
+        next_print += n_print;
+
+        U1 = current_state->energy(the_forces);
+        V1 = current_state->area();
+        N1 = current_state->n_objects();
+
+        fprintf(the_log, "After %d steps N = %d, P = %g, beta = %g\n",
+                i+step, N1, P1, beta );
+        fprintf(the_log, "Area = %g, Density = %g Energy = %g\n",
+                V1, N1/V1, U1);
+        fprintf(the_log, "Moves %d in %d, Dist_max = %g\n",
+                the_integrator->n_good,
+                the_integrator->n_good + the_integrator->n_bad,
+                the_integrator->dl_max );
+        if(delayed)
+            fprintf(the_log, "Screened %d in %d, Full evaluations %d\n",
+                    the_integrator->n_screened,
+                    the_integrator->n_good + the_integrator->n_bad,
+                    the_integrator->n_good + the_integrator->n_bad
+                        - the_integrator->n_screened );
+        if(controller) done = controller->check();
+        for(unsigned int k = 0; k < analyzers.size(); k++){
+            analyzers[k]->save();
+            analyzers[k]->log(the_log);
+        }
+    }
+    delete the_integrator;
+    *state_h = current_state;
+    return i;
 }
 
 /*
@@ -124,23 +368,54 @@ void usage(){
 int main(int argc, char** argv) {
     char        *fname;
     config      *current_state;
-    config      **state_h;
     force_field *the_forces = new force_field(); // This memory is lost
-    integrator  *the_integrator = NULL;
     topology    *a_topology;
 
     FILE        *src1;
     FILE        *dest1;
     FILE        *the_log;
 
-    int         N1;
-    double      U1, V1;
-    int         i, step;
+    int         i;
+    double      cut_off;
 
     int         it_max  =  10000;
     int         n_print =   1000;
+    int         n_coarse =     0;
+    int         n_sweeps =     1;
+    bool        delayed = false;
+    char        *rdf_file = NULL;
+    double      rdf_range =  10.0;
+    double      rdf_bin  =    0.1;
+    char        *opcf_file = NULL;
+    double      opcf_range =  6.0;
+    double      opcf_bin  =   0.2;
+    int         opcf_angles =  36;
+    char        *cluster_file = NULL;
+    double      cluster_gap =  1.1;
+    bool        cluster_by_energy = false;
+    double      cluster_energy = 0.0;
+    char        *order_file = NULL;
+    double      order_range =  0.0;
+    char        *sk_file = NULL;
+    int         sk_grid =     128;
+    bool        sk_atoms =  false;
+    char        *msd_file = NULL;
+    bool        order_voronoi = false;
+    char        *voronoi_file = NULL;
+    bool        voronoi_radical = false;
+    char        *sampling_file = NULL;
+    char        *frames_file = NULL;
+    char        *trajectory_file = NULL;
+    char        *converge_file = NULL;
+    char        *converge_watch = NULL;
+    double      converge_error = 0.01;
+    double      converge_drift =  2.0;
+    int         converge_min =    100;
+    int         n_done;
+    convergence *controller = NULL;
+    int         n_threads =     1;
+    vector<analyzer *>  analyzers, no_analyzers;
     double      beta    =    1.0;
-    double      dl_max  =  100.0;
     double      P1      =    1.0;
 
     // Initialization
@@ -148,15 +423,101 @@ int main(int argc, char** argv) {
     srand((long)&argv[0]);
     the_log = stderr;
 
-    // Handle command line
-
-    /***************************************************************************
-     *  TODO: Reorganize command line handling to allow 'flag value' syntax
-     *        with defaults.
-     **************************************************************************/
-    if(argc != 7){
-        fatal_error("Wrong number of arguments: %d but expected 6\n", argc-1);
+    // Handle command line, options then the positional arguments
+
+    for(i = 1; (i < argc) && (argv[i][0] == '-') && (argv[i][1] == '-'); i++){
+        if(!strcmp(argv[i], "--coarse") && (i+1 < argc)){
+            n_coarse = atoi(argv[++i]);
+            if(n_coarse < 0) fatal_error("Bad number of coarse steps: %d\n", n_coarse);
+        } else if(!strcmp(argv[i], "--delayed")){
+            delayed = true;
+        } else if(!strcmp(argv[i], "--sample") && (i+1 < argc)){
+            n_sweeps = atoi(argv[++i]);
+            if(n_sweeps < 1) fatal_error("Bad number of sweeps: %d\n", n_sweeps);
+        } else if(!strcmp(argv[i], "--rdf") && (i+1 < argc)){
+            rdf_file = argv[++i];
+        } else if(!strcmp(argv[i], "--rdf-range") && (i+1 < argc)){
+            rdf_range = atof(argv[++i]);
+            if(rdf_range <= 0.0) fatal_error("Bad rdf range: %g\n", rdf_range);
+        } else if(!strcmp(argv[i], "--rdf-bin") && (i+1 < argc)){
+            rdf_bin = atof(argv[++i]);
+            if(rdf_bin <= 0.0) fatal_error("Bad rdf bin width: %g\n", rdf_bin);
+        } else if(!strcmp(argv[i], "--opcf") && (i+1 < argc)){
+            opcf_file = argv[++i];
+        } else if(!strcmp(argv[i], "--opcf-range") && (i+1 < argc)){
+            opcf_range = atof(argv[++i]);
+            if(opcf_range <= 0.0) fatal_error("Bad opcf range: %g\n", opcf_range);
+        } else if(!strcmp(argv[i], "--opcf-bin") && (i+1 < argc)){
+            opcf_bin = atof(argv[++i]);
+            if(opcf_bin <= 0.0) fatal_error("Bad opcf bin width: %g\n", opcf_bin);
+        } else if(!strcmp(argv[i], "--opcf-angles") && (i+1 < argc)){
+            opcf_angles = atoi(argv[++i]);
+            if(opcf_angles < 1) fatal_error("Bad number of opcf angles: %d\n", opcf_angles);
+        } else if(!strcmp(argv[i], "--cluster") && (i+1 < argc)){
+            cluster_file = argv[++i];
+        } else if(!strcmp(argv[i], "--cluster-gap") && (i+1 < argc)){
+            cluster_gap = atof(argv[++i]);
+            if(cluster_gap <= 0.0) fatal_error("Bad cluster gap: %g\n", cluster_gap);
+        } else if(!strcmp(argv[i], "--cluster-energy") && (i+1 < argc)){
+            cluster_energy = atof(argv[++i]);
+            cluster_by_energy = true;
+        } else if(!strcmp(argv[i], "--order") && (i+1 < argc)){
+            order_file = argv[++i];
+        } else if(!strcmp(argv[i], "--order-range") && (i+1 < argc)){
+            order_range = atof(argv[++i]);
+            if(order_range <= 0.0) fatal_error("Bad order range: %g\n", order_range);
+        } else if(!strcmp(argv[i], "--sk") && (i+1 < argc)){
+            sk_file = argv[++i];
+        } else if(!strcmp(argv[i], "--sk-grid") && (i+1 < argc)){
+            sk_grid = atoi(argv[++i]);
+            if(sk_grid < 2 || (sk_grid & (sk_grid-1)))
+                fatal_error("Grid size is not a power of two: %d\n", sk_grid);
+        } else if(!strcmp(argv[i], "--sk-atoms")){
+            sk_atoms = true;
+        } else if(!strcmp(argv[i], "--msd") && (i+1 < argc)){
+            msd_file = argv[++i];
+        } else if(!strcmp(argv[i], "--order-voronoi")){
+            order_voronoi = true;
+        } else if(!strcmp(argv[i], "--voronoi") && (i+1 < argc)){
+            voronoi_file = argv[++i];
+        } else if(!strcmp(argv[i], "--voronoi-radical")){
+            voronoi_radical = true;
+        } else if(!strcmp(argv[i], "--sampling") && (i+1 < argc)){
+            sampling_file = argv[++i];
+        } else if(!strcmp(argv[i], "--frames") && (i+1 < argc)){
+            frames_file = argv[++i];
+        } else if(!strcmp(argv[i], "--trajectory") && (i+1 < argc)){
+            trajectory_file = argv[++i];
+        } else if(!strcmp(argv[i], "--converge") && (i+1 < argc)){
+            converge_file = argv[++i];
+        } else if(!strcmp(argv[i], "--converge-error") && (i+1 < argc)){
+            converge_error = atof(argv[++i]);
+            if(converge_error <= 0.0) fatal_error("Bad error target: %g\n", converge_error);
+        } else if(!strcmp(argv[i], "--converge-drift") && (i+1 < argc)){
+            converge_drift = atof(argv[++i]);
+            if(converge_drift <= 0.0) fatal_error("Bad drift limit: %g\n", converge_drift);
+        } else if(!strcmp(argv[i], "--converge-min") && (i+1 < argc)){
+            converge_min = atoi(argv[++i]);
+            if(converge_min < 2) fatal_error("Bad number of samples: %d\n", converge_min);
+        } else if(!strcmp(argv[i], "--converge-watch") && (i+1 < argc)){
+            converge_watch = argv[++i];
+        } else if(!strcmp(argv[i], "--forces") && (i+1 < argc)){
+            if(! (src1 = fopen(argv[++i], "r")))
+                fatal_error("Unable to open %s for reading\n", argv[i]);
+            if(the_forces->read(src1) < 0)
+                fatal_error("Bad force field file %s\n", argv[i]);
+            fclose(src1);
+        } else if(!strcmp(argv[i], "--threads") && (i+1 < argc)){
+            n_threads = atoi(argv[++i]);
+            if(n_threads < 1) fatal_error("Bad number of threads: %d\n", n_threads);
+        } else {
+            fatal_error("Unknown option or missing value: %s\n", argv[i]);
+        }
+    }
+    if(argc - i != 6){
+        fatal_error("Wrong number of arguments: %d but expected 6\n", argc-i);
     }
+    argv += i-1;
     ++argv;
     it_max = atoi(*argv);
     if (it_max<1) fatal_error("Too few iterations: %d\n", it_max);
@@ -187,82 +548,78 @@ int main(int argc, char** argv) {
     // Load the initial configuration
     current_state = new config(src1);
                                     // Add the topology to the configuration.
-    current_state->add_topology(a_topology);
-
-    U1 = current_state->energy(the_forces);
-    V1 = current_state->area();
-    N1 = current_state->n_objects();
+    current_state->add_topology(new topology(a_topology));
 
     // Print report of state
     fprintf( the_log, "Configuration loaded\n");
-    fprintf( the_log, "N objects = %9d Pressure = %9g   Beta = %9g\n",
-            N1, P1, beta);
-    fprintf( the_log, "Area      = %9g  Density = %9g Energy = %9g\n",
-            V1, N1/V1, U1);
-
-    dl_max = min(current_state->x_size, current_state->y_size)/2.0;
-
-    // Jiggle everything to remove bad contacts from save/load
-
-    i = 0;          // Counter for number of shifts.
-    while(U1>the_forces->big_energy){
-        if( i> 2000*N1 ){
-            fatal_error(
-                "Unable to adjust initial configuration in %d steps", i );
-        }
-        the_integrator = new integrator(the_forces);
-        the_integrator->dl_max = dl_max;
-        state_h = &current_state;
-        the_integrator->run(state_h, beta, P1, 2*N1);
-        current_state = *state_h;
-        dl_max = the_integrator->dl_max;
-        i += 2*N1;
-
-        U1 = current_state->energy(the_forces);
+    report(the_log, current_state, the_forces, P1, beta);
+
+    // Equilibrate with single disc proxies then return to the full topology
+
+    if(n_coarse > 0){
+        cut_off = the_forces->cut_off;
+        current_state->add_topology(a_topology->proxy(the_forces));
+        fprintf( the_log, "Coarse stage with single disc proxies:\n");
+        report(the_log, current_state, the_forces, P1, beta);
+        remove_overlaps(the_log, current_state, the_forces, P1, beta);
+        integrate(the_log, &current_state, the_forces, P1, beta,
+                n_coarse, n_print, delayed, no_analyzers, 0, NULL);
+        the_forces->cut_off = cut_off;
+        current_state->add_topology(new topology(a_topology));
+        fprintf( the_log, "Full topology restored:\n");
+        report(the_log, current_state, the_forces, P1, beta);
     }
 
-
-    if( the_integrator ){
-        delete the_integrator;
-        i = 0;
-        fprintf( the_log, "After initial adjustments:\n");
-        fprintf( the_log, "N objects = %9d Pressure = %9g   Beta = %9g\n",
-            N1, P1, beta);
-        fprintf( the_log, "Area      = %9g  Density = %9g Energy = %9g\n",
-            V1, N1/V1, U1);
+    // Remove bad contacts from save/load
+
+    if(rdf_file) analyzers.push_back(new rdf(rdf_file, rdf_range, rdf_bin));
+    if(opcf_file) analyzers.push_back(new opcf(opcf_file, opcf_range, opcf_bin,
+            opcf_angles, n_threads));
+    if(cluster_file) analyzers.push_back(new cluster(cluster_file, the_forces,
+            cluster_gap, cluster_by_energy, cluster_energy, n_threads));
+    if(order_file) analyzers.push_back(new order(order_file, order_range,
+            order_voronoi));
+    if(voronoi_file) analyzers.push_back(new tessellation(voronoi_file,
+            the_forces, voronoi_radical));
+    if(sk_file) analyzers.push_back(new sfactor(sk_file, sk_grid, sk_atoms,
+            n_threads));
+    if(msd_file) analyzers.push_back(new msd(msd_file, n_sweeps));
+    if(sampling_file) analyzers.push_back(new sampling(sampling_file,
+            the_forces, &analyzers));       // Last, after the others
+    if(converge_file){
+        controller = new convergence(converge_file, the_forces, &analyzers,
+                converge_watch, converge_error, converge_drift, converge_min);
+        analyzers.push_back(controller);
     }
+    if(frames_file) analyzers.push_back(new frames(frames_file,
+            the_forces, beta, &analyzers));
+    if(trajectory_file) analyzers.push_back(new trajectory(trajectory_file));
 
-    // Start NVT montecarlo loop
-    step = min(n_print,it_max);
-    the_integrator = new integrator(the_forces);
-    the_integrator->dl_max = dl_max;
-
-    for(i=0;i<it_max;i+=step){
-        state_h = &current_state;
-        the_integrator->run(state_h, beta, P1, step);
-        current_state = *state_h;
+    remove_overlaps(the_log, current_state, the_forces, P1, beta);
 
-        U1 = current_state->energy(the_forces);
-        V1 = current_state->area();
-        N1 = current_state->n_objects();
-
-        fprintf(the_log, "After %d steps N = %d, P = %g, beta = %g\n",
-                i+step, N1, P1, beta );
-        fprintf(the_log, "Area = %g, Density = %g Energy = %g\n",
-                V1, N1/V1, U1);
-        fprintf(the_log, "Moves %d in %d, Dist_max = %g\n",
-                the_integrator->n_good,
-                the_integrator->n_good + the_integrator->n_bad,
-                the_integrator->dl_max );
+    // Start NVT montecarlo loop
 
-        step = min(step,it_max-i);
+    n_done = integrate(the_log, &current_state, the_forces, P1, beta, it_max,
+            n_print, delayed, analyzers, n_sweeps*current_state->n_objects(),
+            controller);
+    if(controller)
+        fprintf(the_log, "%s after %d of %d steps: %s\n",
+                (n_done < it_max) ? "Stopped" : "Finished", n_done, it_max,
+                controller->status());
+    for(unsigned int k = 0; k < analyzers.size(); k++){
+        analyzers[k]->save();
+        fprintf(the_log, "Analysis %s: %d samples in %g s\n",
+                analyzers[k]->name, analyzers[k]->n_samples,
+                analyzers[k]->seconds);
+        delete analyzers[k];
     }
-    delete the_integrator;
+
     // Update log
     // Save result
     current_state->write(dest1);
     // Clean up
     delete current_state;
+    delete a_topology;
     delete the_forces;
 
     fprintf(the_log, "\n...Done...\n");
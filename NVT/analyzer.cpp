@@ -0,0 +1,120 @@
+/**
+ * @file    analyzer.cpp
+ * @author  agent
+ * @date    October 17, 2026
+ *
+ * Implementation of the analyzer base class.
+ */
+
+#include <time.h>
+#include <math.h>
+#include "analyzer.h"
+#include "common.h"
+
+/**
+ * Constructor for an analyzer.
+ *
+ * @param a_name    Name of the analysis used in the log.
+ * @param a_fname   Name of the output file.
+ */
+analyzer::analyzer(const char *a_name, const char *a_fname) {
+    name      = a_name;
+    fname     = a_fname;
+    n_samples = 0;
+    seconds   = 0.0;
+}
+
+/**
+ * Destructor to destroy an analyzer.
+ */
+analyzer::~analyzer() {
+}
+
+/**
+ * Take a sample of a configuration and keep count of the samples and the
+ * time used.
+ *
+ * @param state The configuration.
+ */
+void    analyzer::measure(config *state){
+    clock_t start = clock();
+
+    sample(state);
+    n_samples++;
+    seconds += (double)(clock()-start)/CLOCKS_PER_SEC;
+}
+
+/**
+ * Write the results to the output file, replacing any previous content.
+ *
+ * @return EXIT_SUCCESS or EXIT_FAILURE if the file cannot be written.
+ */
+int     analyzer::save(){
+    FILE    *dest;
+
+    if(! (dest = fopen(fname, "w"))){
+        fprintf(stderr, "Unable to open %s for writing\n", fname);
+        return EXIT_FAILURE;
+    }
+    write(dest);
+    fclose(dest);
+    return EXIT_SUCCESS;
+}
+
+/**
+ * Write a summary of the last sample to the log. By default there is none.
+ *
+ * @param the_log   The log file.
+ * @return          The number of lines written.
+ */
+int     analyzer::log(FILE * /* the_log */){
+    return 0;
+}
+
+/**
+ * One value that summarizes the last sample. By default there is none.
+ *
+ * @param value Set to the value.
+ * @return      True if there is a value.
+ */
+bool    analyzer::scalar(double * /* value */){
+    return false;
+}
+
+/**
+ * Choose, among a list of analyzers, the others that have a summary value
+ * for the last sample.
+ *
+ * @param others    The analyzers, this one may be among them.
+ * @param sources   Set to those with a value, in the order of the list.
+ */
+void    analyzer::scalar_sources(vector<analyzer *> *others,
+                                 vector<analyzer *> &sources){
+    double  value;
+
+    sources.clear();
+    for(unsigned int a = 0; a < others->size(); a++)
+        if((*others)[a] != this && (*others)[a]->scalar(&value))
+            sources.push_back((*others)[a]);
+}
+
+/**
+ * The summary values of the last sample of some analyzers.
+ *
+ * @param sources   The analyzers.
+ * @param values    Set to the value of each, NAN if it has none.
+ * @return          True if all the analyzers have a value.
+ */
+bool    analyzer::scalar_values(vector<analyzer *> &sources,
+                                vector<double> &values){
+    bool    all = true;
+
+    values.resize(sources.size());
+    for(unsigned int k = 0; k < sources.size(); k++){
+        if(!sources[k]->scalar(&values[k])){
+            values[k] = NAN;
+            all = false;
+        }
+    }
+    return all;
+}
@@ -0,0 +1,65 @@
+/**
+ * @file    analyzer.h
+ * @author  agent
+ * @date    October 17, 2026
+ * \brief   Header file for the analyzer class
+ *
+ * @class   analyzer analyzer.h
+ * @brief   Base class for the analyses made during a simulation.
+ *
+ * Analyses such as the radial distribution function used to be made on saved
+ * configurations, which needs large trajectory files. An analyzer instead
+ * accumulates its results inside the simulation program. The program calls:
+ * * measure(state) every few sweeps, this calls the sample() method of the
+ *   derived class and keeps track of the number of samples and of the
+ *   processor time used so the cost of the analysis can be reported;
+ * * save() at checkpoints and at the end, this (re)writes the output file
+ *   with the write() method of the derived class so the results so far are
+ *   always available;
+ * * log(the_log) at each report, derived classes that have a few global
+ *   values to follow during the run write them to the log as "name = value"
+ *   lines (the default writes nothing);
+ * * scalar(value) after each sample, derived classes can give one value that
+ *   summarizes the sample, whose statistical efficiency is then followed
+ *   (see sampling).
+ *
+ * Derived classes implement sample() and write(). Those whose output grows
+ * with every sample, and is written as it goes, replace save().
+ *
+ * Analyzers that follow the summary values of the others (sampling,
+ * convergence, frames) choose them with scalar_sources() at their first
+ * sample and collect them with scalar_values(), so each value stays with the
+ * analyzer it comes from even when one of them has none for a sample.
+ */
+
+#ifndef ANALYZER_H
+#define ANALYZER_H
+
+#include <stdio.h>
+#include <vector>
+#include "config.h"
+
+using namespace std;
+
+class analyzer {
+public:
+    analyzer(const char *name, const char *fname);  ///< Constructor with a name and output file
+    virtual ~analyzer();                    ///< Destructor
+    void    measure(config *state);         ///< Take a sample of the configuration.
+    virtual int     save();                 ///< Write the results to the output file.
+    virtual void    sample(config *state) = 0;  ///< Accumulate the results for one configuration.
+    virtual int     write(FILE *dest) = 0;  ///< Write the results.
+    virtual int     log(FILE *the_log);     ///< Write a summary of the last sample to the log.
+    virtual bool    scalar(double *value);  ///< One value summarizing the last sample, if any.
+    const char  *name;                      ///< Name of the analysis for the log.
+    const char  *fname;                     ///< Name of the output file.
+    int     n_samples;                      ///< Number of samples taken.
+    double  seconds;                        ///< Processor time used by the samples.
+protected:
+    void    scalar_sources(vector<analyzer *> *others,
+                           vector<analyzer *> &sources);    ///< The other analyzers that have a summary value.
+    bool    scalar_values(vector<analyzer *> &sources,
+                          vector<double> &values);  ///< Their summary values, false if one is missing.
+};
+
+#endif /* ANALYZER_H */
@@ -0,0 +1,200 @@
+/**
+ * @file    blocking.cpp
+ * @author  agent
+ * @date    October 17, 2026
+ *
+ * Implementation of the online blocking and autocorrelation time estimates.
+ */
+
+#include <math.h>
+#include "blocking.h"
+#include "common.h"
+
+#define BLOCK_MIN       32          // Fewest blocks for a usable level
+#define BLOCK_LAGS      1024        // Longest lag of the autocorrelation
+#define BLOCK_WINDOW    5.0         // Sokal window factor
+
+/**
+ * Constructor for an empty series.
+ *
+ * @param correlations  Keep the autocorrelation sums for tau.
+ */
+blocking::blocking(bool correlations) {
+    if(!correlations) return;
+    products.assign(BLOCK_LAGS, 0.0);
+    sum_first.assign(BLOCK_LAGS, 0.0);
+    sum_last.assign(BLOCK_LAGS, 0.0);
+}
+
+/**
+ * Destructor to destroy the estimator.
+ */
+blocking::~blocking() {
+}
+
+/**
+ * Add the next value of the series to the blocking levels and to the
+ * autocorrelation sums.
+ *
+ * @param value The value.
+ */
+void    blocking::add(double value){
+    long    n = n_values();
+    int     n_lags = min((long)products.size(), n + 1);
+
+    if(n_lags > 0){                         // Autocorrelation, lag 0 first
+        history.insert(history.begin(), value);
+        if((int)history.size() > BLOCK_LAGS) history.pop_back();
+    }
+    for(int k = 0; k < n_lags; k++){
+        products[k]  += value*history[k];
+        sum_first[k] += history[k];
+        sum_last[k]  += value;
+    }
+
+    for(unsigned int l = 0; ; l++){         // Blocking levels
+        if(l == count.size()){
+            count.push_back(0);
+            sum.push_back(0.0);
+            sum2.push_back(0.0);
+            waiting.push_back(0.0);
+            has_waiting.push_back(0);
+        }
+        count[l]++;
+        sum[l]  += value;
+        sum2[l] += value*value;
+        if(!has_waiting[l]){
+            waiting[l] = value;
+            has_waiting[l] = 1;
+            break;
+        }
+        value = 0.5*(waiting[l] + value);
+        has_waiting[l] = 0;
+    }
+}
+
+/**
+ * @return The number of values added.
+ */
+long    blocking::n_values(){
+    return count.empty() ? 0 : count[0];
+}
+
+/**
+ * @return The mean of the values.
+ */
+double  blocking::mean(){
+    return (n_values() > 0) ? sum[0]/count[0] : 0.0;
+}
+
+/**
+ * @return The number of blocking levels.
+ */
+int     blocking::n_levels(){
+    return count.size();
+}
+
+/**
+ * @param l The level.
+ * @return  The number of blocks of 2^l values.
+ */
+long    blocking::level_count(int l){
+    return count[l];
+}
+
+/**
+ * The naive error of the mean calculated from the blocks of one level as if
+ * they were independent.
+ *
+ * @param l The level.
+ * @return  The error, 0 with fewer than 2 blocks.
+ */
+double  blocking::level_error(int l){
+    double  m, var;
+
+    if(count[l] < 2) return 0.0;
+    m   = sum[l]/count[l];
+    var = max(0.0, sum2[l]/count[l] - m*m);
+    return sqrt(var/(count[l] - 1));
+}
+
+/**
+ * @brief The blocking level whose error is used.
+ *
+ * The first level with at least BLOCK_MIN blocks whose error is within its
+ * uncertainty, error/sqrt(2(n-1)), of the next level's. If no level agrees,
+ * the level with the largest error.
+ *
+ * @param agreed    Set to true if a level agrees with the next.
+ * @return          The level, or -1 if there are no values.
+ */
+int     blocking::plateau(bool *agreed){
+    int     best = -1;
+    double  e;
+
+    *agreed = false;
+    for(int l = 0; l < n_levels() && count[l] >= BLOCK_MIN; l++){
+        e = level_error(l);
+        if(best < 0 || e > level_error(best)) best = l;
+        if(l+1 < n_levels() && count[l+1] >= BLOCK_MIN
+                && fabs(level_error(l+1) - e) <= e/sqrt(2.0*(count[l] - 1))){
+            *agreed = true;
+            return l;
+        }
+    }
+    return (best >= 0 || n_levels() == 0) ? best : 0;
+}
+
+/**
+ * @return True if the blocking error has reached a plateau.
+ */
+bool    blocking::converged(){
+    bool    agreed;
+
+    plateau(&agreed);
+    return agreed;
+}
+
+/**
+ * @return The error of the mean from the blocking plateau.
+ */
+double  blocking::error(){
+    bool    agreed;
+    int     l = plateau(&agreed);
+
+    return (l >= 0) ? level_error(l) : 0.0;
+}
+
+/**
+ * The integrated autocorrelation time, 1/2 + sum_k rho(k), summed up to the
+ * Sokal window. For uncorrelated values it is 1/2.
+ *
+ * @return The time in samples.
+ */
+double  blocking::tau(){
+    long    n = n_values();
+    double  c0 = 0.0, c, m1, m2, t = 0.5, e0;
+    int     n_lags = min((long)products.size(), n);
+
+    if(n < 2) return 0.5;
+    if(n_lags > 0){
+        c0 = products[0]/n - (sum[0]/n)*(sum[0]/n);
+        if(c0 <= 0.0) return 0.5;
+    }
+    for(int k = 1; k < n_lags; k++){
+        m1 = sum_first[k]/(n - k);
+        m2 = sum_last[k]/(n - k);
+        c  = products[k]/(n - k) - m1*m2;
+        t += c/c0;
+        if(k >= BLOCK_WINDOW*t) return max(t, 0.5);
+    }
+    e0 = level_error(0);                    // No window, use the blocking
+    return (e0 > 0.0) ? max(0.5, 0.5*(error()/e0)*(error()/e0)) : 0.5;
+}
+
+/**
+ * @return The effective number of independent samples, n / (2 tau).
+ */
+double  blocking::ess(){
+    return n_values()/(2.0*tau());
+}
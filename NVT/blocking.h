@@ -0,0 +1,67 @@
+/**
+ * @file    blocking.h
+ * @author  agent
+ * @date    October 17, 2026
+ * \brief   Header file for the blocking class
+ *
+ * @class   blocking blocking.h
+ * @brief   Online error and autocorrelation time of a correlated series.
+ *
+ * Successive samples of a Monte Carlo run are correlated, so the naive error
+ * of their mean is too small and the number of samples says little about the
+ * information gathered. This class follows a series value by value, keeping
+ * a fixed amount of memory, and estimates:
+ * * the error of the mean by the blocking method of Flyvbjerg and Petersen
+ *   (1989): the series is repeatedly halved by averaging pairs of values, the
+ *   naive error of each level grows until the blocks are longer than the
+ *   correlation time and then stays on a plateau. Each level keeps only its
+ *   count, sum, sum of squares and a value waiting for its pair. The
+ *   plateau is the first level, with at least BLOCK_MIN blocks, whose error
+ *   agrees with the next within its own uncertainty, if there is none the
+ *   largest error is used and converged() is false;
+ * * the integrated autocorrelation time tau, in samples, from the sums of
+ *   products of values up to BLOCK_LAGS apart, with the automatic window of
+ *   Sokal (the window W is the first with W >= BLOCK_WINDOW tau(W)). If no
+ *   window fits the estimate from the blocking plateau, tau = (error /
+ *   naive error)^2 / 2, is used instead;
+ * * the effective sample size n / (2 tau).
+ *
+ * Without the autocorrelation sums (correlations false) adding a value costs
+ * O(log n) rather than O(BLOCK_LAGS) and tau always comes from the blocking
+ * plateau, this is used to re-estimate the errors of parts of a stored series
+ * (see convergence).
+ */
+
+#ifndef BLOCKING_H
+#define BLOCKING_H
+
+#include <vector>
+
+using namespace std;
+
+class blocking {
+public:
+    blocking(bool correlations = true);     ///< Constructor for an empty series.
+    virtual ~blocking();                    ///< Destructor
+    void    add(double value);              ///< Add the next value of the series.
+    long    n_values();                     ///< Number of values added.
+    double  mean();                         ///< Mean of the values.
+    double  error();                        ///< Error of the mean from the blocking plateau.
+    bool    converged();                    ///< Has the blocking reached a plateau?
+    double  tau();                          ///< Integrated autocorrelation time, in samples.
+    double  ess();                          ///< Effective sample size.
+    int     n_levels();                     ///< Number of blocking levels.
+    long    level_count(int l);             ///< Number of blocks at level l.
+    double  level_error(int l);             ///< Naive error of the mean from level l.
+private:
+    int     plateau(bool *agreed);          ///< The level used for the error.
+    vector<long>    count;                  ///< Blocks at each level.
+    vector<double>  sum, sum2;              ///< Sums of the blocks and their squares.
+    vector<double>  waiting;                ///< Block waiting for its pair.
+    vector<char>    has_waiting;            ///< Is there a block waiting?
+    vector<double>  history;                ///< The last BLOCK_LAGS values.
+    vector<double>  products;               ///< Sums of the products of values k apart.
+    vector<double>  sum_first, sum_last;    ///< Sums of the first and last values of the pairs k apart.
+};
+
+#endif /* BLOCKING_H */
@@ -0,0 +1,286 @@
+/**
+ * \file    cell_list.cpp
+ * \author  agent
+ * \date    October 17, 2026
+ * \version 1.0
+ * \brief   Implementation of the cell_list class.
+ */
+
+#include <math.h>
+#include "cell_list.h"
+#include "common.h"
+
+/**
+ * Create an empty grid covering a box. The number of cells in each direction
+ * is chosen so that the cells are at least min_size wide, there is always at
+ * least one cell.
+ *
+ * @param x_sz      Width of the box.
+ * @param y_sz      Height of the box.
+ * @param min_size  Minimum size of a cell, usually the interaction range.
+ * @param is_periodic   Are periodic boundary conditions used?
+ */
+cell_list::cell_list(double x_sz, double y_sz, double min_size, bool is_periodic) {
+    assert(min_size > 0.0);
+
+    x_size   = x_sz;
+    y_size   = y_sz;
+    periodic = is_periodic;
+    n_x      = (int)floor(x_size/min_size);
+    n_y      = (int)floor(y_size/min_size);
+    if(n_x < 1) n_x = 1;
+    if(n_y < 1) n_y = 1;
+    cell_x   = x_size/n_x;
+    cell_y   = y_size/n_y;
+    head.assign(n_x*n_y, -1);
+}
+
+/**
+ * Destructor for the cell list.
+ */
+cell_list::~cell_list() {
+}
+
+/**
+ * Remove all the entries, the geometry of the grid is kept.
+ */
+void    cell_list::clear(){
+    head.assign(n_x*n_y, -1);
+    after.clear();
+    before.clear();
+    home.clear();
+}
+
+/**
+ * @param x The x coordinate (wrapped or clamped into the box).
+ * @return  The column of the cell containing x.
+ */
+int     cell_list::column(double x){
+    int     c = (int)floor(x/cell_x);
+
+    if(periodic){
+        c %= n_x;
+        if(c < 0) c += n_x;
+    } else {
+        if(c < 0)    c = 0;
+        if(c >= n_x) c = n_x - 1;
+    }
+    return c;
+}
+
+/**
+ * @param y The y coordinate (wrapped or clamped into the box).
+ * @return  The row of the cell containing y.
+ */
+int     cell_list::row(double y){
+    int     r = (int)floor(y/cell_y);
+
+    if(periodic){
+        r %= n_y;
+        if(r < 0) r += n_y;
+    } else {
+        if(r < 0)    r = 0;
+        if(r >= n_y) r = n_y - 1;
+    }
+    return r;
+}
+
+/**
+ * @param x The x position.
+ * @param y The y position.
+ * @return  The index of the cell containing the position.
+ */
+int     cell_list::cell_of(double x, double y){
+    return row(y)*n_x + column(x);
+}
+
+/**
+ * @return The number of cells in the grid.
+ */
+int     cell_list::n_cells(){
+    return n_x*n_y;
+}
+
+/**
+ * @param cell  The cell index.
+ * @return      The first entry in the cell or -1 if the cell is empty.
+ */
+int     cell_list::first(int cell){
+    return head[cell];
+}
+
+/**
+ * @param index An entry in the grid.
+ * @return      The next entry in the same cell or -1 at the end of the cell.
+ */
+int     cell_list::next(int index){
+    return after[index];
+}
+
+/**
+ * Add a new entry to the grid. Space for the index is made if necessary.
+ *
+ * @param index The index of the entry (must not already be present).
+ * @param x     The x position of the entry.
+ * @param y     The y position of the entry.
+ */
+void    cell_list::insert(int index, double x, double y){
+    int     c;
+
+    assert(index >= 0);
+    if(index >= (int)home.size()){
+        after.resize(index+1, -1);
+        before.resize(index+1, -1);
+        home.resize(index+1, -1);
+    }
+    assert(home[index] < 0);
+
+    c = cell_of(x, y);
+    home[index]   = c;
+    before[index] = -1;
+    after[index]  = head[c];
+    if(head[c] >= 0) before[head[c]] = index;
+    head[c] = index;
+}
+
+/**
+ * Take an entry out of the grid.
+ *
+ * @param index The index of the entry to remove.
+ */
+void    cell_list::remove(int index){
+    int     c;
+
+    assert(index >= 0 && index < (int)home.size());
+    c = home[index];
+    assert(c >= 0);
+
+    if(before[index] >= 0) after[before[index]] = after[index];
+    else                   head[c]              = after[index];
+    if(after[index] >= 0)  before[after[index]] = before[index];
+    home[index] = before[index] = after[index] = -1;
+}
+
+/**
+ * Move an entry to a new position, the lists are only modified if the entry
+ * changes cell.
+ *
+ * @param index The index of the entry.
+ * @param x     The new x position.
+ * @param y     The new y position.
+ */
+void    cell_list::update(int index, double x, double y){
+    assert(index >= 0 && index < (int)home.size());
+    if(cell_of(x, y) != home[index]){
+        remove(index);
+        insert(index, x, y);
+    }
+}
+
+/**
+ * Follow an isometric expansion of the box and the positions by the factor
+ * dl. The entries stay in the same cells so only the geometry changes. When
+ * shrinking the caller should check the cells are still larger than the
+ * interaction range and build a new grid otherwise.
+ *
+ * @param dl    The multiplicative factor.
+ */
+void    cell_list::rescale(double dl){
+    x_size *= dl;
+    y_size *= dl;
+    cell_x *= dl;
+    cell_y *= dl;
+}
+
+/**
+ * Find the entries in all cells that could be within range of a point. Each
+ * entry is reported once, even when the range covers the box several times
+ * with periodic conditions, so sums over the result do not double count.
+ *
+ * @param x     The x position of the point.
+ * @param y     The y position of the point.
+ * @param range The search distance.
+ * @param found Vector that is emptied and filled with the entries.
+ * @return      The number of entries found.
+ */
+int     cell_list::neighbours(double x, double y, double range, vector<int> &found){
+    int     kx, ky;
+    int     cx, cy;
+    int     x_lo, x_hi, y_lo, y_hi;
+    int     i, j, c, e;
+
+    found.clear();
+    kx = (int)ceil(range/cell_x);
+    ky = (int)ceil(range/cell_y);
+    cx = column(x);
+    cy = row(y);
+
+    if(2*kx+1 >= n_x){ x_lo = 0; x_hi = n_x-1; }
+    else {
+        x_lo = cx - kx; x_hi = cx + kx;
+        if(!periodic){ x_lo = max(x_lo, 0); x_hi = min(x_hi, n_x-1); }
+    }
+    if(2*ky+1 >= n_y){ y_lo = 0; y_hi = n_y-1; }
+    else {
+        y_lo = cy - ky; y_hi = cy + ky;
+        if(!periodic){ y_lo = max(y_lo, 0); y_hi = min(y_hi, n_y-1); }
+    }
+
+    for(j = y_lo; j <= y_hi; j++){
+        for(i = x_lo; i <= x_hi; i++){
+            c = ((j + n_y) % n_y)*n_x + (i + n_x) % n_x;
+            for(e = head[c]; e >= 0; e = after[e]) found.push_back(e);
+        }
+    }
+    return found.size();
+}
+
+/**
+ * Find the entries in the cells that cover a window. The window is given in
+ * box coordinates and may extend beyond the box. With periodic conditions
+ * the window is tiled with images of the box and every image of an entry
+ * whose cell touches the window is reported, with the shift that moves the
+ * stored position to the image. Without periodic conditions only the box
+ * itself is searched. The caller should enlarge the window by the extent of
+ * the objects if they must be found when only partly inside.
+ *
+ * @param x0    Left edge of the window.
+ * @param y0    Bottom edge of the window.
+ * @param x1    Right edge of the window.
+ * @param y1    Top edge of the window.
+ * @param found Vector that is emptied and filled with the entries.
+ * @return      The number of entries (images) found.
+ */
+int     cell_list::window(double x0, double y0, double x1, double y1,
+                          vector<cell_image> &found){
+    int         c_lo, c_hi, r_lo, r_hi;
+    int         i, j, wi, wj, c, e;
+    cell_image  image;
+
+    found.clear();
+    c_lo = (int)floor(x0/cell_x);
+    c_hi = (int)floor(x1/cell_x);
+    r_lo = (int)floor(y0/cell_y);
+    r_hi = (int)floor(y1/cell_y);
+    if(!periodic){
+        c_lo = max(c_lo, 0); c_hi = min(c_hi, n_x-1);
+        r_lo = max(r_lo, 0); r_hi = min(r_hi, n_y-1);
+    }
+
+    for(j = r_lo; j <= r_hi; j++){
+        wj = j % n_y;                       // Wrap into the box and
+        if(wj < 0) wj += n_y;               // keep the image shift.
+        image.dy = ((j - wj)/n_y)*y_size;
+        for(i = c_lo; i <= c_hi; i++){
+            wi = i % n_x;
+            if(wi < 0) wi += n_x;
+            image.dx = ((i - wi)/n_x)*x_size;
+            c = wj*n_x + wi;
+            for(e = head[c]; e >= 0; e = after[e]){
+                image.index = e;
+                found.push_back(image);
+            }
+        }
+    }
+    return found.size();
+}
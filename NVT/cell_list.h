@@ -0,0 +1,80 @@
+/**
+ * \file    cell_list.h
+ * \author  agent
+ * \date    October 17, 2026
+ * \version 1.0
+ * \brief   Header file for the cell_list class.
+ *
+ * \class   cell_list cell_list.h
+ * \brief   A uniform grid of cells used as a spatial index for objects.
+ *
+ * The cell list divides the bounding box of a configuration into n_x by n_y
+ * rectangular cells that are at least as large as a requested minimum size.
+ * Each entry, identified by an integer index (usually the index of the object
+ * in the configuration), is stored in the cell containing its position. The
+ * cells are held as doubly linked lists so entries can be inserted, moved and
+ * removed in constant time.
+ *
+ * Queries return the indices stored in the cells that cover a region. They
+ * return candidates only, the caller is responsible for the exact distance or
+ * overlap test. Two queries are available:
+ * * neighbours(x, y, range, found) the entries in cells within range of a
+ *              point, each entry is reported once and the caller should use
+ *              the minimum image convention for distances.
+ * * window(x0, y0, x1, y1, found) the entries in cells covering a window that
+ *              may extend outside the box. With periodic conditions each
+ *              periodic image that falls in the window is reported with the
+ *              shift to apply to the stored position.
+ *
+ * An isometric expansion of the configuration (config::expand) does not change
+ * which cell an entry belongs to, so rescale(dl) just rescales the cells and
+ * the grid can be reused without being rebuilt.
+ */
+
+#ifndef CELL_LIST_H
+#define CELL_LIST_H
+
+#include <vector>
+
+using namespace std;
+
+/**
+ * \brief An entry found by a window query and the shift to its periodic image.
+ */
+struct cell_image {
+    int     index;                          ///< Index of the entry.
+    double  dx, dy;                         ///< Shift to add to the stored position.
+};
+
+class cell_list {
+public:
+    cell_list(double x_size, double y_size,
+              double min_size, bool periodic);  ///< Grid covering the box with cells at least min_size wide.
+    virtual ~cell_list();                   ///< Destructor
+    void    clear();                        ///< Remove all the entries.
+    void    insert(int index, double x, double y);  ///< Add an entry at a position.
+    void    remove(int index);              ///< Remove an entry.
+    void    update(int index, double x, double y);  ///< Move an entry to a new position.
+    void    rescale(double dl);             ///< Follow an isometric expansion by dl.
+    int     neighbours(double x, double y, double range,
+                       vector<int> &found); ///< Entries in cells within range of a point.
+    int     window(double x0, double y0, double x1, double y1,
+                   vector<cell_image> &found);  ///< Entries (and images) in cells covering a window.
+    int     cell_of(double x, double y);    ///< The cell containing a position.
+    int     first(int cell);                ///< First entry in a cell (-1 if empty).
+    int     next(int index);                ///< Following entry in the same cell (-1 at end).
+    int     n_cells();                      ///< Total number of cells.
+    int     n_x, n_y;                       ///< Number of cells in each direction.
+    double  cell_x, cell_y;                 ///< Size of the cells.
+    double  x_size, y_size;                 ///< Size of the box covered.
+    bool    periodic;                       ///< Use periodic boundary conditions.
+private:
+    int     column(double x);               ///< Cell column of an x coordinate.
+    int     row(double y);                  ///< Cell row of a y coordinate.
+    vector<int> head;                       ///< First entry of each cell.
+    vector<int> after;                      ///< Next entry in the same cell.
+    vector<int> before;                     ///< Previous entry in the same cell.
+    vector<int> home;                       ///< Cell of each entry (-1 if absent).
+};
+
+#endif /* CELL_LIST_H */
@@ -0,0 +1,250 @@
+/**
+ * @file    cluster.cpp
+ * @author  agent
+ * @date    October 17, 2026
+ *
+ * Implementation of the cluster analyzer that finds the clusters of objects
+ * in contact with a union-find structure.
+ */
+
+#include <math.h>
+#include <thread>
+#include "cluster.h"
+#include "common.h"
+
+/**
+ * Constructor for the cluster analyzer.
+ *
+ * @param a_fname       The output file.
+ * @param forces        The force field (hard core sizes and interactions).
+ * @param a_gap         Contact distance as a multiple of the hard core distance.
+ * @param energy        Use the energy criterion instead of the distance.
+ * @param a_threshold   Largest interaction energy of objects in contact.
+ * @param threads       The number of threads to use.
+ */
+cluster::cluster(const char *a_fname, force_field *forces, double a_gap,
+                 bool energy, double a_threshold, int threads)
+                : analyzer("cluster", a_fname) {
+    assert(a_gap > 0.0);
+    the_forces = forces;
+    gap        = a_gap;
+    use_energy = energy;
+    threshold  = a_threshold;
+    n_threads  = max(threads, 1);
+}
+
+/**
+ * Destructor to destroy the analyzer.
+ */
+cluster::~cluster() {
+}
+
+/**
+ * @brief Are two objects in contact?
+ *
+ * With the energy criterion the objects are in contact if their interaction
+ * energy is below the threshold, otherwise if two of their atoms are closer
+ * than gap times their hard core distance. The nearest image of obj2 is used.
+ *
+ * @param state The configuration.
+ * @param obj1  The first object.
+ * @param obj2  The second object.
+ * @return      True if the objects are in contact.
+ */
+bool    cluster::contact(config *state, object *obj1, object *obj2){
+    topology    *the_topology = state->get_topology();
+    atom    *at1, *at2;
+    double  dx, dy, x1, y1, x2, y2, hard;
+    double  c1, s1, c2, s2;
+
+    state->image_shift(obj1, obj2, &dx, &dy);
+    if(use_energy){
+        object  image(*obj2);               // Nearest image, as a copy so that
+        image.pos_x += dx;                  // threads never change the state
+        image.pos_y += dy;
+        return obj1->interaction(the_forces, the_topology, &image) < threshold;
+    }
+    c1 = cos(obj1->orientation); s1 = sin(obj1->orientation);
+    c2 = cos(obj2->orientation); s2 = sin(obj2->orientation);
+    for(int i = 0; i < the_topology->n_atom(obj1->o_type); i++){
+        at1 = the_topology->atoms(obj1->o_type, i);
+        x1 = obj1->pos_x + c1*at1->x_pos - s1*at1->y_pos;
+        y1 = obj1->pos_y + s1*at1->x_pos + c1*at1->y_pos;
+        for(int j = 0; j < the_topology->n_atom(obj2->o_type); j++){
+            at2  = the_topology->atoms(obj2->o_type, j);
+            hard = gap*(the_forces->size(at1->type) + the_forces->size(at2->type));
+            if(hard <= 0.0) continue;
+            x2 = obj2->pos_x + dx + c2*at2->x_pos - s2*at2->y_pos;
+            y2 = obj2->pos_y + dy + s2*at2->x_pos + c2*at2->y_pos;
+            if((x2-x1)*(x2-x1) + (y2-y1)*(y2-y1) < hard*hard) return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief The root of the set containing i, halving the path on the way.
+ *
+ * A failed compare and swap only means another thread has already shortened
+ * the path, so it is ignored.
+ *
+ * @param i The element.
+ * @return  The root.
+ */
+int     cluster::find(int i){
+    int     p, gp;
+
+    while((p = parent[i].load()) != i){
+        gp = parent[p].load();
+        if(gp != p) parent[i].compare_exchange_weak(p, gp);
+        i = gp;
+    }
+    return i;
+}
+
+/**
+ * @brief Join the sets containing i and j.
+ *
+ * The root with the larger index is linked below the other, so the links
+ * never form a cycle even when several threads join sets at once. If the root
+ * has been linked by another thread meanwhile the search is repeated.
+ *
+ * @param i The first element.
+ * @param j The second element.
+ */
+void    cluster::unite(int i, int j){
+    int     t;
+
+    while(true){
+        i = find(i);
+        j = find(j);
+        if(i == j) return;
+        if(i < j){ t = i; i = j; j = t; }
+        t = i;
+        if(parent[i].compare_exchange_strong(t, j)) return;
+    }
+}
+
+/**
+ * Join the objects in contact, for the objects in the cells first..last-1.
+ * Each pair is tested from the object with the smaller index. Only reads the
+ * configuration and the grid so several threads can label different cells at
+ * once.
+ *
+ * @param state The configuration.
+ * @param grid  The filled spatial index.
+ * @param range The largest distance between the centers of objects in contact.
+ * @param first The first cell.
+ * @param last  One past the last cell.
+ */
+void    cluster::label_cells(config *state, cell_list *grid, double range,
+                             int first, int last){
+    vector<int> found;
+    object  *obj1, *obj2;
+    double  dx, dy;
+
+    for(int c = first; c < last; c++){
+        for(int i = grid->first(c); i >= 0; i = grid->next(i)){
+            obj1 = state->get_object(i);
+            grid->neighbours(obj1->pos_x, obj1->pos_y, range, found);
+            for(unsigned int m = 0; m < found.size(); m++){
+                if(found[m] <= i) continue;
+                obj2 = state->get_object(found[m]);
+                state->image_shift(obj1, obj2, &dx, &dy);
+                dx += obj2->pos_x - obj1->pos_x;
+                dy += obj2->pos_y - obj1->pos_y;
+                if(dx*dx + dy*dy >= range*range) continue;
+                if(find(i) == find(found[m])) continue;     // Already joined
+                if(contact(state, obj1, obj2)) unite(i, found[m]);
+            }
+        }
+    }
+}
+
+/**
+ * Find the clusters of a configuration and add their statistics.
+ *
+ * @param state The configuration.
+ */
+void    cluster::sample(config *state){
+    int     n = state->n_objects();
+    double  range;
+    int     n_c, big, r;
+    double  sum2;
+    vector<int>     sizes(n, 0);
+    vector<thread>  workers;
+
+    if(n == 0) return;
+    if((int)parent.size() != n) vector< atomic<int> >(n).swap(parent);
+    for(int i = 0; i < n; i++) parent[i].store(i);
+
+    range = 2.0*state->reach(the_forces);
+    range = use_energy ? range + the_forces->cut_off : range*max(gap, 1.0);
+    cell_list   grid(state->x_size, state->y_size, range, state->periodic());
+    state->fill_grid(&grid);
+
+    int n_c_all = grid.n_cells();
+    int n_t = min(n_threads, n_c_all);
+    for(int t = 1; t < n_t; t++)            // Share the cells out
+        workers.push_back(thread(&cluster::label_cells, this, state, &grid,
+                range, (t*n_c_all)/n_t, ((t+1)*n_c_all)/n_t));
+    label_cells(state, &grid, range, 0, n_c_all/n_t);
+    for(unsigned int t = 0; t < workers.size(); t++) workers[t].join();
+
+    for(int i = 0; i < n; i++) sizes[find(i)]++;
+    n_c = big = 0;
+    sum2 = 0.0;
+    for(int i = 0; i < n; i++){
+        if((r = sizes[i]) == 0) continue;
+        n_c++;
+        big   = max(big, r);
+        sum2 += (double)r*r;
+        if((int)size_count.size() <= r) size_count.resize(r+1, 0);
+        size_count[r]++;
+    }
+    n_clusters.push_back(n_c);
+    largest.push_back(big);
+    mean.push_back((double)n/n_c);
+    weight_mean.push_back(sum2/n);
+}
+
+/**
+ * Write the statistics of each sample, their averages and the histogram of
+ * the cluster sizes (mean number of clusters of each size per sample).
+ *
+ * @param dest  The file, open for writing.
+ * @return      The return value of the last print statement.
+ */
+int     cluster::write(FILE *dest){
+    int     rc;
+    double  a_n = 0.0, a_big = 0.0, a_mean = 0.0, a_weight = 0.0;
+    int     n = n_clusters.size();
+
+    rc = fprintf(dest, "# sample clusters largest mean weight_mean\n");
+    for(int k = 0; k < n; k++){
+        rc = fprintf(dest, "%d %d %d %g %g\n", k, n_clusters[k], largest[k],
+                mean[k], weight_mean[k]);
+        a_n += n_clusters[k]; a_big += largest[k];
+        a_mean += mean[k];    a_weight += weight_mean[k];
+    }
+    if(n > 0)
+        rc = fprintf(dest, "# average %g %g %g %g\n",
+                a_n/n, a_big/n, a_mean/n, a_weight/n);
+    rc = fprintf(dest, "\n# size clusters_per_sample\n");
+    for(unsigned int r = 1; r < size_count.size(); r++)
+        if(size_count[r] > 0)
+            rc = fprintf(dest, "%d %g\n", r, (double)size_count[r]/max(n, 1));
+    return rc;
+}
+
+/**
+ * The size of the largest cluster of the last sample.
+ *
+ * @param value Set to the size.
+ * @return      True if there has been a sample.
+ */
+bool    cluster::scalar(double *value){
+    if(largest.empty()) return false;
+    *value = largest.back();
+    return true;
+}
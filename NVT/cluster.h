@@ -0,0 +1,71 @@
+/**
+ * @file    cluster.h
+ * @author  agent
+ * @date    October 17, 2026
+ * \brief   Header file for the cluster class
+ *
+ * @class   cluster cluster.h
+ * @brief   Cluster analysis of the objects during a simulation.
+ *
+ * Two objects are in contact either:
+ * * if two of their atoms are closer than 'gap' times the sum of their hard
+ *   core radii (distance criterion, the default), or
+ * * if their interaction energy (object::interaction) is below a threshold
+ *   (energy criterion).
+ * The clusters are the connected groups of objects in contact. They are
+ * found with a union-find (disjoint set) structure over the pairs given by a
+ * cell_list, so a sample takes a time proportional to the number of objects.
+ * The objects are visited cell by cell, so consecutive searches touch the same
+ * neighbouring objects, and each pair is only tested from the object with the
+ * smaller index.
+ *
+ * The union-find is lock free so the clusters can be labeled in parallel: the
+ * parents are atomic, a root is always linked below the root with the smaller
+ * index by a compare and swap, and the paths are halved during the searches.
+ * With several threads the cells are shared between the threads, the result
+ * is the same as with one.
+ *
+ * For each sample the number of clusters, the size of the largest cluster,
+ * the mean size and the weight average size (the mean size of the cluster
+ * of an object) are recorded, and the cluster sizes added to a histogram.
+ * The output contains the statistics of each sample followed by the size
+ * histogram averaged over the samples.
+ */
+
+#ifndef CLUSTER_H
+#define CLUSTER_H
+
+#include <vector>
+#include <atomic>
+#include "analyzer.h"
+
+using namespace std;
+
+class cluster : public analyzer {
+public:
+    cluster(const char *fname, force_field *the_forces, double gap,
+            bool use_energy, double threshold, int n_threads);  ///< Constructor with the output file, contact criterion and threads.
+    virtual ~cluster();                     ///< Destructor
+    virtual void    sample(config *state);  ///< Find the clusters of one configuration.
+    virtual int     write(FILE *dest);      ///< Write the statistics and the size histogram.
+    virtual bool    scalar(double *value);  ///< The size of the largest cluster.
+    double  gap;                            ///< Contact distance as a multiple of the hard core distance.
+    bool    use_energy;                     ///< Use the energy criterion.
+    double  threshold;                      ///< Largest interaction energy of a contact.
+    int     n_threads;                      ///< Number of threads used for a sample.
+private:
+    bool    contact(config *state, object *obj1, object *obj2);   ///< Are two objects in contact?
+    void    label_cells(config *state, cell_list *grid, double range,
+                        int first, int last);   ///< Join the contacts of the objects in cells first..last-1.
+    int     find(int i);                    ///< The root of the set of i.
+    void    unite(int i, int j);            ///< Join the sets of i and j.
+    force_field *the_forces;
+    vector< atomic<int> >   parent;         ///< Union-find parents.
+    vector<int>     size_count;             ///< Histogram of the cluster sizes.
+    vector<int>     n_clusters;             ///< Number of clusters of each sample.
+    vector<int>     largest;                ///< Largest cluster of each sample.
+    vector<double>  mean;                   ///< Mean cluster size of each sample.
+    vector<double>  weight_mean;            ///< Weight average cluster size of each sample.
+};
+
+#endif /* CLUSTER_H */
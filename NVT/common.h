@@ -10,8 +10,8 @@
 
 #include <assert.h>
 
-#define min(a,b)        (a<b)?(a):(b)
-#define max(a,b)        (a>b)?(a):(b)
+#define min(a,b)        (((a)<(b))?(a):(b))
+#define max(a,b)        (((a)>(b))?(a):(b))
 
 #define M_2PI           (M_PI+M_PI)
 #define rnd_lin(range)  ((range*(double)rand())/(double)RAND_MAX)
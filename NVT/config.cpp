@@ -7,6 +7,7 @@
 
 #include <float.h>
 #include <math.h>
+#include <algorithm>
 #include "config.h"
 #include "common.h"
 
@@ -89,13 +90,13 @@ config::config(config& orig) {
     y_size         = orig.y_size;
     saved_energy   = orig.saved_energy;
     unchanged      = orig.unchanged;
-    the_topology   = new topology( /*orig.the_topology*/ ); // Cheat as topology hard coded
+    the_topology   = orig.the_topology ? new topology(orig.the_topology)
+                                       : (topology *)NULL;
     is_periodic    = orig.is_periodic;
     obj_list.empty();
     for(int i = 0; i < orig.n_objects(); i++){
         my_obj1 = orig.obj_list.get(i);
-        my_obj2 = new object( my_obj1->o_type, my_obj1->pos_x,
-                my_obj1->pos_y, my_obj1->orientation);
+        my_obj2 = new object(*my_obj1);
         obj_list.add(my_obj2);
     }
 }
@@ -213,6 +214,13 @@ int config::n_objects(){
     return obj_list.size();                 // Get size of object list.
 }
 
+/**
+ * @return True if periodic boundary conditions are used.
+ */
+bool config::periodic(){
+    return is_periodic;
+}
+
 /**
  * Count the number of different types of object are found in the current
  * configuration. Actually it just returns the highest object type number found.
@@ -259,17 +267,132 @@ bool config::check(){
 }
 
 /**
- * This function compares atom by atom the current configuration and the
- * reference configuration and calculates the root mean square distance between
- * the atoms.
+ * This function compares the current configuration with a reference
+ * configuration of the same objects and calculates the root mean square
+ * distance between them. There are two modes:
+ *
+ * * identity (match = false), object i is compared with object i of the
+ *   reference and the result is the rms distance between corresponding atoms.
+ *   The displacements of the centers use the minimum image. As the atoms of
+ *   an object only differ by their offsets, the sum over the atoms is
+ *   calculated from the displacement and rotation of the object and the first
+ *   and second moments of the atom offsets of its type, so the cost does not
+ *   depend on the number of atoms. The displacements are first gathered into
+ *   arrays so the final sum is a simple loop the compiler can vectorize.
+ * * permutation invariant (match = true), each object is paired with an
+ *   object of the same type in the reference and the result is the rms
+ *   distance between paired centers. The pairs are chosen greedily, closest
+ *   first, among the pairs found with a cell_list within a search distance
+ *   that starts at the mean spacing and is doubled until every object is
+ *   paired. This is an upper bound of the optimal assignment distance that is
+ *   equal to it when the objects have moved less than half their spacing.
  *
- * @param ref   a reference configuration
- * @return      as a double the rms distance
+ * The minimum image uses the box of the current configuration.
  *
- * @todo        Currently just a stub, returns 1.0
+ * @param ref   a reference configuration, with the same topology.
+ * @param match pair the objects by type and position rather than by index.
+ * @return      as a double the rms distance, or -1 if the configurations do
+ *              not have the same objects (number, or types in identity mode,
+ *              or number of each type in permutation invariant mode).
  */
-double config::rms(const config& ref){
-    return 1.0;
+double config::rms(const config& ref, bool match){
+    int     n = obj_list.size();
+    object  *obj1, *obj2;
+    double  dx, dy, sx, sy, sum = 0.0, n_sum = 0.0;
+
+    if(n != ref.obj_list.size()) return -1.0;
+    if(n == 0) return 0.0;
+
+    if(!match){
+        int     n_types = the_topology->n_types();
+        vector<double>  n_at(n_types, 0.0), m_x(n_types, 0.0);
+        vector<double>  m_y(n_types, 0.0), m_2(n_types, 0.0);
+        vector<double>  ex(n), ey(n), dc(n), ds(n);
+        vector<int>     type(n);
+        atom    *at;
+
+        for(int t = 0; t < n_types; t++){   // Moments of the atom offsets
+            for(int j = 0; j < the_topology->n_atom(t); j++){
+                at = the_topology->atoms(t, j);
+                n_at[t] += 1.0;
+                m_x[t]  += at->x_pos;
+                m_y[t]  += at->y_pos;
+                m_2[t]  += at->x_pos*at->x_pos + at->y_pos*at->y_pos;
+            }
+        }
+        for(int i = 0; i < n; i++){         // Gather the displacements
+            obj1 = obj_list.get(i);
+            obj2 = ref.obj_list.get(i);
+            if(obj1->o_type != obj2->o_type) return -1.0;
+            image_shift(obj1, obj2, &sx, &sy);
+            type[i] = obj1->o_type;
+            ex[i] = obj1->pos_x - obj2->pos_x - sx;
+            ey[i] = obj1->pos_y - obj2->pos_y - sy;
+            dc[i] = cos(obj1->orientation) - cos(obj2->orientation);
+            ds[i] = sin(obj1->orientation) - sin(obj2->orientation);
+        }
+        for(int i = 0; i < n; i++){         // Sum over the atoms
+            int t = type[i];
+            sum += n_at[t]*(ex[i]*ex[i] + ey[i]*ey[i])
+                 + 2.0*ex[i]*(dc[i]*m_x[t] - ds[i]*m_y[t])
+                 + 2.0*ey[i]*(ds[i]*m_x[t] + dc[i]*m_y[t])
+                 + (dc[i]*dc[i] + ds[i]*ds[i])*m_2[t];
+            n_sum += n_at[t];
+        }
+        return (n_sum > 0.0) ? sqrt(max(sum, 0.0)/n_sum) : 0.0;
+    }
+
+    double  r, r_max;
+    vector<int>     found, left, next;
+    vector<char>    used(n, 0), paired(n, 0);
+    vector< pair<double, pair<int, int> > > cand;
+
+    r_max = is_periodic ? 0.5*sqrt(x_size*x_size + y_size*y_size)
+                        : sqrt(x_size*x_size + y_size*y_size);
+    for(int t = 0; t < the_topology->n_types(); t++){
+        cell_list   grid(x_size, y_size, sqrt(area()/n), is_periodic);
+        left.clear();
+        int n_ref = 0;
+        for(int i = 0; i < n; i++){
+            if(obj_list.get(i)->o_type == t) left.push_back(i);
+            obj2 = ref.obj_list.get(i);
+            if(obj2->o_type != t) continue;
+            n_ref++;
+            grid.insert(i, fmod(obj2->pos_x + x_size, x_size),
+                        fmod(obj2->pos_y + y_size, y_size));
+        }
+        if(n_ref != (int)left.size()) return -1.0;
+
+        for(r = sqrt(area()/n); !left.empty(); r = min(2.0*r, r_max)){
+            cand.clear();                   // Candidate pairs within r
+            for(unsigned int k = 0; k < left.size(); k++){
+                obj1 = obj_list.get(left[k]);
+                grid.neighbours(obj1->pos_x, obj1->pos_y, r, found);
+                for(unsigned int m = 0; m < found.size(); m++){
+                    obj2 = ref.obj_list.get(found[m]);
+                    image_shift(obj1, obj2, &sx, &sy);
+                    dx = obj2->pos_x + sx - obj1->pos_x;
+                    dy = obj2->pos_y + sy - obj1->pos_y;
+                    if(dx*dx + dy*dy < r*r || r >= r_max)
+                        cand.push_back(make_pair(dx*dx + dy*dy,
+                                make_pair(left[k], found[m])));
+                }
+            }
+            sort(cand.begin(), cand.end());
+            for(unsigned int k = 0; k < cand.size(); k++){  // Closest first
+                int a = cand[k].second.first, b = cand[k].second.second;
+                if(paired[a] || used[b]) continue;
+                paired[a] = used[b] = 1;
+                sum += cand[k].first;
+                grid.remove(b);
+            }
+            next.clear();
+            for(unsigned int k = 0; k < left.size(); k++)
+                if(!paired[left[k]]) next.push_back(left[k]);
+            left.swap(next);
+        }
+    }
+    return sqrt(sum/n);
 }
 
 /**
@@ -336,16 +459,191 @@ void    config::invalidate_within(double distance, int index){
     }
 }
 
+/**
+ * Empty a spatial index and enter all the objects of the configuration using
+ * their index in the object list. The grid should have been created for
+ * the current box size.
+ *
+ * @param grid the cell list to fill.
+ */
+void    config::fill_grid(cell_list *grid){
+    object  *obj;
+
+    grid->clear();
+    for(int i = 0; i < obj_list.size(); i++){
+        obj = obj_list.get(i);
+        grid->insert(i, obj->pos_x, obj->pos_y);
+    }
+}
+
+/**
+ * The largest distance from an object center to the edge of one of its
+ * atoms, over all the object types of the topology. Two objects whose centers
+ * are further apart than twice this value cannot overlap.
+ *
+ * @param the_force the force field giving the atom sizes.
+ * @return the distance.
+ */
+double  config::reach(force_field *the_force){
+    double  value = 0.0;
+
+    for(int t = 0; t < the_topology->n_types(); t++)
+        value = max(value, reach(the_force, t));
+    return value;
+}
+
+/**
+ * The largest distance from the center of an object of the given type to
+ * the edge of one of its atoms.
+ *
+ * @param the_force the force field giving the atom sizes.
+ * @param type the object type.
+ * @return the distance.
+ */
+double  config::reach(force_field *the_force, int type){
+    double  value = 0.0;
+
+    for(int j = 0; j < the_topology->n_atom(type); j++)
+        value = max(value, the_force->size(the_topology->atoms(type, j)->type));
+    return the_topology->extent(type) + value;
+}
+
+/**
+ * Calculate the shift to apply to the second object to obtain the periodic
+ * image closest to the first object. Without periodic conditions the shift
+ * is zero.
+ *
+ * @param obj1 the reference object.
+ * @param obj2 the object to move.
+ * @param dx returns the shift in x.
+ * @param dy returns the shift in y.
+ */
+void    config::image_shift(object *obj1, object *obj2, double *dx, double *dy){
+    double  r;
+
+    *dx = *dy = 0.0;
+    if(is_periodic){
+        r = obj2->pos_x - obj1->pos_x;
+        if(r >  0.5*x_size) *dx = -x_size;
+        if(r < -0.5*x_size) *dx =  x_size;
+        r = obj2->pos_y - obj1->pos_y;
+        if(r >  0.5*y_size) *dy = -y_size;
+        if(r < -0.5*y_size) *dy =  y_size;
+    }
+}
+
+/**
+ * Test if an object has a hard core overlap with any of the objects of the
+ * configuration. The object does not need to be in the configuration, if it
+ * is its index is given so it is not compared with itself. Only the objects
+ * in the neighbouring cells of the grid whose bounding discs overlap that of
+ * obj are tested atom by atom.
+ *
+ * @param the_force the force field giving the atom sizes.
+ * @param obj the object to test.
+ * @param skip the index of obj in the configuration (or -1).
+ * @param grid a spatial index of the configuration with cells at least
+ *             twice reach() wide.
+ * @return true if there is an overlap.
+ */
+bool    config::overlap(force_field *the_force, object *obj, int skip,
+                        cell_list *grid){
+    object  *obj2;
+    double  dx, dy, rx, ry, r;
+    double  reach_type[MAX_TOPO];
+    double  range = 0.0;
+    vector<int> near;                       // Local, so calls can overlap
+
+    for(int t = 0; t < the_topology->n_types(); t++){
+        reach_type[t] = reach(the_force, t);
+        range = max(range, reach_type[t]);
+    }
+    range += reach_type[obj->o_type];
+
+    grid->neighbours(obj->pos_x, obj->pos_y, range, near);
+    for(unsigned int i = 0; i < near.size(); i++){
+        if(near[i] == skip) continue;
+        obj2 = obj_list.get(near[i]);
+        image_shift(obj, obj2, &dx, &dy);
+        rx = obj2->pos_x + dx - obj->pos_x; // Bounding discs must overlap
+        ry = obj2->pos_y + dy - obj->pos_y;
+        r  = reach_type[obj->o_type] + reach_type[obj2->o_type];
+        if(rx*rx + ry*ry >= r*r) continue;
+        if(obj->core_overlap(the_force, the_topology, obj2, dx, dy))
+            return true;
+    }
+    return false;
+}
+
+/**
+ * Find how much the configuration can be compressed by expand() before two
+ * hard cores come into contact. Compression moves the object centers together
+ * but does not change the orientations, so the contacts are found pair by pair
+ * with object::contact_scale(). Only the pairs that can come into contact for
+ * factors down to s_min are examined, using the spatial index.
+ *
+ * @param the_force the force field giving the atom sizes.
+ * @param grid a spatial index of the configuration with cells at least
+ *             twice reach() wide.
+ * @param s_min the smallest factor of interest (0 < s_min <= 1).
+ * @return the largest factor, not less than s_min, at which there is a contact
+ *         (s_min if there is none).
+ */
+double  config::contact_scale(force_field *the_force, cell_list *grid,
+                              double s_min){
+    object  *obj1, *obj2;
+    double  dx, dy, rx, ry, r;
+    double  reach_type[MAX_TOPO];
+    double  range = 2.0*reach(the_force)/s_min;
+    double  value = s_min;
+    vector<int> near;
+
+    assert(s_min > 0.0 && s_min <= 1.0);
+    for(int t = 0; t < the_topology->n_types(); t++)
+        reach_type[t] = reach(the_force, t);
+    for(int i = 0; i < obj_list.size(); i++){
+        obj1 = obj_list.get(i);
+        grid->neighbours(obj1->pos_x, obj1->pos_y, range, near);
+        for(unsigned int j = 0; j < near.size(); j++){
+            if(near[j] <= i) continue;      // Each pair once
+            obj2 = obj_list.get(near[j]);
+            image_shift(obj1, obj2, &dx, &dy);
+            rx = obj2->pos_x + dx - obj1->pos_x;
+            ry = obj2->pos_y + dy - obj1->pos_y;
+            r  = (reach_type[obj1->o_type] + reach_type[obj2->o_type])/s_min;
+            if(rx*rx + ry*ry >= r*r) continue;  // Never touch
+            value = max(value, obj1->contact_scale(the_force, the_topology,
+                    obj2, dx, dy));
+        }
+    }
+    return value;
+}
+
+/**
+ * Choose between periodic boundary conditions or a closed box.
+ *
+ * @param periodic true for periodic boundary conditions.
+ */
+void    config::set_periodic(bool periodic){
+    is_periodic = periodic;
+    unchanged   = false;
+}
+
 /** \brief Associate a topology with the configuration
  *
  * \param a_topology a pointer to the topology.
  *
+ * Replacing a topology changes the objects so all the energies are marked
+ * for recalculation.
  */
 
 void    config::add_topology(topology* a_topology){
     if( the_topology )                      // If there is already one
         delete( the_topology );             // Get rid of it
     the_topology = a_topology;              // Make the new association
+    unchanged    = false;
+    for(int i = 0; i < obj_list.size(); i++)
+        obj_list.get(i)->recalculate = true;
 }
 
 /** \brief Insert an object into the configuration.
@@ -358,6 +656,25 @@ void    config::add_object(object* orig ){
     obj_list.add(orig);
 }
 
+/** \brief Retrieve an object of the configuration.
+ *
+ * \param index the index of the object (0 to n_objects()-1).
+ * \return a pointer to the object, it still belongs to the configuration.
+ *
+ */
+object  *config::get_object(int index){
+    return obj_list.get(index);
+}
+
+/** \brief The topology associated with the configuration.
+ *
+ * \return a pointer to the topology, it still belongs to the configuration.
+ *
+ */
+topology *config::get_topology(){
+    return the_topology;
+}
+
 /** \brief Output a postscript snippet to draw the configuration
  *
  * \param the_forces forcefield, needed for atom sizes and colors.
@@ -412,3 +729,50 @@ void    config::ps_atoms(force_field* the_forces, FILE* dest){
         }
     }
 }
+
+/** \brief Output a postscript snippet drawing only the atoms in a window
+ *
+ * \param the_forces forcefield, needed for atom sizes and colors.
+ * \param dest the file for the output.
+ * \param x0 left edge of the window.
+ * \param y0 bottom edge of the window.
+ * \param x1 right edge of the window.
+ * \param y1 top edge of the window.
+ * \param grid a spatial index filled with fill_grid().
+ * \return no return value
+ *
+ * Only the objects in the cells that cover the window, enlarged by the size of
+ * the largest object, are visited, so the cost depends on the contents of the
+ * window and not on the size of the configuration. The window may extend
+ * beyond the box, with periodic conditions the periodic images are drawn. The
+ * coordinates written are box coordinates, the caller translates the origin.
+ */
+void    config::ps_window(force_field* the_forces, FILE* dest,
+                          double x0, double y0, double x1, double y1,
+                          cell_list *grid){
+    vector<cell_image>  found;
+    object  *my_obj;
+    atom    *at;
+    double  theta, r, x, y, ox, oy;
+    double  margin = reach(the_forces);     // Largest object size
+    int     t;
+                                            // Loop over the candidate images
+    grid->window(x0-margin, y0-margin, x1+margin, y1+margin, found);
+    for(unsigned int i = 0; i < found.size(); i++){
+        my_obj = obj_list.get(found[i].index);
+        theta  = my_obj->orientation;
+        ox     = my_obj->pos_x + found[i].dx;
+        oy     = my_obj->pos_y + found[i].dy;
+        for(int j = 0; j < the_topology->n_atom(my_obj->o_type); j++ ){
+            at = the_topology->atoms(my_obj->o_type, j);
+            t  = at->type;
+            r  = the_forces->size(t);
+            x  = ox + at->x_pos * cos(theta) - at->y_pos * sin(theta);
+            y  = oy + at->x_pos * sin(theta) + at->y_pos * cos(theta);
+                                            // Skip atoms outside the window
+            if((x+r < x0) || (x-r > x1) || (y+r < y0) || (y-r > y1)) continue;
+            fprintf(dest, "newpath %g %g %g %s moveto fcircle \n",
+                    r, x, y, the_forces->get_color(t) );
+        }
+    }
+}
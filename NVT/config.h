@@ -27,6 +27,11 @@
  *
  * There are methods for associating objects with the configuration.
  * * add_topology(tp) Associates the topology tp with the configuration.
+ * * add_object(obj) Inserts the object obj in the configuration.
+ * * get_topology() Returns the associated topology.
+ * * get_object(i) Returns the object with index i, for code that needs to
+ *              examine the objects (analysis, drawing). Objects modified
+ *              through this pointer must have their recalculate flag set.
  *
  * There are three output methods:
  * * write(fp) that writes the configuration to the file pointer fp, that should be
@@ -35,10 +40,21 @@
  * * ps_atoms(ff, fp) that produces a postscript snippet containing a representation
  *              of the different atoms.
  * * ps_box(fp) that produces a postscript path of the boundaries.
+ * * ps_window(ff, fp, x0, y0, x1, y1, grid) that produces the postscript snippet
+ *              for only the atoms that intersect a window, including periodic
+ *              images, using a spatial index filled by fill_grid().
  *
  * Methods that return information on the configuration.
  * * area() returns the surface are enclosed by the bounding box.
  * * n_objects() returns the number of objects in the configuration.
+ * * periodic() returns true if periodic boundary conditions are used.
+ * * reach(ff) returns the largest distance from an object center to the edge
+ *              of one of its atoms.
+ * * overlap(ff, obj, skip, grid) returns true if the object obj has a hard core
+ *              overlap with an object in the configuration (other than
+ *              number 'skip') using the spatial index 'grid'.
+ * * contact_scale(ff, grid, s_min) returns the factor, not less than s_min,
+ *              at which expand() would first bring two hard cores into contact.
  * * object_types() returns the number of different types of object (not very useful)
  * * energy(ff) returns the energy of the configuration using the forcefield
  *              ff for the calculation.
@@ -51,13 +67,18 @@
  *              the scaling factor dl. (Identity operation if dl = 0)
  * * rotate( no, dth ) rotate object number 'no' by a random angle controlled
  *              by the scaling factor dth. (Identity operation if dth = 0).
+ * * set_periodic( p ) chooses periodic boundary conditions or a closed box.
+ * * fill_grid( grid ) empties the cell list 'grid' and enters all the objects
+ *              so it can be used as a spatial index for the configuration.
  * * invalidate_within( r, no ) This marks the energies associated with objects
  *              less than the distance 'r' from object number 'no' as needing
  *              recalculation.
  *
  * Methods that operate on a pair of configurations
- * * rms( ref ) compare the configuration with that a reference configuration 'ref'
- *              and return the rms distance between atoms in the two configurations.
+ * * rms( ref, match ) compare the configuration with that a reference configuration 'ref'
+ *              and return the rms distance between atoms in the two configurations,
+ *              or if match is true between the centers of objects of the same type
+ *              paired by position (independent of the order of the objects).
  *
  * @todo Implement non-box boundaries as used for pcf calculations from experimental
  *       configurations measured by AFM.
@@ -76,6 +97,7 @@
 #define CONFIG_H
 
 #include "o_list.h"
+#include "cell_list.h"
 
 using namespace std;
 
@@ -89,21 +111,37 @@ public:
 
     void    add_topology(topology *a_topology); ///< Attach a topology to the configuration
     void    add_object(object *orig); ///< Insert the object orig into the configuration
+    object  *get_object(int index); ///< The object with the given index.
+    topology *get_topology();       ///< The topology of the objects.
     int     write( FILE* dest );    ///< Write the conformation to the dest file
     void    ps_atoms(force_field *the_forces, FILE *dest);   ///< Write the postscript part for the atoms.
     void    ps_box(FILE *dest);     ///< Write postscript path for the bounding box.
+    void    ps_window(force_field *the_forces, FILE *dest,
+                      double x0, double y0, double x1, double y1,
+                      cell_list *grid); ///< Write the postscript for the atoms in a window.
 
     double  energy(force_field *& the_force);   ///< Calculate the energy of a conformation using a force field.
     double  area();                 ///< The total area of the configuation.
     int     object_types();         ///< The number of different object types.
     int     n_objects();            ///< The number of objects in configuration.
+    bool    periodic();             ///< Are periodic boundary conditions used?
+    double  reach(force_field *the_force);  ///< Largest distance from an object center to an atom edge.
+    double  reach(force_field *the_force, int type);    ///< The same for one object type.
 
     void    expand( double dl );    ///< Expand the surface area by a factor dl.
     void    move(int obj_number, double dl_max);  ///< Move an object in the configuration.
     void    rotate(int obj_number, double theta_max); ///< Rotate an object in the configuration.
     void    invalidate_within(double distance, int index ); ///< Mark energies for recalculation.
+    void    fill_grid(cell_list *grid); ///< Enter all the objects in a spatial index.
+    void    set_periodic(bool periodic);    ///< Choose periodic or box boundary conditions.
+    void    image_shift(object *obj1, object *obj2,
+                        double *dx, double *dy);    ///< Shift to the image of obj2 closest to obj1.
+    bool    overlap(force_field *the_force, object *obj, int skip,
+                    cell_list *grid);   ///< Does obj overlap an object in the configuration?
+    double  contact_scale(force_field *the_force, cell_list *grid,
+                          double s_min);    ///< Smallest expand() factor that stays overlap free.
 
-    double  rms(const config& ref); ///< Calculate rms difference from a second conformation.
+    double  rms(const config& ref, bool match = false); ///< Calculate rms difference from a second conformation.
 
     /* Variables should be more private - the copy function is the main problem */
     double      x_size;             ///< The width of the configuration
@@ -0,0 +1,266 @@
+/**
+ * @file    convergence.cpp
+ * @author  agent
+ * @date    October 17, 2026
+ *
+ * Implementation of the convergence analyzer that decides when a run can stop.
+ */
+
+#include <math.h>
+#include <string.h>
+#include "convergence.h"
+#include "blocking.h"
+#include "common.h"
+
+#define CONV_STAGES 6               // Equilibration candidates, 0 to 50%
+
+/**
+ * Constructor for the convergence controller.
+ *
+ * @param a_fname   The output file.
+ * @param forces    The force field, for the energy.
+ * @param analyzers The other analyzers, measured before this one.
+ * @param names     Comma separated names of the analyzers watched, with the
+ *                  energy, or NULL for all those with a summary value.
+ * @param tol       The error target relative to the scale of the values.
+ * @param z         The largest drift, in errors, of an equilibrated run.
+ * @param n_min     The fewest samples before the run can stop.
+ */
+convergence::convergence(const char *a_fname, force_field *forces,
+                         vector<analyzer *> *analyzers, const char *names,
+                         double tol, double z, int n_min)
+                         : analyzer("convergence", a_fname) {
+    the_forces  = forces;
+    others      = analyzers;
+    watch       = names;
+    tolerance   = tol;
+    z_max       = z;
+    min_samples = n_min;
+    first       = 0;
+    strcpy(message, "no samples");
+}
+
+/**
+ * Destructor to destroy the analyzer.
+ */
+convergence::~convergence() {
+}
+
+/**
+ * @param other An analyzer.
+ * @return      True if its summary value is watched.
+ */
+bool    convergence::watched(analyzer *other){
+    const char  *p;
+    int     len = strlen(other->name);
+
+    if(other == this) return false;
+    if(!watch) return true;
+    for(p = strstr(watch, other->name); p; p = strstr(p+1, other->name))
+        if((p == watch || p[-1] == ',') && (p[len] == ',' || p[len] == '\0'))
+            return true;
+    return false;
+}
+
+/**
+ * Add the energy of a configuration and the summary values of the watched
+ * analyzers to their series. The observables are chosen at the first sample.
+ * The series must stay aligned, sample for sample, so a sample in which a
+ * watched analyzer has no value is left out of all of them.
+ *
+ * @param state The configuration.
+ */
+void    convergence::sample(config *state){
+    vector<double>  current;
+
+    if(names.empty()){
+        scalar_sources(others, sources);
+        for(unsigned int k = 0; k < sources.size(); )
+            if(watched(sources[k])) k++;
+            else sources.erase(sources.begin() + k);
+        names.push_back("energy");
+        for(unsigned int k = 0; k < sources.size(); k++)
+            names.push_back(sources[k]->name);
+        values.resize(names.size());
+    }
+    if(!scalar_values(sources, current)) return;
+    values[0].push_back(state->energy(the_forces));
+    for(unsigned int k = 0; k < sources.size(); k++)
+        values[k+1].push_back(current[k]);
+}
+
+/**
+ * @brief The blocking estimate of the mean of part of a series.
+ * @param k         The observable.
+ * @param from      The first sample.
+ * @param to        After the last sample.
+ * @param mean      Set to the mean.
+ * @param error     Set to its error.
+ * @param plateau   Set to true if the blocking reached a plateau.
+ */
+void    convergence::estimate(int k, int from, int to, double *mean,
+                              double *error, bool *plateau){
+    blocking    b(false);
+
+    for(int i = from; i < to; i++) b.add(values[k][i]);
+    *mean    = b.mean();
+    *error   = b.error();
+    *plateau = b.converged();
+}
+
+/**
+ * @brief The drift of an observable.
+ *
+ * The samples kept are split in two halves and the difference of their means
+ * compared with its error.
+ *
+ * @param k     The observable.
+ * @param from  The first sample kept.
+ * @return      The difference in errors (z value).
+ */
+double  convergence::drift(int k, int from){
+    int     n = values[k].size(), mid = (from + n)/2;
+    double  m1, m2, e1, e2, d;
+    bool    p1, p2;
+
+    estimate(k, from, mid, &m1, &e1, &p1);
+    estimate(k, mid, n, &m2, &e2, &p2);
+    d = fabs(m1 - m2);
+    if(e1*e1 + e2*e2 > 0.0) return d/sqrt(e1*e1 + e2*e2);
+    return (d > 0.0) ? HUGE_VAL : 0.0;
+}
+
+/**
+ * @brief The error target of an observable.
+ *
+ * The tolerance times the scale of the samples kept, the larger of the
+ * absolute value of their mean and their standard deviation.
+ *
+ * @param k     The observable.
+ * @param mean  The mean of the samples kept.
+ * @return      The target.
+ */
+double  convergence::target(int k, double mean){
+    int     n = values[k].size();
+    double  var = 0.0;
+
+    for(int i = first; i < n; i++)
+        var += (values[k][i] - mean)*(values[k][i] - mean);
+    return tolerance*max(fabs(mean), sqrt(var/(n - first)));
+}
+
+/**
+ * @brief Decide whether the run can stop.
+ *
+ * The equilibration is the first of CONV_STAGES candidates, 0 to 50% of the
+ * samples, after which no observable drifts by z_max errors or more. Then
+ * the error of the mean of each observable over the samples kept must be
+ * within the target and the blocking on its plateau. The status tells which
+ * condition failed, or that the run has converged.
+ *
+ * @return  True if the run has converged.
+ */
+bool    convergence::check(){
+    int     n = values.empty() ? 0 : values[0].size();
+    int     from, worst = 0, stage_worst = 0, best_first = 0;
+    double  z, z_stage, best_z = HUGE_VAL;
+    double  mean, error;
+    bool    plateau;
+
+    if(n < max(min_samples, 2)){
+        snprintf(message, CONV_STATUS, "waiting, %d of %d samples",
+                n, min_samples);
+        return false;
+    }
+    first = -1;
+    for(int s = 0; s < CONV_STAGES && first < 0; s++){
+        from = (s*n)/10;
+        z_stage = 0.0;
+        for(unsigned int k = 0; k < values.size(); k++){
+            z = drift(k, from);
+            if(z > z_stage){ z_stage = z; stage_worst = k; }
+        }
+        if(z_stage < z_max) first = from;
+        else if(z_stage < best_z){
+            best_z = z_stage; best_first = from; worst = stage_worst;
+        }
+    }
+    if(first < 0){                          // Report the least drifting
+        first = best_first;
+        snprintf(message, CONV_STATUS, "not equilibrated, %s drifts by %g errors",
+                names[worst], best_z);
+        return false;
+    }
+    for(unsigned int k = 0; k < values.size(); k++){
+        estimate(k, first, n, &mean, &error, &plateau);
+        if(!plateau){
+            snprintf(message, CONV_STATUS,
+                    "equilibrated at sample %d, no error plateau for %s",
+                    first, names[k]);
+            return false;
+        }
+        if(error > target(k, mean)){
+            snprintf(message, CONV_STATUS,
+                    "equilibrated at sample %d, error of %s %g above %g",
+                    first, names[k], error, target(k, mean));
+            return false;
+        }
+    }
+    snprintf(message, CONV_STATUS,
+            "converged, equilibrated at sample %d, %d samples kept",
+            first, n - first);
+    return true;
+}
+
+/**
+ * @return  Why the run continues or stops, from the last check().
+ */
+const char  *convergence::status(){
+    return message;
+}
+
+/**
+ * Write the estimates for each observable over the samples kept.
+ *
+ * @param dest  The file, open for writing.
+ * @return      The return value of the last print statement.
+ */
+int     convergence::write(FILE *dest){
+    int     rc, n;
+    double  mean, error;
+    bool    plateau;
+
+    rc = fprintf(dest, "# %s\n", message);
+    rc = fprintf(dest, "# observable samples first mean error drift plateau\n");
+    for(unsigned int k = 0; k < values.size(); k++){
+        n = values[k].size();
+        if(n < 2 || first >= n) continue;
+        estimate(k, first, n, &mean, &error, &plateau);
+        rc = fprintf(dest, "%s %d %d %g %g %g %d\n", names[k], n, first,
+                mean, error, drift(k, first), plateau ? 1 : 0);
+    }
+    return rc;
+}
+
+/**
+ * Write the status and the estimate of each observable to the log.
+ *
+ * @param the_log   The log file.
+ * @return          The number of lines written.
+ */
+int     convergence::log(FILE *the_log){
+    int     n;
+    double  mean, error;
+    bool    plateau;
+
+    fprintf(the_log, "Convergence: %s\n", message);
+    for(unsigned int k = 0; k < values.size(); k++){
+        n = values[k].size();
+        if(n < 2 || first >= n) continue;
+        estimate(k, first, n, &mean, &error, &plateau);
+        fprintf(the_log, "Convergence %s: mean = %g error = %g target = %g "
+                "drift = %g\n", names[k], mean, error, target(k, mean),
+                drift(k, first));
+    }
+    return values.size() + 1;
+}
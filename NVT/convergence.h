@@ -0,0 +1,74 @@
+/**
+ * @file    convergence.h
+ * @author  agent
+ * @date    October 17, 2026
+ * \brief   Header file for the convergence class
+ *
+ * @class   convergence convergence.h
+ * @brief   Decide when a run has equilibrated and sampled enough.
+ *
+ * A fixed number of steps is too many for some runs and too few for others.
+ * This analyzer stores, for every sample, the energy of the configuration and
+ * the summary value (analyzer::scalar()) of the watched analyzers (all those
+ * that have one, or those named), and at each report the program asks it with
+ * check() whether the run can stop:
+ * * equilibration, the first sample kept is the first of 0, 10, ... 50% of
+ *   the samples after which no observable drifts: the means of the two halves
+ *   of the kept samples differ by less than z_max times the error of their
+ *   difference (the errors from blocking);
+ * * precision, the blocking error of the mean of the kept samples of each
+ *   observable is below tolerance times its scale, the larger of the absolute
+ *   value of the mean and the standard deviation of the samples, and the
+ *   blocking has reached its plateau so the error can be trusted.
+ * There must be at least min_samples samples. The reason the run continues,
+ * or stops, is given by status() and written to the log:
+ *
+ *      Convergence: status
+ *      Convergence name: mean = .. error = .. target = .. drift = ..
+ *
+ * the drift being the z value of the difference of the halves. The output
+ * file has the same values for the samples kept.
+ */
+
+#ifndef CONVERGENCE_H
+#define CONVERGENCE_H
+
+#include <vector>
+#include "analyzer.h"
+
+#define CONV_STATUS 256             // Longest status message
+
+using namespace std;
+
+class convergence : public analyzer {
+public:
+    convergence(const char *fname, force_field *the_forces,
+                vector<analyzer *> *others, const char *watch,
+                double tolerance, double z_max,
+                int min_samples);           ///< Constructor with the output file, analyzers and criteria.
+    virtual ~convergence();                 ///< Destructor
+    virtual void    sample(config *state);  ///< Add the energy and the watched values.
+    virtual int     write(FILE *dest);      ///< Write the estimates for the samples kept.
+    virtual int     log(FILE *the_log);     ///< Write the status and estimates.
+    bool    check();                        ///< Has the run equilibrated and reached the precision?
+    const char  *status();                  ///< Why the run continues or stops.
+    int     first;                          ///< First sample kept (after equilibration).
+private:
+    bool    watched(analyzer *other);       ///< Is an analyzer watched?
+    void    estimate(int k, int from, int to, double *mean,
+                     double *error, bool *plateau); ///< Blocking estimate for part of a series.
+    double  drift(int k, int from);         ///< z value of the difference of the halves.
+    double  target(int k, double mean);     ///< Error target of the samples kept.
+    force_field *the_forces;
+    vector<analyzer *>  *others;            ///< The other analyzers.
+    const char  *watch;                     ///< Names of the watched analyzers (NULL all).
+    double  tolerance;                      ///< Relative error target.
+    double  z_max;                          ///< Largest drift of an equilibrated run.
+    int     min_samples;                    ///< Fewest samples before stopping.
+    vector<const char *>    names;          ///< Name of each observable.
+    vector<analyzer *>  sources;            ///< Analyzer of each observable after the energy.
+    vector< vector<double> >    values;     ///< Samples of each observable.
+    char    message[CONV_STATUS];           ///< The status.
+};
+
+#endif /* CONVERGENCE_H */
@@ -6,17 +6,19 @@
 
 #include "common.h"
 #include "force_field.h"
+#include <string.h>
 #include <string>
 
 #define  BIGVALUE   10E6
+#define  N_DEFINED  4           // Atom types in the hard coded tables
 
 // Hard coded boring force field copied into instances...
-double my_radius[MAX_TYPE]           =  { 1.0, 1.0, 1.0,-1.0 };
-const char *my_color [MAX_TYPE]    =  {"red","green","blue","orange"};
-double my_energy[MAX_TYPE][MAX_TYPE] = {{-1.0,-1.0,-1.0,-1.0 },
-                                        {-1.0,-1.0,-1.0,-1.0 },
-                                        {-1.0,-1.0,-1.0,-1.0 },
-                                        {-1.0,-1.0,-1.0,-1.0 }};
+double my_radius[N_DEFINED]          =  { 1.0, 1.0, 1.0,-1.0 };
+const char *my_color [N_DEFINED]   =  {"red","green","blue","orange"};
+double my_energy[N_DEFINED][N_DEFINED] = {{-1.0,-1.0,-1.0,-1.0 },
+                                          {-1.0,-1.0,-1.0,-1.0 },
+                                          {-1.0,-1.0,-1.0,-1.0 },
+                                          {-1.0,-1.0,-1.0,-1.0 }};
 double my_cut_off = 5.0;
 double my_length = 1.0;
 
@@ -25,12 +27,15 @@ force_field::force_field() {
 
     cut_off    = my_cut_off;
     length     = my_length;
-    type_max   = MAX_TYPE;
+    type_max   = N_DEFINED;
     big_energy = BIGVALUE;
     for( i=0; i< type_max; i++ ){
         radius[i] = my_radius[i];
         color[i]  = my_color[i];
-        for( j = 0; j < type_max; j++ ) energy[i][j] = my_energy[i][j];
+        for( j = 0; j < type_max; j++ ){
+            energy[i][j]   = my_energy[i][j];
+            table_dr[i][j] = 0.0;
+        }
     }
 }
 
@@ -44,7 +49,11 @@ force_field::force_field(const force_field& orig) {
     for( i=0; i< type_max; i++ ){
         radius[i] = orig.radius[i];
         color[i]  = orig.color[i];
-        for( j = 0; j < type_max; j++ ) energy[i][j] = orig.energy[i][j];
+        for( j = 0; j < type_max; j++ ){
+            energy[i][j]   = orig.energy[i][j];
+            table[i][j]    = orig.table[i][j];
+            table_dr[i][j] = orig.table_dr[i][j];
+        }
     }
 }
 
@@ -66,6 +75,8 @@ force_field::interaction(int t1, int t2, double r) {
         r    -= hard;
         if( r < 0 ){
             value = big_energy * (1 - r/hard);
+        } else if( !table[t1][t2].empty() ){    // Or tabulated potential
+            value = tabulated_value(t1, t2, r + hard);
         } else if (r< length) {
             r /= length;                        /// r between 0.0 and 1.0
             value = energy[t1][t2] * (1.0-r);
@@ -98,6 +109,11 @@ force_field::write(FILE* dest){
         fprintf(dest,"]");
     }
     fprintf(dest,"]\n");
+    for( i=0; i< type_max; i++ )
+        for( j=i; j< type_max; j++ )
+            if( !table[i][j].empty() )
+                fprintf(dest,"Tabulated %d %d with %d points every %g\n",
+                        i, j, (int)table[i][j].size(), table_dr[i][j]);
 
     return 0;
 }
@@ -105,3 +121,183 @@ force_field::write(FILE* dest){
 const char  *force_field::get_color(int t){
     return color[t];
 }
+
+int force_field::n_atom_types(){
+    return type_max;
+}
+
+/**
+ * Add a new atom type to the force field. Its well depths with all the
+ * types are zero until set with set_energy().
+ *
+ * @param r The hard core radius.
+ * @param c The postscript color.
+ * @return  The number of the new atom type.
+ */
+int force_field::add_type(double r, const char *c){
+    assert( type_max < MAX_TYPE );
+    radius[type_max] = r;
+    color[type_max]  = c;
+    for(int i = 0; i <= type_max; i++){
+        energy[i][type_max] = energy[type_max][i] = 0.0;
+        table[i][type_max].clear();
+        table[type_max][i].clear();
+        table_dr[i][type_max] = table_dr[type_max][i] = 0.0;
+    }
+    return type_max++;
+}
+
+/**
+ * Set the well depth between two atom types, the matrix is kept symmetric.
+ *
+ * @param t1    The first atom type.
+ * @param t2    The second atom type.
+ * @param e     The well depth.
+ */
+void force_field::set_energy(int t1, int t2, double e){
+    assert( t1 < type_max );
+    assert( t2 < type_max );
+    energy[t1][t2] = energy[t2][t1] = e;
+}
+
+double force_field::get_length(){
+    return length;
+}
+
+/**
+ * Read a set of parameters from a file, see the class description for the
+ * format. The parameters that are not in the set are unchanged. The reading
+ * stops at a line "end" or at the end of the file.
+ *
+ * @param src   The file, open for reading.
+ * @return      The number of parameters read (0 at the end of the file) or -1
+ *              if a line is not understood, in which case the error is
+ *              reported on the standard error stream.
+ */
+int force_field::read(FILE *src){
+    char    line[256], key[32];
+    int     t1, t2, n = 0, n_points;
+    double  value;
+    vector<double>  u;
+
+    while(fgets(line, sizeof(line), src)){
+        if(sscanf(line, "%31s", key) != 1 || key[0] == '#') continue;
+        if(!strcmp(key, "end")) break;
+        if(!strcmp(key, "cut_off") && sscanf(line, "%*s %lf", &value) == 1){
+            cut_off = value;
+        } else if(!strcmp(key, "length") && sscanf(line, "%*s %lf", &value) == 1
+                && value > 0.0){
+            length = value;
+        } else if(!strcmp(key, "radius")
+                && sscanf(line, "%*s %d %lf", &t1, &value) == 2
+                && t1 >= 0 && t1 < type_max){
+            radius[t1] = value;
+        } else if(!strcmp(key, "energy")
+                && sscanf(line, "%*s %d %d %lf", &t1, &t2, &value) == 3
+                && t1 >= 0 && t1 < type_max && t2 >= 0 && t2 < type_max){
+            set_energy(t1, t2, value);
+        } else if(!strcmp(key, "table")
+                && sscanf(line, "%*s %d %d %lf %d", &t1, &t2, &value, &n_points) == 4
+                && t1 >= 0 && t1 < type_max && t2 >= 0 && t2 < type_max
+                && value > 0.0 && n_points > 1){
+            u.resize(n_points);
+            for(int k = 0; k < n_points; k++)
+                if(fscanf(src, "%lf", &u[k]) != 1){
+                    fprintf(stderr, "Short force field table %d %d\n", t1, t2);
+                    return -1;
+                }
+            set_table(t1, t2, value, u);
+        } else {
+            fprintf(stderr, "Bad force field parameter: %s", line);
+            return -1;
+        }
+        n++;
+    }
+    return n;
+}
+
+/**
+ * Set the tabulated potential between two atom types, both orders. An empty
+ * table returns to the triangle potential.
+ *
+ * @param t1    The first atom type.
+ * @param t2    The second atom type.
+ * @param dr    The distance step of the table.
+ * @param u     The energies at the distances 0, dr, 2 dr...
+ */
+void force_field::set_table(int t1, int t2, double dr, const vector<double> &u){
+    assert( t1 < type_max );
+    assert( t2 < type_max );
+    assert( u.empty() || dr > 0.0 );
+    table[t1][t2]    = table[t2][t1]    = u;
+    table_dr[t1][t2] = table_dr[t2][t1] = dr;
+}
+
+/**
+ * @param t1    The first atom type.
+ * @param t2    The second atom type.
+ * @return      True if the two atom types have a tabulated potential.
+ */
+bool force_field::tabulated(int t1, int t2){
+    return !table[t1][t2].empty();
+}
+
+/**
+ * The linear interpolation of the tabulated potential, zero beyond the
+ * table.
+ *
+ * @param t1    The first atom type.
+ * @param t2    The second atom type.
+ * @param r     The distance.
+ * @return      The energy.
+ */
+double force_field::tabulated_value(int t1, int t2, double r){
+    const vector<double>  &u = table[t1][t2];
+    double  f = r/table_dr[t1][t2];
+    int     k = (int)f;
+
+    if( k+1 >= (int)u.size() ) return 0.0;
+    f -= k;
+    return (1.0-f)*u[k] + f*u[k+1];
+}
+
+/**
+ * The distance beyond which two atoms do not interact, the end of the table
+ * or of the triangle potential, and at most the cut off.
+ *
+ * @param t1    The first atom type.
+ * @param t2    The second atom type.
+ * @return      The distance.
+ */
+double force_field::range(int t1, int t2){
+    double  value = radius[t1] + radius[t2] + length;
+
+    if( !table[t1][t2].empty() )
+        value = max(radius[t1] + radius[t2],
+                    (table[t1][t2].size()-1)*table_dr[t1][t2]);
+    return min(value, cut_off);
+}
+
+/**
+ * Write the tabulated potentials in the format read by read(), each pair of
+ * types once.
+ *
+ * @param dest  The file, open for writing.
+ * @return      The number of tables written.
+ */
+int force_field::write_tables(FILE *dest){
+    int     n = 0;
+
+    for(int i = 0; i < type_max; i++){
+        for(int j = i; j < type_max; j++){
+            if( table[i][j].empty() ) continue;
+            fprintf(dest, "table %d %d %.10g %d\n", i, j, table_dr[i][j],
+                    (int)table[i][j].size());
+            for(unsigned int k = 0; k < table[i][j].size(); k++)
+                fprintf(dest, (k % 8 == 7 || k+1 == table[i][j].size())
+                        ? "%.10g\n" : "%.10g ", table[i][j][k]);
+            n++;
+        }
+    }
+    return n;
+}
@@ -12,7 +12,12 @@
  * associated with a configuration. The fundamental function of the
  * class is interaction(t1, t2, r ) that returns the interaction energy
  * associated with two particles separated by a distance r, one of
- * type t1 the other of type t2.
+ * type t1 the other of type t2. Outside the hard core this is a triangle
+ * potential of depth energy[t1][t2] and width length, unless the pair of
+ * types has a tabulated potential (used to fit the force field to measured
+ * pair correlation functions, see the ibi program). A table gives the energy
+ * at the distances 0, dr, 2 dr... and is interpolated linearly, it is zero
+ * beyond its last point.
  *
  * Internally the force field contains the following information and
  * tables.
@@ -34,8 +39,22 @@
  * * writing the forcefield to a file descriptor.
  * * obtaining the hard core size of an atom.
  * * obtaining a postscript string setting the color of an atom
+ * * adding atom types and setting well depths, used for the single disc
+ *   proxies of topology::proxy().
+ * * reading parameters from a file, read() changes the parameters given in
+ *   the file and keeps the others. The file has one parameter per line:
+ *
+ *      cut_off 5.0             The cut off distance.
+ *      length 1.0              The interaction length scale.
+ *      radius t r              The hard core radius of atom type t.
+ *      energy t1 t2 e          The well depth between atom types t1 and t2.
+ *      table t1 t2 dr n        A tabulated potential between atom types t1
+ *      u_0 u_1 ... u_n-1       and t2, followed by its n values (on as many
+ *                              lines as needed).
+ *
+ *   Lines starting with # are comments. A line "end" ends a parameter set,
+ *   so one file can hold several sets that are read one after the other.
  *
- * \todo Constructor from a reading a file
  * \todo Pair dependent length scale.
  */
 
@@ -43,9 +62,12 @@
 #define FORCE_FIELD_H
 
 #include <stdio.h>
+#include <vector>
+
+using namespace std;
 
 // There must be an efficient beter way
-#define  MAX_TYPE   4
+#define  MAX_TYPE   8
 // The forcefield is currently hard coded... should read from a file.
 
 class force_field {
@@ -57,6 +79,16 @@ public:
     double      size(int t1);               ///< The hard core size of an atom type t1.
     int         write( FILE *dest );        ///< Write the forcefield to file
     const char  *get_color(int t);          ///< Color for plot output
+    int         n_atom_types();             ///< The number of atom types defined.
+    int         add_type(double r, const char *c);  ///< Add an atom type, returns its number.
+    void        set_energy(int t1, int t2, double e);   ///< Set the well depth between two atom types.
+    double      get_length();               ///< The interaction length scale.
+    int         read(FILE *src);            ///< Read a parameter set, returns the number of parameters or -1.
+    void        set_table(int t1, int t2, double dr,
+                          const vector<double> &u); ///< Set the tabulated potential between two atom types.
+    bool        tabulated(int t1, int t2);  ///< Do two atom types have a tabulated potential?
+    double      range(int t1, int t2);      ///< Distance beyond which two atoms do not interact.
+    int         write_tables(FILE *dest);   ///< Write the tabulated potentials in the read() format.
     double      cut_off;                    ///< Distance cutoff between objects
     double      big_energy;                 ///< Large value less than infinity.
 private:
@@ -65,6 +97,9 @@ private:
     double      radius[MAX_TYPE];           ///< Atom radii
     const char *color [MAX_TYPE];           ///< Atom colors for postscript
     double      energy[MAX_TYPE][MAX_TYPE]; ///< Pairwise interaction well depths.
+    double      tabulated_value(int t1, int t2, double r);  ///< Interpolated table.
+    vector<double>  table[MAX_TYPE][MAX_TYPE];  ///< Tabulated potentials (empty if none).
+    double      table_dr[MAX_TYPE][MAX_TYPE];   ///< Distance step of the tables.
 };
 
 #endif /* FORCE_FIELD_H */
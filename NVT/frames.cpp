@@ -0,0 +1,84 @@
+/**
+ * @file    frames.cpp
+ * @author  agent
+ * @date    October 17, 2026
+ *
+ * Implementation of the frames analyzer that records the energy and summary
+ * values of each sample for reweighting.
+ */
+
+#include <stdlib.h>
+#include <math.h>
+#include "frames.h"
+#include "common.h"
+
+/**
+ * Constructor for the frames analyzer, the output file is created.
+ *
+ * @param a_fname   The output file.
+ * @param forces    The force field, for the energy.
+ * @param a_beta    The temperature parameter of the run.
+ * @param analyzers The other analyzers, measured before this one.
+ */
+frames::frames(const char *a_fname, force_field *forces, double a_beta,
+               vector<analyzer *> *analyzers) : analyzer("frames", a_fname) {
+    the_forces = forces;
+    beta       = a_beta;
+    others     = analyzers;
+    if(! (dest = fopen(fname, "w"))){
+        fprintf(stderr, "Unable to open %s for writing\n", fname);
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * Destructor that closes the output file.
+ */
+frames::~frames() {
+    fclose(dest);
+}
+
+/**
+ * Append the energy of a configuration and the summary values of the other
+ * analyzers to the output file. The values recorded are chosen, and the
+ * header written, at the first sample; a value that is missing later is
+ * recorded as 0.
+ *
+ * @param state The configuration.
+ */
+void    frames::sample(config *state){
+    vector<double>  current;
+
+    if(n_samples == 0){
+        scalar_sources(others, sources);
+        fprintf(dest, "# frames beta = %.10g objects = %d\n# energy",
+                beta, state->n_objects());
+        for(unsigned int k = 0; k < sources.size(); k++)
+            fprintf(dest, " %s", sources[k]->name);
+        fprintf(dest, "\n");
+    }
+    fprintf(dest, "%.10g", state->energy(the_forces));
+    scalar_values(sources, current);
+    for(unsigned int k = 0; k < sources.size(); k++)
+        fprintf(dest, " %.10g", isnan(current[k]) ? 0.0 : current[k]);
+    fprintf(dest, "\n");
+}
+
+/**
+ * Flush the output file so the samples so far can be read.
+ *
+ * @return EXIT_SUCCESS or EXIT_FAILURE if the file cannot be written.
+ */
+int     frames::save(){
+    return fflush(dest) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/**
+ * Write the number of samples recorded.
+ *
+ * @param a_dest    The file, open for writing.
+ * @return          The return value of the print statement.
+ */
+int     frames::write(FILE *a_dest){
+    return fprintf(a_dest, "%d samples in %s\n", n_samples, fname);
+}
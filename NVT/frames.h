@@ -0,0 +1,54 @@
+/**
+ * @file    frames.h
+ * @author  agent
+ * @date    October 17, 2026
+ * \brief   Header file for the frames class
+ *
+ * @class   frames frames.h
+ * @brief   Records the energy and summary values of each sample.
+ *
+ * Histogram reweighting (see the reweight program) needs, for every sample
+ * of a run, the energy of the configuration and the observables to be
+ * reweighted, but not the configurations themselves. This analyzer keeps
+ * these values, the energy and the summary value (analyzer::scalar()) of each
+ * of the other analyzers, and writes them as one line per sample after a
+ * short header:
+ *
+ *      # frames beta = 1 objects = 400
+ *      # energy cluster order
+ *      -123.5 12 0.63
+ *      ...
+ *
+ * It must be given the list of analyzers and measured after the others so
+ * the values are those of the same configuration.
+ *
+ * The file is opened when the analyzer is created, the header is written at
+ * the first sample and each sample is appended as it is taken, so the values
+ * are not kept in memory and save() only flushes the file.
+ */
+
+#ifndef FRAMES_H
+#define FRAMES_H
+
+#include <vector>
+#include "analyzer.h"
+
+using namespace std;
+
+class frames : public analyzer {
+public:
+    frames(const char *fname, force_field *the_forces, double beta,
+           vector<analyzer *> *others);     ///< Constructor with the output file and the other analyzers.
+    virtual ~frames();                      ///< Destructor, closes the file.
+    virtual void    sample(config *state);  ///< Append the energy and the other values.
+    virtual int     save();                 ///< Flush the output file.
+    virtual int     write(FILE *dest);      ///< Write the number of samples.
+private:
+    FILE    *dest;                          ///< The output file.
+    force_field *the_forces;
+    double  beta;                           ///< The temperature parameter of the run.
+    vector<analyzer *>  *others;            ///< The other analyzers.
+    vector<analyzer *>  sources;            ///< Analyzer of each value after the energy.
+};
+
+#endif /* FRAMES_H */
@@ -24,7 +24,10 @@ integrator::integrator(force_field *forces) {
     n_step     = 0;
     dl_max     = 1.0;
     i_adjust   = 1000;
+    n_screened = 0;
+    delayed    = false;
     the_forces = forces;
+    the_surrogate = (surrogate *)NULL;
 }
 
 /**
@@ -39,13 +42,17 @@ integrator::integrator(const integrator& orig) {
     dl_max     = orig.dl_max;
     n_step     = orig.n_step;
     i_adjust   = orig.i_adjust;
+    n_screened = orig.n_screened;
+    delayed    = orig.delayed;
     the_forces = orig.the_forces;
+    the_surrogate = (surrogate *)NULL;  // Rebuilt when needed
 }
 
 /**
  * Destructor to destroy an integrator.
  */
 integrator::~integrator() {
+    if(the_surrogate) delete the_surrogate;
 }
 
 /**
@@ -59,6 +66,14 @@ integrator::~integrator() {
  * - Accepting or rejecting the configuration based on the metropolis criterion.
  * - Updating the integrator tallies.
  *
+ * With delayed acceptance the moved object is first built on its own and the
+ * move is accepted or rejected with the metropolis criterion applied to the
+ * surrogate energy change dU_s. Only moves that pass this first stage clone
+ * the configuration and calculate the full energy change dU, they are then
+ * accepted with the probability min(1, e^(-beta (dU - dU_s))). The product of
+ * the two stages satisfies detailed balance with the full energy so the
+ * ensemble sampled is unchanged.
+ *
  * @param state_h a handle to the configuration. This will be updated during
  *                the run, so the_state at the end is different if a change is
  *                made.
@@ -74,9 +89,15 @@ integrator::run(config **state_h, double beta, double P, int n_steps){
     int     i;              ///< Iteration counter
     int     obj_number;     ///< Index of object to modify
     double  dU;             ///< Internal energy change.
+    double  dU_s;           ///< Surrogate energy change.
     double  prob_new;       ///< Acceptance probability.
     config  *the_state = *state_h;
     config  *new_state;     ///< Pointer to modified state.
+    object  *moved;         ///< The moved object in the new state.
+
+    if(delayed && !the_surrogate)
+        the_surrogate = new surrogate(the_forces, the_state->get_topology());
+    if(delayed) the_surrogate->track(the_state);   // The state may be new
 
     for(i = 0; i < n_steps; i++){
         /* If necessary adjust integrator parameters and tallies */
@@ -85,23 +106,49 @@ integrator::run(config **state_h, double beta, double P, int n_steps){
             if(((float)n_good/(n_good+n_bad)) > 0.7) dl_max *= 3.0;
             dl_max = min( dl_max, the_state->x_size);
             dl_max = min( dl_max, the_state->y_size);
-            n_good = n_bad = 0;
+            n_good = n_bad = n_screened = 0;
         }
+        n_step++;
 
-        /** Clone configuration and move an object in the new configuration */
-        /** @todo   Chose between different types of modification           */
-        new_state = new config(*the_state);
-
-        /// The integrator move function.
         obj_number = rnd_lin(1.0)*the_state->n_objects();
-        new_state->move(obj_number, dl_max);
+        dU_s = 0.0;
+        if(delayed){
+            /* First stage, screen a trial object with the surrogate       */
+            object  trial(*the_state->get_object(obj_number));
+            trial.move(dl_max, the_state->x_size, the_state->y_size,
+                    the_state->periodic());
+            trial.rotate(M_2PI);
+            dU_s = the_surrogate->energy_change(the_state, obj_number, &trial);
+            prob_new = min(1.0, exp(- beta * dU_s));
+            if(rnd_lin(1.0) > prob_new){
+                n_bad++;
+                n_screened++;
+                continue;
+            }
+            new_state = new config(*the_state);
+            moved = new_state->get_object(obj_number);
+            moved->pos_x       = trial.pos_x;
+            moved->pos_y       = trial.pos_y;
+            moved->orientation = trial.orientation;
+            moved->image_x     = trial.image_x;
+            moved->image_y     = trial.image_y;
+            moved->recalculate = true;
+        } else {
+            /** Clone configuration and move an object in the new configuration */
+            /** @todo   Chose between different types of modification           */
+            new_state = new config(*the_state);
+
+            /// The integrator move function.
+            new_state->move(obj_number, dl_max);
+        }
         new_state->invalidate_within(the_forces->cut_off, obj_number);
         new_state->unchanged = false;
 
-        /* Calculate probability of accepting the new state                */
+        /* Calculate probability of accepting the new state, with delayed  */
+        /* acceptance the surrogate change is corrected for.               */
         dU = new_state->energy(the_forces)
                 - the_state->energy(the_forces);
-        prob_new = exp(- beta * dU );
+        prob_new = exp(- beta * (dU - dU_s));
         prob_new = min(1.0,prob_new);
 
         /* Accept or reject the new state according to the probability     */
@@ -109,11 +156,12 @@ integrator::run(config **state_h, double beta, double P, int n_steps){
             n_good++;
             delete(the_state);
             the_state = new_state;
+            if(delayed) the_surrogate->moved(obj_number,
+                    the_state->get_object(obj_number));
         } else {
             n_bad++;
             delete(new_state);
         }
-        n_step++;
     }
     *state_h = the_state;
     return n_step;
@@ -16,6 +16,17 @@
  * Currently the nature of the steps is hard coded as are the various integration
  * counters and control parameters.
  *
+ * If 'delayed' is set the integrator uses two stage delayed acceptance
+ * (Christen and Fox 2005). Each trial move is first screened with the cheap
+ * object level energy of a surrogate, built from the topology of the
+ * configuration at the first run, and only the moves that pass are evaluated
+ * with the full atom level energy. The second stage corrects for the
+ * surrogate so the sampling is exact. The moves rejected by the first stage
+ * are counted in n_screened (as well as in n_bad).
+ * The surrogate indexes the objects of the configuration at the start of each
+ * run and follows the accepted moves, so a screen only visits the neighbours
+ * of the moved object.
+ *
  * @todo    The integrator should incorporate more of the choices about
  *          integration to allow different types of dynamics. So there should
  *          be choices about the configuration manipulations possible and their
@@ -26,6 +37,7 @@
 #define INTEGRATOR_H
 
 #include "config.h"
+#include "surrogate.h"
 
 class integrator {
 public:
@@ -36,11 +48,14 @@ public:
                 double P, int n_step);      ///< Run n_step integration steps
     int     n_good;                         ///< Integrator tally, number of accepted moves.
     int     n_bad;                          ///< Integrator tally, number of rejected moves.
+    int     n_screened;                     ///< Integrator tally, moves rejected by the surrogate.
     int     i_adjust;                       ///< Frequency of integrator adjustment.
     double  dl_max;                         ///< Maximum move distance.
+    bool    delayed;                        ///< Use delayed acceptance with a surrogate.
 private:
     int     n_step;                         ///< Number of integrator steps made so far.
     force_field *the_forces;
+    surrogate   *the_surrogate;             ///< Surrogate energy for delayed acceptance.
 };
 
 #endif /* INTEGRATOR_H */
@@ -0,0 +1,198 @@
+/**
+ * @file    msd.cpp
+ * @author  agent
+ * @date    October 17, 2026
+ *
+ * Implementation of the msd analyzer, a multiple tau correlator for the mean
+ * squared displacement.
+ */
+
+#include <math.h>
+#include "msd.h"
+#include "common.h"
+
+#define MSD_POINTS      16          // Positions kept at each level
+#define MSD_AVERAGE     2           // Positions averaged between levels
+
+/**
+ * Constructor for the mean squared displacement analyzer.
+ *
+ * @param a_fname   The output file.
+ * @param a_dt      The number of sweeps between samples.
+ */
+msd::msd(const char *a_fname, double a_dt) : analyzer("msd", a_fname) {
+    assert(a_dt > 0.0);
+    dt      = a_dt;
+    n_obj   = -1;
+    n_types = 0;
+}
+
+/**
+ * Destructor to destroy the analyzer.
+ */
+msd::~msd() {
+}
+
+/**
+ * @brief The lag of a point of the correlator.
+ * @param l The level.
+ * @param j The point, the number of positions back.
+ * @return  The lag in sweeps.
+ */
+double  msd::lag(int l, int j){
+    return j*pow((double)MSD_AVERAGE, l)*dt;
+}
+
+/**
+ * Add positions to a level of the correlator: correlate them with the
+ * positions kept, keep them and pass their average to the next level every
+ * MSD_AVERAGE calls. The lags already covered by the level below are not
+ * correlated again.
+ *
+ * @param l The level, created if necessary.
+ * @param x The x positions of the objects.
+ * @param y The y positions of the objects.
+ */
+void    msd::add(unsigned int l, const vector<double> &x, const vector<double> &y){
+    double  *px, *py, ex, ey;
+    int     slot;
+
+    if(l == levels.size()){
+        levels.push_back(level());
+        level &lv = levels[l];
+        lv.x.assign(MSD_POINTS*n_obj, 0.0);
+        lv.y.assign(MSD_POINTS*n_obj, 0.0);
+        lv.acc_x.assign(n_obj, 0.0);
+        lv.acc_y.assign(n_obj, 0.0);
+        lv.head = lv.n_in = lv.n_acc = 0;
+        lv.sum.assign(MSD_POINTS*n_types, 0.0);
+        lv.count.assign(MSD_POINTS, 0);
+    }
+    level &lv = levels[l];
+
+    lv.head = (lv.head + 1) % MSD_POINTS;   // Keep the positions
+    px = &lv.x[lv.head*n_obj];
+    py = &lv.y[lv.head*n_obj];
+    for(int i = 0; i < n_obj; i++){ px[i] = x[i]; py[i] = y[i]; }
+    lv.n_in++;
+
+    for(int j = (l == 0) ? 1 : MSD_POINTS/MSD_AVERAGE;
+            j < min(lv.n_in, MSD_POINTS); j++){ // Correlate
+        slot = (lv.head - j + MSD_POINTS) % MSD_POINTS;
+        px = &lv.x[slot*n_obj];
+        py = &lv.y[slot*n_obj];
+        for(int i = 0; i < n_obj; i++){
+            ex = x[i] - px[i];
+            ey = y[i] - py[i];
+            lv.sum[j*n_types + type[i]] += ex*ex + ey*ey;
+        }
+        lv.count[j]++;
+    }
+
+    for(int i = 0; i < n_obj; i++){         // Average for the next level
+        lv.acc_x[i] += x[i];
+        lv.acc_y[i] += y[i];
+    }
+    if(++lv.n_acc == MSD_AVERAGE){
+        vector<double>  ax(n_obj), ay(n_obj);
+        for(int i = 0; i < n_obj; i++){
+            ax[i] = lv.acc_x[i]/MSD_AVERAGE;
+            ay[i] = lv.acc_y[i]/MSD_AVERAGE;
+        }
+        lv.acc_x.assign(n_obj, 0.0);
+        lv.acc_y.assign(n_obj, 0.0);
+        lv.n_acc = 0;
+        add(l+1, ax, ay);
+    }
+}
+
+/**
+ * Add the unwrapped positions of a configuration to the correlator. The
+ * objects are identified by their index, if their number changes the
+ * correlator starts again.
+ *
+ * @param state The configuration.
+ */
+void    msd::sample(config *state){
+    int     n = state->n_objects();
+    object  *obj;
+    vector<double>  x(n), y(n);
+
+    if(n != n_obj){
+        n_obj   = n;
+        n_types = state->get_topology()->n_types();
+        levels.clear();
+        type.resize(n);
+        n_of_type.assign(n_types, 0);
+        for(int i = 0; i < n; i++){
+            type[i] = state->get_object(i)->o_type;
+            n_of_type[type[i]]++;
+        }
+    }
+    for(int i = 0; i < n; i++){
+        obj  = state->get_object(i);
+        x[i] = obj->pos_x + obj->image_x*state->x_size;
+        y[i] = obj->pos_y + obj->image_y*state->y_size;
+    }
+    add(0, x, y);
+}
+
+/**
+ * Write the mean squared displacement of all the objects and of each type
+ * for each lag measured.
+ *
+ * @param dest  The file, open for writing.
+ * @return      The return value of the last print statement.
+ */
+int     msd::write(FILE *dest){
+    int     rc;
+    double  all;
+
+    rc = fprintf(dest, "# lag origins all");
+    for(int t = 0; t < n_types; t++) rc = fprintf(dest, " type_%d", t);
+    rc = fprintf(dest, "\n");
+    for(unsigned int l = 0; l < levels.size(); l++){
+        level &lv = levels[l];
+        for(int j = 1; j < MSD_POINTS; j++){
+            if(lv.count[j] == 0) continue;
+            all = 0.0;
+            for(int t = 0; t < n_types; t++) all += lv.sum[j*n_types + t];
+            rc = fprintf(dest, "%g %ld %g", lag(l, j), lv.count[j],
+                    all/((double)lv.count[j]*n_obj));
+            for(int t = 0; t < n_types; t++)
+                rc = fprintf(dest, " %g", (n_of_type[t] > 0)
+                        ? lv.sum[j*n_types + t]/((double)lv.count[j]*n_of_type[t])
+                        : 0.0);
+            rc = fprintf(dest, "\n");
+        }
+    }
+    return rc;
+}
+
+/**
+ * Write the longest lag measured, its mean squared displacement and the
+ * corresponding diffusion coefficient to the log, one line per object type
+ * present.
+ *
+ * @param the_log   The log file.
+ * @return          The number of lines written.
+ */
+int     msd::log(FILE *the_log){
+    int     l, j, n_lines = 0;
+    double  value, tau;
+
+    for(l = levels.size() - 1; l >= 0; l--){    // Longest lag measured
+        for(j = MSD_POINTS - 1; j > 0 && levels[l].count[j] == 0; j--);
+        if(j > 0) break;
+    }
+    if(l < 0) return 0;
+    tau = lag(l, j);
+    for(int t = 0; t < n_types; t++){
+        if(n_of_type[t] == 0) continue;
+        value = levels[l].sum[j*n_types + t]/((double)levels[l].count[j]*n_of_type[t]);
+        fprintf(the_log, "MSD type %d: lag = %g msd = %g D = %g\n",
+                t, tau, value, value/(4.0*tau));
+        n_lines++;
+    }
+    return n_lines;
+}
@@ -0,0 +1,76 @@
+/**
+ * @file    msd.h
+ * @author  agent
+ * @date    October 17, 2026
+ * \brief   Header file for the msd class
+ *
+ * @class   msd msd.h
+ * @brief   Mean squared displacement with a multiple tau correlator.
+ *
+ * The mean squared displacement of the object centers
+ *
+ *      MSD(tau) = < |r_i(t + tau) - r_i(t)|^2 >
+ *
+ * is averaged over the objects of each type and over the time origins t. The
+ * unwrapped positions (see object) are used so the displacements are not
+ * limited by the periodic box.
+ *
+ * Keeping all the positions of a long run is impossible for a large system,
+ * so the correlation is made with a multiple tau correlator (Ramirez et al.
+ * 2010). Level 0 keeps the last MSD_POINTS samples and correlates each new
+ * sample with them, giving the lags 1..MSD_POINTS-1. Every MSD_AVERAGE
+ * samples the mean of the positions is passed to the next level, that does
+ * the same with lags MSD_AVERAGE times longer, and so on. The lags covered
+ * grow geometrically with the number of levels, so the memory used is
+ * O(N log T) and each sample costs O(N) on average. At the higher levels the
+ * positions are averages over a time window, which smooths the MSD on that
+ * time scale but not its long time behaviour.
+ *
+ * The lags are given in sweeps, dt is the number of sweeps between samples.
+ * At each report the log has one line per object type with the longest lag
+ * measured, its MSD and the diffusion coefficient MSD/(4 lag):
+ *
+ *      MSD type t: lag = .. msd = .. D = ..
+ *
+ * The output file has a comment line naming the columns followed by one line
+ * per lag: the lag, the number of time origins averaged, the MSD of all the
+ * objects and of each type.
+ */
+
+#ifndef MSD_H
+#define MSD_H
+
+#include <vector>
+#include "analyzer.h"
+
+using namespace std;
+
+class msd : public analyzer {
+public:
+    msd(const char *fname, double dt);      ///< Constructor with the output file and sweeps between samples.
+    virtual ~msd();                         ///< Destructor
+    virtual void    sample(config *state);  ///< Add the positions of one configuration.
+    virtual int     write(FILE *dest);      ///< Write the MSD for each lag.
+    virtual int     log(FILE *the_log);     ///< Write the longest lag measured.
+    double  dt;                             ///< Sweeps between samples.
+private:
+    struct level {
+        vector<double>  x, y;               ///< The last positions, MSD_POINTS per object.
+        vector<double>  acc_x, acc_y;       ///< Sums of the positions for the next level.
+        int     head;                       ///< Slot of the last positions.
+        int     n_in;                       ///< Number of positions added.
+        int     n_acc;                      ///< Number of positions in the sums.
+        vector<double>  sum;                ///< Sum of the squared displacements, by lag and type.
+        vector<long>    count;              ///< Number of time origins, by lag.
+    };
+    void    add(unsigned int l, const vector<double> &x,
+                const vector<double> &y);   ///< Add positions to a level.
+    double  lag(int l, int j);              ///< The lag in sweeps of point j of level l.
+    int     n_obj;                          ///< Number of objects followed.
+    int     n_types;                        ///< Number of object types.
+    vector<int>     type;                   ///< Type of each object.
+    vector<int>     n_of_type;              ///< Number of objects of each type.
+    vector<level>   levels;                 ///< The correlator levels.
+};
+
+#endif /* MSD_H */
@@ -59,13 +59,13 @@ int o_list::add(object *my_obj){
     return n_full;
 }
 
-object *o_list::get(int i){
+object *o_list::get(int i) const {
     assert(i>=0);
     assert(i<n_full);
     return space[i];
 }
 
-int o_list::size(){
+int o_list::size() const {
     return n_full;
 }
 
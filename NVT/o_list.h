@@ -39,8 +39,8 @@ public:
     o_list(o_list& orig);                   ///< Constructor for a deep copy of the list
     virtual ~o_list();                      ///< Destructor
     int     add(object *my_obj);            ///< Add an object to the list
-    object *get(int i);                     ///< Retrieve a pointer to the indexed object.
-    int     size();                         ///< Return the number of objects in the list.
+    object *get(int i) const;               ///< Retrieve a pointer to the indexed object.
+    int     size() const;                   ///< Return the number of objects in the list.
     void    empty();                        ///< Clear the contents of the list.
 private:
     int     n_full;                         ///< Number of full slots.
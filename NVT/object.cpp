@@ -22,6 +22,8 @@ object::object(int  type, double x_pos, double y_pos, double angle ) {
     pos_x        = x_pos;
     pos_y        = y_pos;
     orientation  = angle;
+    image_x      = 0;
+    image_y      = 0;
     recalculate  = true;
     saved_energy = 0.0;
 }
@@ -35,6 +37,8 @@ object::object(const object& orig) {
     pos_x        = orig.pos_x;
     pos_y        = orig.pos_y;
     orientation  = orig.orientation;
+    image_x      = orig.image_x;
+    image_y      = orig.image_y;
     recalculate  = true;            // Can't guarantee same context.
     saved_energy = 0.0;             // This does not mater.
 }
@@ -78,16 +82,27 @@ object::move(double max_dist, double x_size, double y_size, bool periodic){
     /* Handle the edges to keep the object in the box */
     pos_x += dx;
     pos_y += dy;
-    if(periodic){
-        while( pos_x < 0 )      pos_x += x_size;
-        while( pos_x > x_size ) pos_x -= x_size;
-        while( pos_y < 0 )      pos_y += y_size;
-        while( pos_y > y_size ) pos_y -= y_size;
-    }
+    if(periodic) wrap(x_size, y_size);
 
     recalculate = true;
 }
 
+/**
+ * @brief   Put the object back in a periodic box.
+ *
+ * The image counters are changed by the number of box sizes the position is
+ * shifted by, so the unwrapped position is unchanged.
+ *
+ * @param x_size    The width of the box.
+ * @param y_size    The height of the box.
+ */
+void    object::wrap(double x_size, double y_size){
+    while( pos_x < 0 )      { pos_x += x_size; image_x--; }
+    while( pos_x > x_size ) { pos_x -= x_size; image_x++; }
+    while( pos_y < 0 )      { pos_y += y_size; image_y--; }
+    while( pos_y > y_size ) { pos_y -= y_size; image_y++; }
+}
+
 /**
  * Rotate a random object a random amount.
  * @param max_angle
@@ -217,6 +232,111 @@ double  object::interaction(force_field* the_force,
     return energy;
 }
 
+/**
+ * @brief   Test for a hard core overlap with another object.
+ * @param the_force       The force field giving the hard core sizes.
+ * @param the_topologies  Topology information for the objects.
+ * @param obj2            The second object.
+ * @param dx              Shift to apply to obj2 (to use a periodic image).
+ * @param dy              Shift to apply to obj2 in y.
+ * @return                true if two atoms are closer than their hard cores.
+ *
+ * This is the test for the region where the force field returns the core
+ * penalty, it stops at the first overlapping pair of atoms.
+ */
+bool    object::core_overlap(force_field* the_force,
+                topology *the_topologies,
+                object* obj2, double dx, double dy){
+    int     n1, n2, t2;
+    atom    *at1, *at2;
+    double  x1, y1, x2, y2, hard;
+    double  c1, s1, c2, s2;
+    double  ox2, oy2;
+
+    n1 = the_topologies->n_atom(o_type);
+    n2 = the_topologies->n_atom(obj2->o_type);
+    t2  = obj2->o_type;
+    ox2 = obj2->pos_x + dx;
+    oy2 = obj2->pos_y + dy;
+    c1  = cos(orientation);       s1 = sin(orientation);
+    c2  = cos(obj2->orientation); s2 = sin(obj2->orientation);
+
+    for(int i = 0; i < n1; i++){
+        at1 = the_topologies->atoms(o_type, i);
+        x1 = pos_x - s1*at1->y_pos + c1*at1->x_pos;
+        y1 = pos_y + c1*at1->y_pos + s1*at1->x_pos;
+        for(int j = 0; j < n2; j++){
+            at2 = the_topologies->atoms(t2, j);
+            x2 = ox2 - s2*at2->y_pos + c2*at2->x_pos;
+            y2 = oy2 + c2*at2->y_pos + s2*at2->x_pos;
+            hard = the_force->size(at1->type) + the_force->size(at2->type);
+            if((hard > 0.0) &&
+               ((x2-x1)*(x2-x1) + (y2-y1)*(y2-y1) < hard*hard)) return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief   Find the isometric compression that brings two objects into contact.
+ * @param the_force       The force field giving the hard core sizes.
+ * @param the_topologies  Topology information for the objects.
+ * @param obj2            The second object.
+ * @param dx              Shift to apply to obj2 (to use a periodic image).
+ * @param dy              Shift to apply to obj2 in y.
+ * @return                The largest factor s < 1 such that multiplying the
+ *                        object positions (but not the orientations or the
+ *                        atom offsets) by s brings two hard cores into
+ *                        contact, or 0.0 if no compression does.
+ *
+ * For a pair of atoms with the center separation D and the offset e between
+ * the atoms (due to the orientations) the distance after scaling is
+ * |s D + e|. Contact happens at the roots of |s D + e|^2 = R^2 where R is the
+ * sum of the hard core radii, the objects are assumed not to overlap at s = 1
+ * so the overlap starts at the larger root.
+ */
+double  object::contact_scale(force_field* the_force,
+                topology *the_topologies,
+                object* obj2, double dx, double dy){
+    int     n1, n2, t2;
+    atom    *at1, *at2;
+    double  ex, ey, hard;
+    double  c1, s1, c2, s2;
+    double  cx, cy;
+    double  a, b, c, disc, root;
+    double  value = 0.0;
+
+    n1 = the_topologies->n_atom(o_type);
+    n2 = the_topologies->n_atom(obj2->o_type);
+    t2 = obj2->o_type;
+    cx = obj2->pos_x + dx - pos_x;
+    cy = obj2->pos_y + dy - pos_y;
+    c1 = cos(orientation);       s1 = sin(orientation);
+    c2 = cos(obj2->orientation); s2 = sin(obj2->orientation);
+    a  = cx*cx + cy*cy;
+    if(a == 0.0) return 1.0;
+
+    for(int i = 0; i < n1; i++){
+        at1 = the_topologies->atoms(o_type, i);
+        for(int j = 0; j < n2; j++){
+            at2 = the_topologies->atoms(t2, j);
+            hard = the_force->size(at1->type) + the_force->size(at2->type);
+            if(hard <= 0.0) continue;
+            ex = (- s2*at2->y_pos + c2*at2->x_pos)
+               - (- s1*at1->y_pos + c1*at1->x_pos);
+            ey = (  c2*at2->y_pos + s2*at2->x_pos)
+               - (  c1*at1->y_pos + s1*at1->x_pos);
+            b    = 2.0*(cx*ex + cy*ey);
+            c    = ex*ex + ey*ey - hard*hard;
+            disc = b*b - 4.0*a*c;
+            if(disc < 0.0) continue;
+            root = (-b + sqrt(disc))/(2.0*a);
+            if(root < 1.0) value = max(value, root);
+        }
+    }
+    return value;
+}
+
 /**
  * For non periodic boundary conditions need to calculate energy of interaction
  * with the box. This could be extended to have a central attractor for example.
@@ -7,6 +7,10 @@
  * @class   object object.h
  * \brief   An object in a configuration.
  *
+ * With periodic boundary conditions the position is kept inside the box, the
+ * image counters record how many times the object has crossed the box so the
+ * unwrapped position, pos_x + image_x * x_size, can be used to follow
+ * diffusion across the boundaries.
  */
 
 #ifndef OBJECT_H
@@ -25,6 +29,7 @@ public:
                  double y_size,
                  bool periodic);            ///< Move the object a random amount controlled by max_dist.
     void    rotate(double max_angle );      ///< Rotate the object a random amount controlled by max_angle.
+    void    wrap(double x_size, double y_size); ///< Put the object back in a periodic box, counting the crossings.
     int     write(FILE *dest);              ///< Write the object to a file
     double  distance(object *obj2, double x_size,
                      double y_size,
@@ -35,6 +40,14 @@ public:
     double  interaction(force_field *the_force,
                 topology *the_topology,
                 object *obj2);              ///< The energy of interaction with obj2
+    bool    core_overlap(force_field *the_force,
+                topology *the_topology,
+                object *obj2,
+                double dx, double dy);      ///< Do the hard cores overlap with obj2 shifted by dx, dy?
+    double  contact_scale(force_field *the_force,
+                topology *the_topology,
+                object *obj2,
+                double dx, double dy);      ///< Scale factor of the positions at which the hard cores touch obj2.
     double  box_energy(force_field *the_force,
                 topology *the_topology,
                 double x_size,
@@ -43,6 +56,7 @@ public:
     double  pos_x, pos_y;                   ///< Position of the object
     double  orientation;                    ///< Rotational orientation
     int     o_type;                         ///< Type of object determines atoms.
+    int     image_x, image_y;               ///< Periodic box crossings, + to the right (top).
 private:
     double  saved_energy;                   ///< Short cut if no need to recalculate
 };
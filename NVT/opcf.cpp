@@ -0,0 +1,166 @@
+/**
+ * @file    opcf.cpp
+ * @author  agent
+ * @date    October 17, 2026
+ *
+ * Implementation of the opcf analyzer that accumulates the orientation
+ * resolved pair correlation function during a simulation.
+ */
+
+#include <math.h>
+#include <thread>
+#include "opcf.h"
+#include "common.h"
+
+/**
+ * Constructor for the orientation resolved pair correlation analyzer.
+ *
+ * @param a_fname   The output file.
+ * @param range     The largest distance histogrammed.
+ * @param width     The distance bin width.
+ * @param angles    The number of bins for each angle.
+ * @param threads   The number of threads to use.
+ */
+opcf::opcf(const char *a_fname, double range, double width, int angles,
+           int threads) : analyzer("opcf", a_fname) {
+    assert(range > 0.0 && width > 0.0 && angles > 0);
+    r_max     = range;
+    dr        = width;
+    n_angle   = angles;
+    n_threads = max(threads, 1);
+    n_bins    = (int)ceil(r_max/dr);
+    n_types   = 0;
+}
+
+/**
+ * Destructor to destroy the analyzer.
+ */
+opcf::~opcf() {
+}
+
+/**
+ * @brief Wrap an angle into 0..2 pi and find its bin.
+ * @param angle The angle.
+ * @param n     The number of bins.
+ * @return      The bin.
+ */
+static int  angle_bin(double angle, int n){
+    int     b;
+
+    angle = fmod(angle, M_2PI);
+    if(angle < 0.0) angle += M_2PI;
+    b = (int)(angle*n/M_2PI);
+    return (b < n) ? b : n-1;
+}
+
+/**
+ * Histogram the ordered pairs whose first object is in first..last-1. Only
+ * reads the configuration and the grid so it can run in several threads at
+ * once with different maps.
+ *
+ * @param state     The configuration.
+ * @param grid      The filled spatial index.
+ * @param range     The largest distance.
+ * @param first     The first object.
+ * @param last      One past the last object.
+ * @param local     The map to add the counts to.
+ */
+void    opcf::count_pairs(config *state, cell_list *grid, double range,
+                          int first, int last, map<long, long> *local){
+    vector<int> found;
+    object  *obj1, *obj2;
+    double  dx, dy, r;
+    long    key;
+
+    for(int i = first; i < last; i++){
+        obj1 = state->get_object(i);
+        grid->neighbours(obj1->pos_x, obj1->pos_y, range, found);
+        for(unsigned int m = 0; m < found.size(); m++){
+            if(found[m] == i) continue;
+            obj2 = state->get_object(found[m]);
+            state->image_shift(obj1, obj2, &dx, &dy);
+            dx += obj2->pos_x - obj1->pos_x;
+            dy += obj2->pos_y - obj1->pos_y;
+            r = sqrt(dx*dx + dy*dy);
+            if(r >= range) continue;
+            key = obj1->o_type*n_types + obj2->o_type;
+            key = key*n_bins + (int)(r/dr);
+            key = key*n_angle + angle_bin(obj2->orientation - obj1->orientation,
+                                          n_angle);
+            key = key*n_angle + angle_bin(atan2(dy, dx) - obj1->orientation,
+                                          n_angle);
+            (*local)[key]++;
+        }
+    }
+}
+
+/**
+ * Histogram the ordered pairs of a configuration, the objects are shared
+ * between the threads and the partial histograms added at the end.
+ *
+ * @param state The configuration.
+ */
+void    opcf::sample(config *state){
+    int     n = state->n_objects();
+    double  range = r_max;
+    double  area = state->area();
+    int     n_t = min(n_threads, max(n, 1));
+    vector<int>     count;
+    vector<thread>  workers;
+    vector< map<long, long> >   local(n_t);
+    map<long, long>::iterator   it;
+
+    if(n_types == 0){
+        n_types = state->get_topology()->n_types();
+        norm.assign(n_types*n_types, 0.0);
+    }
+    count.assign(n_types, 0);
+    for(int i = 0; i < n; i++) count[state->get_object(i)->o_type]++;
+    for(int a = 0; a < n_types; a++)
+        for(int b = 0; b < n_types; b++)
+            norm[a*n_types+b] += count[a]*(count[b] - ((a == b) ? 1.0 : 0.0))/area;
+
+    if(state->periodic())                   // Minimum image limit
+        range = min(range, 0.5*min(state->x_size, state->y_size));
+    cell_list   grid(state->x_size, state->y_size, range, state->periodic());
+    state->fill_grid(&grid);
+
+    for(int t = 1; t < n_t; t++)            // Share the objects out
+        workers.push_back(thread(&opcf::count_pairs, this, state, &grid, range,
+                (t*n)/n_t, ((t+1)*n)/n_t, &local[t]));
+    count_pairs(state, &grid, range, 0, n/n_t, &local[0]);
+    for(unsigned int t = 0; t < workers.size(); t++) workers[t].join();
+
+    for(int t = 0; t < n_t; t++)            // Reduction
+        for(it = local[t].begin(); it != local[t].end(); ++it)
+            counts[it->first] += it->second;
+}
+
+/**
+ * Write the non empty bins of the normalized histogram.
+ *
+ * @param dest  The file, open for writing.
+ * @return      The return value of the last print statement.
+ */
+int     opcf::write(FILE *dest){
+    int     rc;
+    long    key;
+    int     k, b_theta, b_phi, p;
+    double  da = M_2PI/n_angle;
+    double  volume;
+    map<long, long>::iterator   it;
+
+    rc = fprintf(dest, "# type1 type2 r dtheta phi g count\n");
+    for(it = counts.begin(); it != counts.end(); ++it){
+        key = it->first;
+        b_phi   = key % n_angle; key /= n_angle;
+        b_theta = key % n_angle; key /= n_angle;
+        k       = key % n_bins;  key /= n_bins;
+        p       = key;
+        volume  = M_PI*dr*dr*(2*k+1)/(n_angle*n_angle)*norm[p];
+        rc = fprintf(dest, "%d %d %g %g %g %g %ld\n", p / n_types, p % n_types,
+                (k+0.5)*dr, (b_theta+0.5)*da, (b_phi+0.5)*da,
+                (volume > 0.0) ? it->second/volume : 0.0, it->second);
+    }
+    return rc;
+}
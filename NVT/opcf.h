@@ -0,0 +1,64 @@
+/**
+ * @file    opcf.h
+ * @author  agent
+ * @date    October 17, 2026
+ * \brief   Header file for the opcf class
+ *
+ * @class   opcf opcf.h
+ * @brief   Accumulates the orientation resolved pair correlation function.
+ *
+ * For anisotropic objects, like the squares, g(r) hides the relative
+ * arrangement of neighbours (face to face or corner contacts). This analyzer
+ * histograms, for each ordered pair of objects (1, 2) closer than r_max:
+ * * the distance r between the centers, in bins of width dr;
+ * * the relative orientation dtheta = theta_2 - theta_1;
+ * * the bearing phi of object 2 in the frame of object 1, the angle of the
+ *   vector from 1 to 2 minus theta_1;
+ * with n_angle bins for each angle over 0..2 pi, and separately for each
+ * ordered pair of object types. The pairs are found with a cell_list using
+ * the minimum image convention.
+ *
+ * High angular resolution gives many bins, most of them empty, so the counts
+ * are stored sparsely in a map keyed by the bin number. The objects are split
+ * between n_threads threads, each filling its own map, and the maps are added
+ * together at the end of the sample.
+ *
+ * The result is normalized so that it is 1 for uncorrelated objects:
+ *
+ *      g(r, dtheta, phi) = count / sum_samples(N_1 N_2 / A * shell(r) / n_angle^2)
+ *
+ * with N_2 replaced by N_1 - 1 for pairs of the same type. Only the non empty
+ * bins are written, one per line: the types, the bin centers (r, dtheta, phi),
+ * g and the raw count.
+ */
+
+#ifndef OPCF_H
+#define OPCF_H
+
+#include <vector>
+#include <map>
+#include "analyzer.h"
+
+using namespace std;
+
+class opcf : public analyzer {
+public:
+    opcf(const char *fname, double r_max, double dr,
+         int n_angle, int n_threads);       ///< Constructor with output file, range, bins and threads.
+    virtual ~opcf();                        ///< Destructor
+    virtual void    sample(config *state);  ///< Accumulate the histogram for one configuration.
+    virtual int     write(FILE *dest);      ///< Write the non empty bins.
+    double  r_max;                          ///< The range of the histogram.
+    double  dr;                             ///< The distance bin width.
+    int     n_angle;                        ///< Number of bins for each angle.
+    int     n_threads;                      ///< Number of threads used for a sample.
+private:
+    void    count_pairs(config *state, cell_list *grid, double range,
+                        int first, int last, map<long, long> *counts);  ///< Histogram the pairs of objects first..last-1.
+    int     n_bins;                         ///< Number of distance bins.
+    int     n_types;                        ///< Number of object types.
+    map<long, long>     counts;             ///< Sparse histogram.
+    vector<double>      norm;               ///< Accumulated N_1 N_2 / A for each ordered pair of types.
+};
+
+#endif /* OPCF_H */
@@ -0,0 +1,32 @@
+/**
+ * @file    options.cpp
+ * @author  agent
+ * @date    October 17, 2026
+ *
+ * Implementation of the parsing of command line option values.
+ */
+
+#include <stdlib.h>
+#include "options.h"
+
+/**
+ * @brief Parse a comma separated list of numbers.
+ *
+ * The list ends at the end of the string or at a '/', so several lists can
+ * follow one another.
+ *
+ * @param list  The list.
+ * @param value The numbers, appended.
+ * @return      After the list, NULL if it is not a list of numbers.
+ */
+const char  *parse_list(const char *list, vector<double> &value){
+    const char  *p = list;
+    char    *end;
+
+    while(*p && *p != '/'){
+        value.push_back(strtod(p, &end));
+        if(end == p) return (const char *)NULL;
+        p = (*end == ',') ? end + 1 : end;
+    }
+    return p;
+}
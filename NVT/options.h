@@ -0,0 +1,21 @@
+/**
+ * @file    options.h
+ * @author  agent
+ * @date    October 17, 2026
+ * @brief   Parsing of command line option values shared by the programmes.
+ *
+ * Options such as --sizes 100,400,1600 take a comma separated list of
+ * numbers. Several lists can follow one another separated by '/', as in
+ * --mix 1,0/0.7,0.3, each call of parse_list() reads one of them.
+ */
+
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+#include <vector>
+
+using namespace std;
+
+const char  *parse_list(const char *list, vector<double> &value);  ///< Parse a list, NULL if bad.
+
+#endif /* OPTIONS_H */
@@ -0,0 +1,233 @@
+/**
+ * @file    order.cpp
+ * @author  agent
+ * @date    October 17, 2026
+ *
+ * Implementation of the order analyzer that calculates the bond orientational
+ * and nematic order parameters during a simulation.
+ */
+
+#include <math.h>
+#include <algorithm>
+#include "order.h"
+#include "voronoi.h"
+#include "common.h"
+
+#define ORDER_NEAREST   6           // Neighbours kept when there is no range
+#define ORDER_SEARCH    8.0         // Objects expected in the first search
+
+/**
+ * Constructor for the order parameter analyzer.
+ *
+ * @param a_fname   The output file.
+ * @param a_range   The neighbour range, or 0 to use the nearest neighbours.
+ * @param voronoi_nbr   Use the Voronoi neighbours (the range is ignored).
+ */
+order::order(const char *a_fname, double a_range, bool voronoi_nbr)
+            : analyzer("order", a_fname) {
+    assert(a_range >= 0.0);
+    range   = a_range;
+    use_voronoi = voronoi_nbr;
+    n_types = 0;
+}
+
+/**
+ * Destructor to destroy the analyzer.
+ */
+order::~order() {
+}
+
+/**
+ * @brief Fill the neighbour lists of all the objects.
+ *
+ * With the Voronoi tessellation the neighbours are the objects whose cells
+ * share an edge. With a range the neighbours of an object are the objects
+ * closer than the range. Otherwise they are the ORDER_NEAREST nearest
+ * objects, sorted by distance. These are searched for within a distance that
+ * holds ORDER_SEARCH objects at the mean density, doubled for the objects
+ * with too few candidates.
+ *
+ * @param state The configuration.
+ */
+void    order::find_neighbours(config *state){
+    int     n = state->n_objects();
+    double  r_max, r_search, dx, dy, r2;
+    object  *obj1, *obj2;
+    vector<int> found;
+    vector< pair<double, int> > cand;
+    unsigned int    keep;
+
+    first.assign(1, 0);
+    nbr.clear();
+    if(use_voronoi){
+        voronoi cells((vector<double>()));
+        cells.build(state);
+        for(int i = 0; i < n; i++){
+            for(int k = 0; k < cells.n_neighbours(i); k++)
+                nbr.push_back(cells.neighbour(i, k));
+            first.push_back(nbr.size());
+        }
+        return;
+    }
+    r_max = state->periodic() ? 0.5*min(state->x_size, state->y_size)
+                              : sqrt(state->area());
+    r_search = (range > 0.0) ? min(range, r_max)
+             : min(r_max, sqrt(ORDER_SEARCH*state->area()/(M_PI*n)));
+    cell_list   grid(state->x_size, state->y_size, r_search, state->periodic());
+    state->fill_grid(&grid);
+
+    for(int i = 0; i < n; i++){
+        obj1 = state->get_object(i);
+        for(double r = r_search; ; r = min(2.0*r, r_max)){
+            cand.clear();
+            grid.neighbours(obj1->pos_x, obj1->pos_y, r, found);
+            for(unsigned int m = 0; m < found.size(); m++){
+                if(found[m] == i) continue;
+                obj2 = state->get_object(found[m]);
+                state->image_shift(obj1, obj2, &dx, &dy);
+                dx += obj2->pos_x - obj1->pos_x;
+                dy += obj2->pos_y - obj1->pos_y;
+                r2 = dx*dx + dy*dy;
+                if(r2 < r*r) cand.push_back(make_pair(r2, found[m]));
+            }
+            if(range > 0.0 || cand.size() >= ORDER_NEAREST || r >= r_max) break;
+        }
+        keep = cand.size();
+        if(range == 0.0){
+            keep = min(keep, (unsigned int)ORDER_NEAREST);
+            partial_sort(cand.begin(), cand.begin() + keep, cand.end());
+        }
+        for(unsigned int m = 0; m < keep; m++) nbr.push_back(cand[m].second);
+        first.push_back(nbr.size());
+    }
+}
+
+/**
+ * Calculate the local and global order parameters of a configuration and add
+ * the global values to the sums.
+ *
+ * @param state The configuration.
+ */
+void    order::sample(config *state){
+    int     n = state->n_objects();
+    int     n4, t;
+    object  *obj1, *obj2;
+    double  dx, dy, phi;
+    vector< complex<double> >   g6, g4, s2, s4;
+    vector<double>  l6, l4;
+
+    if(n_types == 0){
+        n_types = state->get_topology()->n_types();
+        sum.assign(6*n_types, 0.0);
+    }
+    find_neighbours(state);
+    psi6.assign(n, 0.0);
+    psi4.assign(n, 0.0);
+    type.resize(n);
+    pos_x.resize(n);
+    pos_y.resize(n);
+    count.assign(n_types, 0);
+    g6.assign(n_types, 0.0); g4.assign(n_types, 0.0);
+    s2.assign(n_types, 0.0); s4.assign(n_types, 0.0);
+    l6.assign(n_types, 0.0); l4.assign(n_types, 0.0);
+
+    for(int i = 0; i < n; i++){
+        obj1 = state->get_object(i);
+        n4 = (range > 0.0 || use_voronoi) ? first[i+1] - first[i]
+                                          : min(first[i+1] - first[i], 4);
+        for(int m = first[i]; m < first[i+1]; m++){
+            obj2 = state->get_object(nbr[m]);
+            state->image_shift(obj1, obj2, &dx, &dy);
+            phi = atan2(obj2->pos_y + dy - obj1->pos_y,
+                        obj2->pos_x + dx - obj1->pos_x);
+            psi6[i] += polar(1.0, 6.0*phi);
+            if(m - first[i] < n4) psi4[i] += polar(1.0, 4.0*phi);
+        }
+        if(first[i+1] > first[i]) psi6[i] /= (double)(first[i+1] - first[i]);
+        if(n4 > 0) psi4[i] /= (double)n4;
+
+        t = type[i] = obj1->o_type;
+        pos_x[i] = obj1->pos_x;
+        pos_y[i] = obj1->pos_y;
+        count[t]++;
+        g6[t] += psi6[i];
+        g4[t] += psi4[i];
+        l6[t] += abs(psi6[i]);
+        l4[t] += abs(psi4[i]);
+        s2[t] += polar(1.0, 2.0*obj1->orientation);
+        s4[t] += polar(1.0, 4.0*obj1->orientation);
+    }
+
+    last.assign(6*n_types, 0.0);
+    for(t = 0; t < n_types; t++){
+        if(count[t] == 0) continue;
+        last[6*t]   = abs(g6[t])/count[t];
+        last[6*t+1] = abs(g4[t])/count[t];
+        last[6*t+2] = l6[t]/count[t];
+        last[6*t+3] = l4[t]/count[t];
+        last[6*t+4] = abs(s2[t])/count[t];
+        last[6*t+5] = abs(s4[t])/count[t];
+        for(int k = 0; k < 6; k++) sum[6*t+k] += last[6*t+k];
+    }
+}
+
+/**
+ * Write the averages of the global values for each object type and the local
+ * order parameters of each object in the last sample.
+ *
+ * @param dest  The file, open for writing.
+ * @return      The return value of the last print statement.
+ */
+int     order::write(FILE *dest){
+    int     rc;
+
+    rc = fprintf(dest, "# type psi6 psi4 local6 local4 S2 S4\n");
+    for(int t = 0; t < n_types; t++){
+        rc = fprintf(dest, "%d", t);
+        for(int k = 0; k < 6; k++)
+            rc = fprintf(dest, " %g", (n_samples > 0) ? sum[6*t+k]/n_samples : 0.0);
+        rc = fprintf(dest, "\n");
+    }
+    rc = fprintf(dest, "\n# index type x y psi6 arg6 psi4 arg4\n");
+    for(unsigned int i = 0; i < psi6.size(); i++)
+        rc = fprintf(dest, "%d %d %g %g %g %g %g %g\n", i, type[i],
+                pos_x[i], pos_y[i], abs(psi6[i]), arg(psi6[i]),
+                abs(psi4[i]), arg(psi4[i]));
+    return rc;
+}
+
+/**
+ * Write the global values of the last sample to the log, one line for each
+ * object type present.
+ *
+ * @param the_log   The log file.
+ * @return          The number of lines written.
+ */
+int     order::log(FILE *the_log){
+    int     n_lines = 0;
+
+    for(unsigned int t = 0; t < count.size(); t++){
+        if(count[t] == 0) continue;
+        fprintf(the_log, "Order type %d: psi6 = %g psi4 = %g local6 = %g "
+                "local4 = %g S2 = %g S4 = %g\n", t, last[6*t], last[6*t+1],
+                last[6*t+2], last[6*t+3], last[6*t+4], last[6*t+5]);
+        n_lines++;
+    }
+    return n_lines;
+}
+
+/**
+ * The global hexagonal order |<psi_6>| of the first object type present in
+ * the last sample.
+ *
+ * @param value Set to the value.
+ * @return      True if there has been a sample.
+ */
+bool    order::scalar(double *value){
+    for(unsigned int t = 0; t < count.size(); t++){
+        if(count[t] == 0) continue;
+        *value = last[6*t];
+        return true;
+    }
+    return false;
+}
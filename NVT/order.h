@@ -0,0 +1,75 @@
+/**
+ * @file    order.h
+ * @author  agent
+ * @date    October 17, 2026
+ * \brief   Header file for the order class
+ *
+ * @class   order order.h
+ * @brief   Bond orientational and nematic order parameters.
+ *
+ * For each object j the local bond orientational order parameters
+ *
+ *      psi_n(j) = 1/N_j sum_k exp(i n phi_jk)       n = 6 and 4
+ *
+ * are calculated, where the sum is over the N_j neighbours k of j and phi_jk
+ * is the angle of the vector from j to k. psi_6 measures hexagonal order (the
+ * hexatic and solid phases of the discs) and psi_4 square order. The
+ * neighbours are either all the objects closer than a range, the neighbours
+ * in the Voronoi tessellation (see voronoi), or if neither is chosen the six
+ * nearest objects for psi_6 and the four nearest for psi_4. They are found
+ * with a cell_list.
+ *
+ * The orientational order of the objects themselves is measured by
+ *
+ *      S_m = | 1/N sum_j exp(i m theta_j) |          m = 2 and 4
+ *
+ * where theta_j is the orientation of object j, S_2 is the nematic order
+ * parameter and S_4 the tetratic order, which is the one to use for the
+ * squares whose orientation is only defined modulo 90 degrees.
+ *
+ * For each object type the global values |<psi_6>| and |<psi_4>| (the modulus
+ * of the mean), the means <|psi_6|> and <|psi_4|> (the local order) and S_2,
+ * S_4 are averaged over the samples. The values of the last sample are
+ * written to the log at each report, one line per object type present:
+ *
+ *      Order type t: psi6 = .. psi4 = .. local6 = .. local4 = .. S2 = .. S4 = ..
+ *
+ * The output file has the averages, one line per type, followed by the local
+ * fields of the last sample, one line per object (index, type, position,
+ * modulus and phase of psi_6 and psi_4) for rendering.
+ */
+
+#ifndef ORDER_H
+#define ORDER_H
+
+#include <vector>
+#include <complex>
+#include "analyzer.h"
+
+using namespace std;
+
+class order : public analyzer {
+public:
+    order(const char *fname, double range,
+          bool use_voronoi);                ///< Constructor with the output file and neighbour choice.
+    virtual ~order();                       ///< Destructor
+    virtual void    sample(config *state);  ///< Calculate the order parameters of one configuration.
+    virtual int     write(FILE *dest);      ///< Write the averages and the local fields.
+    virtual int     log(FILE *the_log);     ///< Write the values of the last sample.
+    virtual bool    scalar(double *value);  ///< |<psi_6>| of the first type present.
+    double  range;                          ///< Neighbour range, 0 for the nearest neighbours.
+    bool    use_voronoi;                    ///< Use the Voronoi neighbours.
+private:
+    void    find_neighbours(config *state); ///< Fill the neighbour lists.
+    int     n_types;                        ///< Number of object types.
+    vector<int>     first;                  ///< Start of the neighbours of each object in nbr.
+    vector<int>     nbr;                    ///< Neighbour lists, nearest first for the nearest neighbours.
+    vector< complex<double> >   psi6, psi4; ///< Local order of each object in the last sample.
+    vector<int>     type;                   ///< Type of each object in the last sample.
+    vector<double>  pos_x, pos_y;           ///< Position of each object in the last sample.
+    vector<int>     count;                  ///< Number of objects of each type in the last sample.
+    vector<double>  last;                   ///< Global values of the last sample, 6 per type.
+    vector<double>  sum;                    ///< Sums of the global values over the samples.
+};
+
+#endif /* ORDER_H */
@@ -0,0 +1,139 @@
+/**
+ * @file    placer.cpp
+ * @author  agent
+ * @date    October 17, 2026
+ *
+ * Implementation of the placer that makes overlap free configurations by
+ * random sequential adsorption.
+ */
+
+#include <stdlib.h>
+#include <math.h>
+#include "placer.h"
+#include "common.h"
+
+/**
+ * Constructor function that takes as parameters the force field that gives
+ * the hard core sizes of the atoms and the number of trials to place an
+ * object.
+ *
+ * @param forces    The force field.
+ * @param attempts  The number of trials for each object.
+ */
+placer::placer(force_field *forces, int attempts) {
+    the_forces   = forces;
+    max_attempts = attempts;
+    n_placed     = 0;
+    covered      = 0.0;
+    wanted       = 0.0;
+}
+
+/**
+ * Destructor to destroy a placer.
+ */
+placer::~placer() {
+}
+
+/**
+ * @brief The area covered by the atoms of an object.
+ * @param the_topology  The object topologies.
+ * @param type          The object type.
+ * @return              The sum of the areas of the atom hard cores.
+ */
+double  placer::area(topology *the_topology, int type){
+    double  r, value = 0.0;
+
+    for(int j = 0; j < the_topology->n_atom(type); j++){
+        r = the_forces->size(the_topology->atoms(type, j)->type);
+        if(r > 0.0) value += M_PI*r*r;
+    }
+    return value;
+}
+
+/**
+ * @brief Place the objects by random sequential adsorption.
+ *
+ * For each object in turn random poses are tried until one is found that
+ * does not overlap the objects already placed. If no pose is found in
+ * max_attempts trials the placement stops, n_placed gives the objects
+ * placed and the next one, types[n_placed], is the one that did not fit.
+ *
+ * @param state     The configuration to fill, with its topology.
+ * @param types     The types of the objects to place, in order.
+ * @param grid      A spatial index holding the objects of the configuration.
+ * @return          True if all the objects were placed.
+ */
+bool    placer::place(config *state, vector<int> &types, cell_list *grid){
+    topology    *the_topology = state->get_topology();
+    object  *candidate = (object *)NULL;
+    double  pos_x = 0.0, pos_y = 0.0, orient;
+    int     attempt;
+
+    n_placed = 0;
+    covered  = 0.0;
+    wanted   = 0.0;
+    for(unsigned int j = 0; j < types.size(); j++)
+        wanted += area(the_topology, types[j]);
+
+    for(unsigned int j = 0; j < types.size(); j++){
+        for(attempt = 0; attempt < max_attempts; attempt++){
+            pos_x  = rnd_lin(state->x_size);
+            pos_y  = rnd_lin(state->y_size);
+            orient = rnd_lin(M_2PI);
+            candidate = new object( types[j], pos_x, pos_y, orient );
+            if(!state->overlap(the_forces, candidate, -1, grid)) break;
+            delete candidate;
+        }
+        if(attempt == max_attempts) return false;   // Jammed
+        grid->insert(state->n_objects(), pos_x, pos_y);
+        state->add_object( candidate );
+        covered += area(the_topology, types[j]);
+        n_placed++;
+    }
+    return true;
+}
+
+/**
+ * @brief Make a periodic square configuration by random sequential adsorption.
+ *
+ * The numbers of objects of each type are in the given proportions, they
+ * are placed in a random order and the box is sized so their atom hard
+ * cores cover the packing fraction of its area.
+ *
+ * @param the_topology  The object topologies, copied into the configuration.
+ * @param n             The number of objects.
+ * @param packing       The packing fraction.
+ * @param mix           The proportions of the object types.
+ * @return              The configuration, NULL if it jammed.
+ */
+config  *placer::generate(topology *the_topology, int n, double packing,
+                          vector<double> &mix){
+    config  *state = new config();
+    cell_list   *grid;
+    vector<int> types;
+    double  sum = 0.0, total = 0.0, side;
+    bool    done;
+
+    for(unsigned int t = 0; t < mix.size(); t++) total += mix[t];
+    for(unsigned int t = 0, k = 0; t < mix.size(); t++){
+        sum += mix[t];                      // Cumulated proportions
+        for(; k < (unsigned int)lround(n*sum/total); k++) types.push_back(t);
+    }
+    sum = 0.0;
+    for(unsigned int j = 0; j < types.size(); j++){
+        sum += area(the_topology, types[j]);
+        swap(types[j], types[rand() % (j+1)]);
+    }
+    side = sqrt(sum/packing);
+    state->x_size = state->y_size = side;
+    state->set_periodic(true);
+    state->add_topology(new topology(the_topology));
+    grid = new cell_list(side, side, 2.0*state->reach(the_forces), true);
+    done = place(state, types, grid);
+    delete grid;
+    if(!done){
+        delete state;
+        return (config *)NULL;
+    }
+    return state;
+}
@@ -0,0 +1,49 @@
+/**
+ * @file    placer.h
+ * @author  agent
+ * @date    October 17, 2026
+ * \brief   Header file for the placer class
+ *
+ * @class   placer placer.h
+ * @brief   Places objects without overlaps by random sequential adsorption.
+ *
+ * For each object in turn random positions and orientations are tried until
+ * one is found where its atoms do not overlap the hard cores of the atoms of
+ * the objects already placed (using the topology and the force field radii).
+ * The neighbours are found through a cell_list so the placement takes a time
+ * proportional to the number of objects. If an object cannot be placed in the
+ * allowed number of attempts the density is beyond what random sequential
+ * adsorption can reach, the placement stops and the number of objects placed
+ * and the area they cover are available for reporting.
+ *
+ * The placer is used by makeconfig to fill a given box, and by the bench and
+ * scaling programs to generate, from a number of objects, a packing fraction
+ * (the area of the atom hard cores over the box area) and the proportions of
+ * the object types, a periodic square configuration.
+ */
+
+#ifndef PLACER_H
+#define PLACER_H
+
+#include <vector>
+#include "config.h"
+
+using namespace std;
+
+class placer {
+public:
+    placer(force_field *the_forces, int max_attempts);  ///< Constructor with force field and trials per object
+    virtual ~placer();                      ///< Destructor
+    double  area(topology *the_topology, int type); ///< Area of the atom hard cores of an object.
+    bool    place(config *state, vector<int> &types, cell_list *grid); ///< Place the objects, false if jammed.
+    config  *generate(topology *the_topology, int n, double packing,
+                      vector<double> &mix); ///< New periodic configuration, NULL if jammed.
+    int     max_attempts;                   ///< Trials to place an object.
+    int     n_placed;                       ///< Objects placed by the last placement.
+    double  covered;                        ///< Area covered by the objects placed.
+    double  wanted;                         ///< Area of all the objects to place.
+private:
+    force_field *the_forces;
+};
+
+#endif /* PLACER_H */
@@ -0,0 +1,134 @@
+/**
+ * @file    rdf.cpp
+ * @author  agent
+ * @date    October 17, 2026
+ *
+ * Implementation of the rdf analyzer that accumulates the radial distribution
+ * function during a simulation.
+ */
+
+#include <math.h>
+#include "rdf.h"
+#include "common.h"
+
+/**
+ * Constructor for the radial distribution function analyzer.
+ *
+ * @param a_fname   The output file.
+ * @param range     The largest distance histogrammed.
+ * @param width     The bin width.
+ */
+rdf::rdf(const char *a_fname, double range, double width)
+        : analyzer("rdf", a_fname) {
+    assert(range > 0.0 && width > 0.0);
+    r_max   = range;
+    dr      = width;
+    n_bins  = (int)ceil(r_max/dr);
+    n_types = 0;
+    total.assign(n_bins, 0.0);
+}
+
+/**
+ * Destructor to destroy the analyzer.
+ */
+rdf::~rdf() {
+}
+
+/**
+ * Set up empty partial histograms for the pairs of object types.
+ * @param n The number of object types.
+ */
+void    rdf::resize(int n){
+    n_types = n;
+    partial.assign(n*(n+1)/2, vector<double>(n_bins, 0.0));
+}
+
+/**
+ * Histogram the pair distances of a configuration. Each unordered pair closer
+ * than r_max is found once through the cell_list and counts for the two
+ * ordered pairs.
+ *
+ * @param state The configuration.
+ */
+void    rdf::sample(config *state){
+    int     n = state->n_objects();
+    double  range = r_max;
+    double  area = state->area();
+    double  dx, dy, r, shell;
+    int     i, j, k, a, b, p;
+    object  *obj1, *obj2;
+    vector<int>     count;
+    vector<double>  hist_total(n_bins, 0.0);
+    vector< vector<double> > hist;
+
+    if(n_types == 0) resize(state->get_topology()->n_types());
+    hist.assign(partial.size(), vector<double>(n_bins, 0.0));
+    count.assign(n_types, 0);
+    for(i = 0; i < n; i++) count[state->get_object(i)->o_type]++;
+
+    if(state->periodic())                   // Minimum image limit
+        range = min(range, 0.5*min(state->x_size, state->y_size));
+    cell_list   grid(state->x_size, state->y_size, range, state->periodic());
+    state->fill_grid(&grid);
+
+    for(i = 0; i < n; i++){
+        obj1 = state->get_object(i);
+        grid.neighbours(obj1->pos_x, obj1->pos_y, range, found);
+        for(unsigned int m = 0; m < found.size(); m++){
+            j = found[m];
+            if(j <= i) continue;            // Each pair once
+            obj2 = state->get_object(j);
+            state->image_shift(obj1, obj2, &dx, &dy);
+            dx += obj2->pos_x - obj1->pos_x;
+            dy += obj2->pos_y - obj1->pos_y;
+            r = sqrt(dx*dx + dy*dy);
+            if(r >= range) continue;
+            k = (int)(r/dr);
+            a = min(obj1->o_type, obj2->o_type);
+            b = max(obj1->o_type, obj2->o_type);
+            p = a*n_types - a*(a-1)/2 + b - a;
+            hist_total[k] += 2.0;           // Both ordered pairs
+            hist[p][k]    += (a == b) ? 2.0 : 1.0;
+        }
+    }
+
+    for(k = 0; k < n_bins; k++){            // Normalize and accumulate
+        shell = M_PI*dr*dr*(2*k+1);
+        if(n > 1) total[k] += area*hist_total[k]/(n*(n-1.0)*shell);
+        for(a = 0; a < n_types; a++){
+            for(b = a; b < n_types; b++){
+                p = a*n_types - a*(a-1)/2 + b - a;
+                if(a == b && count[a] > 1)
+                    partial[p][k] += area*hist[p][k]
+                            /(count[a]*(count[a]-1.0)*shell);
+                if(a != b && count[a] > 0 && count[b] > 0)
+                    partial[p][k] += area*hist[p][k]
+                            /((double)count[a]*count[b]*shell);
+            }
+        }
+    }
+}
+
+/**
+ * Write the g(r) averaged over the samples.
+ *
+ * @param dest  The file, open for writing.
+ * @return      The return value of the last print statement.
+ */
+int     rdf::write(FILE *dest){
+    int     rc;
+    double  norm = (n_samples > 0) ? 1.0/n_samples : 0.0;
+
+    fprintf(dest, "# r total");
+    for(int a = 0; a < n_types; a++)
+        for(int b = a; b < n_types; b++)
+            fprintf(dest, " %d-%d", a, b);
+    rc = fprintf(dest, "\n");
+    for(int k = 0; k < n_bins; k++){
+        fprintf(dest, "%g %g", (k+0.5)*dr, norm*total[k]);
+        for(unsigned int p = 0; p < partial.size(); p++)
+            fprintf(dest, " %g", norm*partial[p][k]);
+        rc = fprintf(dest, "\n");
+    }
+    return rc;
+}
@@ -0,0 +1,55 @@
+/**
+ * @file    rdf.h
+ * @author  agent
+ * @date    October 17, 2026
+ * \brief   Header file for the rdf class
+ *
+ * @class   rdf rdf.h
+ * @brief   Accumulates the radial distribution function during a simulation.
+ *
+ * The radial distribution function g(r) of the object centers is histogrammed
+ * in bins of width dr up to r_max, for all the objects and for each pair of
+ * object types (the partial g(r)). The pairs closer than r_max are found with
+ * a cell_list and the distances use the minimum image convention, so r_max is
+ * limited to half the smallest box side.
+ *
+ * Each sample is normalized with the area of the box (config::area()) and the
+ * number of objects of each type:
+ *
+ *      g_ab(r) = A n_ab(r) / (N_a N_b 2 pi r dr)
+ *
+ * where n_ab(r) is the number of ordered pairs (an object of type a and one of
+ * type b) in the bin and N_b is replaced by N_a - 1 when a = b. The result is
+ * the average over the samples.
+ *
+ * The output has a comment line naming the columns followed by one line per
+ * bin: the bin center, the total g(r) and the partial g(r) for the pairs of
+ * types 0-0, 0-1, ... 1-1, ...
+ */
+
+#ifndef RDF_H
+#define RDF_H
+
+#include <vector>
+#include "analyzer.h"
+
+using namespace std;
+
+class rdf : public analyzer {
+public:
+    rdf(const char *fname, double r_max, double dr);    ///< Constructor with the output file, range and bin width.
+    virtual ~rdf();                         ///< Destructor
+    virtual void    sample(config *state);  ///< Accumulate g(r) for one configuration.
+    virtual int     write(FILE *dest);      ///< Write the averaged g(r).
+    double  r_max;                          ///< The range of the histogram.
+    double  dr;                             ///< The bin width.
+private:
+    void    resize(int n_types);            ///< Set up the histograms for a number of types.
+    int     n_bins;                         ///< Number of bins.
+    int     n_types;                        ///< Number of object types.
+    vector<double>  total;                  ///< Accumulated total g(r).
+    vector< vector<double> > partial;       ///< Accumulated g(r) for each pair of types a <= b.
+    vector<int>     found;                  ///< Work space for neighbour searches.
+};
+
+#endif /* RDF_H */
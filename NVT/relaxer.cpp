@@ -0,0 +1,280 @@
+/**
+ * @file    relaxer.cpp
+ * @author  agent
+ * @date    October 17, 2026
+ *
+ * Implementation of the relaxer that removes hard core overlaps from a
+ * configuration by FIRE minimization of a harmonic overlap penalty.
+ */
+
+#include <math.h>
+#include <time.h>
+#include <vector>
+#include "relaxer.h"
+#include "common.h"
+
+#define FIRE_DT         0.1         // Initial time step
+#define FIRE_DT_MAX     1.0         // Largest time step
+#define FIRE_N_MIN      5           // Steps downhill before accelerating
+#define FIRE_INC        1.1         // Time step increase
+#define FIRE_DEC        0.5         // Time step decrease
+#define FIRE_ALPHA      0.1         // Initial velocity mixing
+#define FIRE_F_ALPHA    0.99        // Mixing decrease
+#define FIRE_STALL      100         // Iterations without progress before a kick
+
+/**
+ * Constructor function that takes as a parameter the force field that gives
+ * the hard core sizes of the atoms.
+ *
+ * @param forces The force field.
+ */
+relaxer::relaxer(force_field *forces) {
+    the_forces = forces;
+    n_overlap  = 0;
+    n_iter     = 0;
+    seconds    = 0.0;
+    max_step   = 0.2;
+    skin       = 0.01;
+}
+
+/**
+ * Destructor to destroy a relaxer.
+ */
+relaxer::~relaxer() {
+}
+
+/**
+ * @brief Overlap penalty and forces between two objects.
+ *
+ * For each pair of atoms closer than their hard core distance plus the skin
+ * the penalty (h - r)^2/2 is added, where h is the enlarged hard core
+ * distance, and the corresponding force is added to the force and torque on
+ * obj1.
+ *
+ * @param the_topology  The object topologies.
+ * @param obj1      The object the forces act on.
+ * @param obj2      The other object.
+ * @param dx        Shift to apply to obj2 (periodic image).
+ * @param dy        Shift to apply to obj2 in y.
+ * @param fx        Force in x, added to.
+ * @param fy        Force in y, added to.
+ * @param torque    Torque, added to.
+ * @param core      Set to true if there is a hard core overlap.
+ * @return          The penalty.
+ */
+double  relaxer::pair_force(topology *the_topology, object *obj1, object *obj2,
+                            double dx, double dy, double *fx, double *fy,
+                            double *torque, bool *core){
+    atom    *at1, *at2;
+    double  c1, s1, c2, s2;
+    double  rx1, ry1, x2, y2;
+    double  ex, ey, r, hard, h, f;
+    double  value = 0.0;
+
+    c1 = cos(obj1->orientation); s1 = sin(obj1->orientation);
+    c2 = cos(obj2->orientation); s2 = sin(obj2->orientation);
+    for(int i = 0; i < the_topology->n_atom(obj1->o_type); i++){
+        at1 = the_topology->atoms(obj1->o_type, i);
+        rx1 = c1*at1->x_pos - s1*at1->y_pos;    // Atom relative to center
+        ry1 = s1*at1->x_pos + c1*at1->y_pos;
+        for(int j = 0; j < the_topology->n_atom(obj2->o_type); j++){
+            at2  = the_topology->atoms(obj2->o_type, j);
+            hard = the_forces->size(at1->type) + the_forces->size(at2->type);
+            if(hard <= 0.0) continue;
+            h  = hard*(1.0 + skin);
+            x2 = obj2->pos_x + dx + c2*at2->x_pos - s2*at2->y_pos;
+            y2 = obj2->pos_y + dy + s2*at2->x_pos + c2*at2->y_pos;
+            ex = obj1->pos_x + rx1 - x2;
+            ey = obj1->pos_y + ry1 - y2;
+            r  = ex*ex + ey*ey;
+            if(r >= h*h) continue;
+            r  = sqrt(r);
+            if(r < hard) *core = true;
+            if(r == 0.0){ ex = 1.0; ey = 0.0; r = 1.0; }  // Arbitrary direction
+            value += 0.5*(h-r)*(h-r);
+            f   = (h-r)/r;
+            *fx += f*ex;
+            *fy += f*ey;
+            *torque += rx1*f*ey - ry1*f*ex;
+        }
+    }
+    return value;
+}
+
+/**
+ * @brief Remove the hard core overlaps from a configuration.
+ *
+ * The overlapping objects are found with a cell_list and relaxed with FIRE
+ * until no hard core overlap remains. Objects are only moved while they are
+ * within the skin of another object. The configuration is modified in place
+ * and, if anything moved, the energies of all the objects are marked for
+ * recalculation, as the neighbours of the moved objects have cached energies
+ * that count interactions with their old positions.
+ *
+ * @param state     The configuration (with a topology).
+ * @param max_iter  The largest number of iterations.
+ * @return          The number of iterations made or -1 if overlaps remain.
+ */
+int     relaxer::run(config *state, int max_iter){
+    int         n = state->n_objects();
+    topology    *the_topology = state->get_topology();
+    double      reach = state->reach(the_forces)*(1.0 + skin);
+    cell_list   grid(state->x_size, state->y_size, 2.0*reach, state->periodic());
+    vector<double>  vx(n, 0.0), vy(n, 0.0), w(n, 0.0);
+    vector<double>  fx(n, 0.0), fy(n, 0.0), tq(n, 0.0);
+    vector<double>  inertia;
+    vector<char>    in_active(n, 0), stuck(n, 0);
+    vector<int>     active, next, found;
+    clock_t     start = clock();
+    object      *obj1, *obj2;
+    double      dx, dy, step, power, v_norm, f_norm, mix, dt, alpha;
+    double      e_x, e_y, e_t;
+    int         n_pos, n_core, best, n_stall;
+    bool        core, any_core;
+    atom        *at;
+
+    for(int t = 0; t < the_topology->n_types(); t++){    // Moments of inertia
+        inertia.push_back(0.0);
+        for(int j = 0; j < the_topology->n_atom(t); j++){
+            at = the_topology->atoms(t, j);
+            inertia[t] += at->x_pos*at->x_pos + at->y_pos*at->y_pos;
+        }
+    }
+
+    state->fill_grid(&grid);                // Start with the overlapping objects
+    for(int i = 0; i < n; i++){
+        if(state->overlap(the_forces, state->get_object(i), i, &grid)){
+            active.push_back(i);
+            in_active[i] = 1;
+        }
+    }
+    n_overlap = active.size();
+
+    dt = FIRE_DT; alpha = FIRE_ALPHA; n_pos = 0;
+    best = n_overlap; n_stall = 0;
+    for(n_iter = 0; n_iter < max_iter; n_iter++){
+        n_core = 0;                         // Forces on the active objects
+        for(unsigned int k = 0; k < active.size(); k++){
+            int i = active[k];
+            obj1 = state->get_object(i);
+            fx[i] = fy[i] = tq[i] = 0.0;
+            any_core = false;
+            grid.neighbours(obj1->pos_x, obj1->pos_y, 2.0*reach, found);
+            for(unsigned int m = 0; m < found.size(); m++){
+                if(found[m] == i) continue;
+                obj2 = state->get_object(found[m]);
+                state->image_shift(obj1, obj2, &dx, &dy);
+                core = false;
+                pair_force(the_topology, obj1, obj2, dx, dy,
+                           &fx[i], &fy[i], &tq[i], &core);
+                any_core = any_core || core;
+            }
+            stuck[i] = any_core;
+            if(any_core) n_core++;
+        }
+        if(n_core == 0) break;              // No overlaps left
+        if(n_core < best){ best = n_core; n_stall = 0; }
+        else if(++n_stall > FIRE_STALL){    // Trapped, kick the overlapping
+            for(unsigned int k = 0; k < active.size(); k++){    // objects
+                int i = active[k];
+                vx[i] = vy[i] = w[i] = 0.0;
+                if(!stuck[i]) continue;
+                obj1 = state->get_object(i);
+                obj1->pos_x += rnd_lin(2.0*reach) - reach;
+                obj1->pos_y += rnd_lin(2.0*reach) - reach;
+                obj1->orientation += rnd_lin(M_2PI);
+                fx[i] = fy[i] = 1.0;        // Stays active
+            }
+            dt = FIRE_DT; alpha = FIRE_ALPHA; n_pos = 0;
+            best = n_core; n_stall = 0;
+        }
+
+        power = v_norm = f_norm = 0.0;      // FIRE velocity mixing
+        for(unsigned int k = 0; k < active.size(); k++){
+            int i = active[k];
+            e_t = inertia[state->get_object(i)->o_type];
+            power  += fx[i]*vx[i] + fy[i]*vy[i] + tq[i]*w[i];
+            v_norm += vx[i]*vx[i] + vy[i]*vy[i] + e_t*w[i]*w[i];
+            f_norm += fx[i]*fx[i] + fy[i]*fy[i]
+                      + ((e_t > 0.0) ? tq[i]*tq[i]/e_t : 0.0);
+        }
+        v_norm = sqrt(v_norm);
+        f_norm = sqrt(f_norm);
+        mix = (f_norm > 0.0) ? alpha*v_norm/f_norm : 0.0;
+        for(unsigned int k = 0; k < active.size(); k++){
+            int i = active[k];
+            vx[i] = (1.0-alpha)*vx[i] + mix*fx[i];
+            vy[i] = (1.0-alpha)*vy[i] + mix*fy[i];
+            w[i]  = (1.0-alpha)*w[i]  + mix*tq[i];
+        }
+        if(power > 0.0){
+            if(++n_pos > FIRE_N_MIN){
+                dt = min(dt*FIRE_INC, FIRE_DT_MAX);
+                alpha *= FIRE_F_ALPHA;
+            }
+        } else {
+            n_pos = 0;
+            dt   *= FIRE_DEC;
+            alpha = FIRE_ALPHA;
+            for(unsigned int k = 0; k < active.size(); k++){
+                int i = active[k];
+                vx[i] = vy[i] = w[i] = 0.0;
+            }
+        }
+
+        next.clear();                       // Move and find the next active set
+        for(unsigned int k = 0; k < active.size(); k++){
+            int i = active[k];
+            obj1 = state->get_object(i);
+            e_t  = inertia[obj1->o_type];
+            if(fx[i] == 0.0 && fy[i] == 0.0 && tq[i] == 0.0){
+                vx[i] = vy[i] = w[i] = 0.0; // Free, leaves the relaxation
+                in_active[i] = 0;
+                continue;
+            }
+            next.push_back(i);
+            vx[i] += fx[i]*dt;
+            vy[i] += fy[i]*dt;
+            w[i]   = (e_t > 0.0) ? w[i] + tq[i]*dt/e_t : 0.0;
+            e_x = vx[i]*dt;
+            e_y = vy[i]*dt;
+            step = sqrt(e_x*e_x + e_y*e_y);
+            if(step > max_step){ e_x *= max_step/step; e_y *= max_step/step; }
+            obj1->pos_x += e_x;
+            obj1->pos_y += e_y;
+            obj1->orientation += max(-max_step, min(max_step, w[i]*dt));
+            if(state->periodic()) obj1->wrap(state->x_size, state->y_size);
+            obj1->orientation = fmod(obj1->orientation, M_2PI);
+            if(obj1->orientation < 0.0) obj1->orientation += M_2PI;
+            obj1->recalculate = true;
+            grid.update(i, obj1->pos_x, obj1->pos_y);
+        }
+        active.swap(next);
+        for(unsigned int k = 0, n_moved = active.size(); k < n_moved; k++){
+            obj1 = state->get_object(active[k]);    // Objects pushed into
+            grid.neighbours(obj1->pos_x, obj1->pos_y, 2.0*reach, found);
+            for(unsigned int m = 0; m < found.size(); m++){ // contact join.
+                int j = found[m];
+                if(in_active[j]) continue;
+                obj2 = state->get_object(j);
+                state->image_shift(obj1, obj2, &dx, &dy);
+                e_x = e_y = e_t = 0.0;
+                core = false;
+                if(pair_force(the_topology, obj1, obj2, dx, dy,
+                              &e_x, &e_y, &e_t, &core) > 0.0){
+                    active.push_back(j);
+                    in_active[j] = 1;
+                    vx[j] = vy[j] = w[j] = 0.0;
+                }
+            }
+        }
+    }
+
+    if(n_iter > 0){                         // Moved objects and their old and
+        for(int i = 0; i < n; i++)          // new neighbours
+            state->get_object(i)->recalculate = true;
+        state->unchanged = false;
+    }
+    seconds = (double)(clock()-start)/CLOCKS_PER_SEC;
+    return (n_iter < max_iter) ? n_iter : -1;
+}
@@ -0,0 +1,55 @@
+/**
+ * @file    relaxer.h
+ * @author  agent
+ * @date    October 17, 2026
+ * \brief   Header file for the relaxer class
+ *
+ * @class   relaxer relaxer.h
+ * @brief   Removes the hard core overlaps from a configuration.
+ *
+ * A configuration read from a file, or made by placing objects at random, can
+ * contain hard core overlaps that give it a huge energy. Before starting the
+ * Monte Carlo integration these overlaps are removed by the relaxer.
+ *
+ * Only the objects involved in overlaps, found through a cell_list, are moved.
+ * They are pushed apart with the FIRE minimization algorithm (Bitzek et al.
+ * 2006) applied to the object positions and orientations. The force field core
+ * penalty is linear in the overlap with a huge slope, which makes the step size
+ * impossible to control, so the relaxer uses a harmonic penalty with the same
+ * directions that acts between atoms closer than their hard core distance plus
+ * a small skin. The relaxation stops as soon as no hard core overlap remains,
+ * objects that are pushed into new overlaps join the relaxation.
+ *
+ * Some arrangements are local minima of the penalty that still overlap, for
+ * example a disc in the middle of a square where the pushes from the four
+ * corners cancel. When the number of overlapping objects stops decreasing the
+ * overlapping objects are given a small random kick and the relaxation
+ * restarts.
+ *
+ * After a run the number of objects that overlapped at the start, the number
+ * of iterations and the time taken are available for reporting.
+ */
+
+#ifndef RELAXER_H
+#define RELAXER_H
+
+#include "config.h"
+
+class relaxer {
+public:
+    relaxer(force_field *the_forces);       ///< Constructor with force field
+    virtual ~relaxer();                     ///< Destructor
+    int     run(config *state, int max_iter);   ///< Remove the overlaps, returns the iterations or -1
+    int     n_overlap;                      ///< Objects overlapping at the start of the last run.
+    int     n_iter;                         ///< Iterations made in the last run.
+    double  seconds;                        ///< Processor time taken by the last run.
+    double  max_step;                       ///< Largest displacement in one iteration.
+    double  skin;                           ///< Relative margin added to the hard core distance.
+private:
+    double  pair_force(topology *the_topology, object *obj1, object *obj2,
+                       double dx, double dy, double *fx, double *fy,
+                       double *torque, bool *core);  ///< Penalty and forces on obj1 from obj2.
+    force_field *the_forces;
+};
+
+#endif /* RELAXER_H */
@@ -0,0 +1,99 @@
+/**
+ * @file    sampling.cpp
+ * @author  agent
+ * @date    October 17, 2026
+ *
+ * Implementation of the sampling analyzer that estimates the effective number
+ * of samples of a run.
+ */
+
+#include <math.h>
+#include "sampling.h"
+#include "common.h"
+
+/**
+ * Constructor for the sampling efficiency analyzer.
+ *
+ * @param a_fname   The output file.
+ * @param forces    The force field, for the energy.
+ * @param analyzers The other analyzers, measured before this one.
+ */
+sampling::sampling(const char *a_fname, force_field *forces,
+                   vector<analyzer *> *analyzers) : analyzer("sampling", a_fname) {
+    the_forces = forces;
+    others     = analyzers;
+    start      = clock();
+}
+
+/**
+ * Destructor to destroy the analyzer.
+ */
+sampling::~sampling() {
+}
+
+/**
+ * Add the energy of a configuration and the summary values of the other
+ * analyzers to their series. The observables are chosen at the first sample,
+ * each series after the energy is fed by its own analyzer, and a sample in
+ * which an analyzer has no value is left out of its series only.
+ *
+ * @param state The configuration.
+ */
+void    sampling::sample(config *state){
+    vector<double>  values;
+
+    if(names.empty()){
+        scalar_sources(others, sources);
+        names.push_back("energy");
+        for(unsigned int k = 0; k < sources.size(); k++)
+            names.push_back(sources[k]->name);
+        series.resize(names.size());
+    }
+    series[0].add(state->energy(the_forces));
+    scalar_values(sources, values);
+    for(unsigned int k = 0; k < sources.size(); k++)
+        if(!isnan(values[k])) series[k+1].add(values[k]);
+}
+
+/**
+ * Write the estimates for each observable, then their blocking tables.
+ *
+ * @param dest  The file, open for writing.
+ * @return      The return value of the last print statement.
+ */
+int     sampling::write(FILE *dest){
+    int     rc;
+    double  cpu = (double)(clock() - start)/CLOCKS_PER_SEC;
+
+    rc = fprintf(dest, "# observable samples mean error tau ess ess_per_s plateau\n");
+    for(unsigned int k = 0; k < series.size(); k++)
+        rc = fprintf(dest, "%s %ld %g %g %g %g %g %d\n", names[k],
+                series[k].n_values(), series[k].mean(), series[k].error(),
+                series[k].tau(), series[k].ess(),
+                (cpu > 0.0) ? series[k].ess()/cpu : 0.0,
+                series[k].converged() ? 1 : 0);
+    rc = fprintf(dest, "\n# observable level block_size blocks error\n");
+    for(unsigned int k = 0; k < series.size(); k++)
+        for(int l = 0; l < series[k].n_levels(); l++)
+            rc = fprintf(dest, "%s %d %ld %ld %g\n", names[k], l, 1L << l,
+                    series[k].level_count(l), series[k].level_error(l));
+    return rc;
+}
+
+/**
+ * Write the estimates for each observable to the log.
+ *
+ * @param the_log   The log file.
+ * @return          The number of lines written.
+ */
+int     sampling::log(FILE *the_log){
+    double  cpu = (double)(clock() - start)/CLOCKS_PER_SEC;
+
+    for(unsigned int k = 0; k < series.size(); k++)
+        fprintf(the_log, "Sampling %s: mean = %g error = %g tau = %g "
+                "ess = %g ess/s = %g%s\n", names[k], series[k].mean(),
+                series[k].error(), series[k].tau(), series[k].ess(),
+                (cpu > 0.0) ? series[k].ess()/cpu : 0.0,
+                series[k].converged() ? "" : " (no plateau)");
+    return series.size();
+}
@@ -0,0 +1,58 @@
+/**
+ * @file    sampling.h
+ * @author  agent
+ * @date    October 17, 2026
+ * \brief   Header file for the sampling class
+ *
+ * @class   sampling sampling.h
+ * @brief   Statistical efficiency of a run.
+ *
+ * The number of steps of a run says little about how much it has sampled,
+ * the samples are correlated. This analyzer follows, with a blocking
+ * estimator each, the energy of the configuration and the summary value
+ * (analyzer::scalar()) of each of the other analyzers, and reports for each:
+ * its mean and error, the integrated autocorrelation time tau in samples, the
+ * effective sample size (ESS = n / 2 tau) and the effective samples per
+ * processor second of the whole run. The last is the figure of merit to
+ * compare move sets and integrators: it is independent of how often the
+ * analyses are made, as long as it is more often than tau.
+ *
+ * It must be given the list of analyzers and measured after the others so
+ * their values are those of the same configuration. At each report the log
+ * has one line per observable:
+ *
+ *      Sampling name: mean = .. error = .. tau = .. ess = .. ess/s = ..
+ *
+ * with "(no plateau)" added when the blocking error has not converged, so
+ * the run is too short for the error and tau to be trusted. The output file
+ * has the same values followed by the blocking tables.
+ */
+
+#ifndef SAMPLING_H
+#define SAMPLING_H
+
+#include <time.h>
+#include <vector>
+#include "analyzer.h"
+#include "blocking.h"
+
+using namespace std;
+
+class sampling : public analyzer {
+public:
+    sampling(const char *fname, force_field *the_forces,
+             vector<analyzer *> *others);   ///< Constructor with the output file and the other analyzers.
+    virtual ~sampling();                    ///< Destructor
+    virtual void    sample(config *state);  ///< Add the energy and the other values.
+    virtual int     write(FILE *dest);      ///< Write the estimates and blocking tables.
+    virtual int     log(FILE *the_log);     ///< Write the estimates.
+private:
+    force_field *the_forces;
+    vector<analyzer *>  *others;            ///< The other analyzers.
+    vector<const char *>    names;          ///< Name of each observable.
+    vector<analyzer *>  sources;            ///< Analyzer of each observable after the energy.
+    vector<blocking>    series;             ///< Estimator for each observable.
+    clock_t start;                          ///< Processor time at the start.
+};
+
+#endif /* SAMPLING_H */
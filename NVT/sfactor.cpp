@@ -0,0 +1,281 @@
+/**
+ * @file    sfactor.cpp
+ * @author  agent
+ * @date    October 17, 2026
+ *
+ * Implementation of the sfactor analyzer that accumulates the structure factor
+ * from the Fourier transform of the density on a grid.
+ */
+
+#include <math.h>
+#include <thread>
+#include "sfactor.h"
+#include "common.h"
+
+/**
+ * Constructor for the structure factor analyzer.
+ *
+ * @param a_fname   The output file.
+ * @param grid      The number of grid points along each side (a power of two).
+ * @param use_atoms Deposit the atoms rather than the object centers.
+ * @param threads   The number of threads to use.
+ */
+sfactor::sfactor(const char *a_fname, int grid, bool use_atoms, int threads)
+                : analyzer("sfactor", a_fname) {
+    assert(grid >= 2 && (grid & (grid-1)) == 0);
+    n_grid    = grid;
+    atoms     = use_atoms;
+    n_threads = max(threads, 1);
+    n_types   = 0;
+    dk        = 0.0;
+    for(int m = 0; m < n_grid/2; m++)
+        twiddle.push_back(polar(1.0, -M_2PI*m/n_grid));
+}
+
+/**
+ * Destructor to destroy the analyzer.
+ */
+sfactor::~sfactor() {
+}
+
+/**
+ * Deposit the points (centers or atoms) of the objects of one type among
+ * objects first..last-1 on a grid with cloud in cell weights. Only reads the
+ * configuration so it can run in several threads with different grids.
+ *
+ * @param state The configuration.
+ * @param type  The object type.
+ * @param first The first object.
+ * @param last  One past the last object.
+ * @param grid  The n_grid x n_grid grid, added to.
+ */
+void    sfactor::deposit(config *state, int type, int first, int last,
+                         vector<double> *grid){
+    topology    *the_topology = state->get_topology();
+    double  hx = state->x_size/n_grid, hy = state->y_size/n_grid;
+    double  x, y, c, s, fx, fy;
+    int     n_points, ix, iy, jx, jy;
+    object  *obj;
+    atom    *at;
+
+    for(int i = first; i < last; i++){
+        obj = state->get_object(i);
+        if(obj->o_type != type) continue;
+        n_points = atoms ? the_topology->n_atom(type) : 1;
+        c = cos(obj->orientation);
+        s = sin(obj->orientation);
+        for(int k = 0; k < n_points; k++){
+            x = obj->pos_x;
+            y = obj->pos_y;
+            if(atoms){
+                at = the_topology->atoms(type, k);
+                x += c*at->x_pos - s*at->y_pos;
+                y += s*at->x_pos + c*at->y_pos;
+            }
+            x  = fmod(x/hx, n_grid);
+            if(x < 0.0) x += n_grid;
+            y  = fmod(y/hy, n_grid);
+            if(y < 0.0) y += n_grid;
+            ix = (int)x; fx = x - ix; ix %= n_grid; jx = (ix + 1) % n_grid;
+            iy = (int)y; fy = y - iy; iy %= n_grid; jy = (iy + 1) % n_grid;
+            (*grid)[iy*n_grid + ix] += (1.0-fx)*(1.0-fy);
+            (*grid)[iy*n_grid + jx] += fx*(1.0-fy);
+            (*grid)[jy*n_grid + ix] += (1.0-fx)*fy;
+            (*grid)[jy*n_grid + jx] += fx*fy;
+        }
+    }
+}
+
+/**
+ * @brief In place forward FFT of n_grid points.
+ *
+ * Iterative radix-2 decimation in time: the points are put in bit reversed
+ * order then combined by butterflies of increasing length.
+ *
+ * @param data      The first point.
+ * @param stride    The distance between successive points.
+ */
+void    sfactor::fft(complex<double> *data, int stride){
+    complex<double> t;
+    int     j = 0, bit;
+
+    for(int i = 1; i < n_grid; i++){        // Bit reversal
+        for(bit = n_grid >> 1; j & bit; bit >>= 1) j ^= bit;
+        j |= bit;
+        if(i < j) swap(data[i*stride], data[j*stride]);
+    }
+    for(int len = 2; len <= n_grid; len <<= 1){ // Butterflies
+        int step = n_grid/len;
+        for(int i = 0; i < n_grid; i += len){
+            for(int k = 0; k < len/2; k++){
+                t = twiddle[k*step]*data[(i+k+len/2)*stride];
+                data[(i+k+len/2)*stride] = data[(i+k)*stride] - t;
+                data[(i+k)*stride] += t;
+            }
+        }
+    }
+}
+
+/**
+ * Transform the rows first..last-1 of a grid, or its columns. The columns are
+ * copied to a contiguous buffer for the transform.
+ *
+ * @param data      The n_grid x n_grid grid, by rows.
+ * @param first     The first row or column.
+ * @param last      One past the last.
+ * @param columns   Transform columns rather than rows.
+ */
+void    sfactor::fft_rows(complex<double> *data, int first, int last,
+                          bool columns){
+    vector< complex<double> >   buffer(n_grid);
+
+    for(int r = first; r < last; r++){
+        if(!columns){
+            fft(data + r*n_grid, 1);
+            continue;
+        }
+        for(int k = 0; k < n_grid; k++) buffer[k] = data[k*n_grid + r];
+        fft(&buffer[0], 1);
+        for(int k = 0; k < n_grid; k++) data[k*n_grid + r] = buffer[k];
+    }
+}
+
+/**
+ * Two dimensional transform, the rows then the columns, shared between the
+ * threads.
+ *
+ * @param data  The n_grid x n_grid grid, by rows.
+ */
+void    sfactor::transform(vector< complex<double> > &data){
+    vector<thread>  workers;
+
+    for(int pass = 0; pass < 2; pass++){
+        workers.clear();
+        for(int t = 1; t < n_threads; t++)
+            workers.push_back(thread(&sfactor::fft_rows, this, &data[0],
+                    (t*n_grid)/n_threads, ((t+1)*n_grid)/n_threads, pass == 1));
+        fft_rows(&data[0], 0, n_grid/n_threads, pass == 1);
+        for(unsigned int t = 0; t < workers.size(); t++) workers[t].join();
+    }
+}
+
+/**
+ * @brief The function sin(x)/x.
+ * @param x The argument.
+ * @return  The value, 1 at x = 0.
+ */
+static double   sinc(double x){
+    return (fabs(x) < 1E-12) ? 1.0 : sin(x)/x;
+}
+
+/**
+ * Deposit and transform the density of each object type and add the
+ * direction averaged total and partial S(k) to the sums.
+ *
+ * @param state The configuration.
+ */
+void    sfactor::sample(config *state){
+    int     n = state->n_objects();
+    int     n_g2 = n_grid*n_grid;
+    int     n_bins = n_grid/2;
+    int     n_t = min(n_threads, max(n, 1));
+    int     kx, ky, b, p;
+    double  k, w, noise, n_all = 0.0;
+    complex<double> sum;
+    vector<double>  count;
+    vector< vector<double> >    local(n_t);
+    vector< vector< complex<double> > > rho;
+    vector< complex<double> >   rho_k;
+    vector<thread>  workers;
+
+    if(n_types == 0){
+        n_types = state->get_topology()->n_types();
+        dk = M_2PI/max(state->x_size, state->y_size);
+        total.assign(n_bins, 0.0);
+        partial.assign(n_types*(n_types+1)/2, vector<double>(n_bins, 0.0));
+    }
+    count.assign(n_types, 0.0);
+    for(int i = 0; i < n; i++){
+        object *obj = state->get_object(i);
+        count[obj->o_type] += atoms ? state->get_topology()->n_atom(obj->o_type) : 1;
+    }
+    for(int a = 0; a < n_types; a++) n_all += count[a];
+    if(n_all == 0.0) return;
+
+    rho.resize(n_types);
+    for(int a = 0; a < n_types; a++){       // Density of each type
+        rho[a].assign(n_g2, 0.0);
+        if(count[a] == 0.0) continue;
+        workers.clear();
+        for(int t = 0; t < n_t; t++) local[t].assign(n_g2, 0.0);
+        for(int t = 1; t < n_t; t++)
+            workers.push_back(thread(&sfactor::deposit, this, state, a,
+                    (t*n)/n_t, ((t+1)*n)/n_t, &local[t]));
+        deposit(state, a, 0, n/n_t, &local[0]);
+        for(unsigned int t = 0; t < workers.size(); t++) workers[t].join();
+        for(int t = 0; t < n_t; t++)
+            for(int g = 0; g < n_g2; g++) rho[a][g] += local[t][g];
+        transform(rho[a]);
+    }
+
+    n_modes.assign(n_bins, 0);
+    rho_k.resize(n_types);
+    for(int iy = 0; iy < n_grid; iy++){     // Direction averages
+        ky = (iy < n_grid/2) ? iy : iy - n_grid;
+        for(int ix = 0; ix < n_grid; ix++){
+            kx = (ix < n_grid/2) ? ix : ix - n_grid;
+            k = M_2PI*sqrt((kx/state->x_size)*(kx/state->x_size)
+                           + (ky/state->y_size)*(ky/state->y_size));
+            b = (int)(k/dk + 0.5);
+            if(b == 0 || b >= n_bins) continue;
+            w = sinc(M_PI*kx/n_grid)*sinc(M_PI*ky/n_grid);
+            w = w*w*w*w;                    // Cloud in cell window squared
+            noise = (1.0 - 2.0/3.0*sin(M_PI*kx/n_grid)*sin(M_PI*kx/n_grid))
+                   *(1.0 - 2.0/3.0*sin(M_PI*ky/n_grid)*sin(M_PI*ky/n_grid));
+            sum = 0.0;
+            for(int a = 0; a < n_types; a++){
+                rho_k[a] = rho[a][iy*n_grid + ix];
+                sum += rho_k[a];
+            }
+            n_modes[b]++;
+            total[b] += (norm(sum)/n_all - noise)/w + 1.0;
+            p = 0;
+            for(int a = 0; a < n_types; a++){
+                for(int c = a; c < n_types; c++, p++){
+                    if(count[a] == 0.0 || count[c] == 0.0) continue;
+                    if(a == c)
+                        partial[p][b] += (norm(rho_k[a])/count[a] - noise)/w + 1.0;
+                    else
+                        partial[p][b] += real(rho_k[a]*conj(rho_k[c]))
+                                         /sqrt(count[a]*count[c])/w;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Write the averaged total and partial S(k) of the non empty bins.
+ *
+ * @param dest  The file, open for writing.
+ * @return      The return value of the last print statement.
+ */
+int     sfactor::write(FILE *dest){
+    int     rc;
+    double  f;
+
+    rc = fprintf(dest, "# k modes total");
+    for(int a = 0; a < n_types; a++)
+        for(int b = a; b < n_types; b++)
+            rc = fprintf(dest, " %d-%d", a, b);
+    rc = fprintf(dest, "\n");
+    for(unsigned int b = 1; b < n_modes.size(); b++){
+        if(n_modes[b] == 0) continue;
+        f = 1.0/((double)n_modes[b]*max(n_samples, 1));
+        rc = fprintf(dest, "%g %ld %g", b*dk, n_modes[b], total[b]*f);
+        for(unsigned int p = 0; p < partial.size(); p++)
+            rc = fprintf(dest, " %g", partial[p][b]*f);
+        rc = fprintf(dest, "\n");
+    }
+    return rc;
+}
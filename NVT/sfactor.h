@@ -0,0 +1,78 @@
+/**
+ * @file    sfactor.h
+ * @author  agent
+ * @date    October 17, 2026
+ * \brief   Header file for the sfactor class
+ *
+ * @class   sfactor sfactor.h
+ * @brief   Accumulates the structure factor S(k) with a fast Fourier transform.
+ *
+ * Phase separation on large scales shows up in the structure factor at small
+ * k, which is out of reach of g(r) and far too expensive to calculate by
+ * direct summation over the pairs of a large system. Instead the density is
+ * deposited on a periodic n x n grid covering the box and Fourier transformed:
+ * * the object centers, or all the atoms of the objects, are deposited with
+ *   cloud in cell weights (each point is shared between the four nearest grid
+ *   points in proportion to the overlapping areas);
+ * * the grid is transformed with a self contained radix-2 FFT (n must be a
+ *   power of two), rows then columns;
+ * * the power is divided by the square of the Fourier transform of the cloud
+ *   in cell window, W(k) = sinc^2(k_x h_x/2) sinc^2(k_y h_y/2), to undo the
+ *   smoothing, after the shot noise, which the window and the aliasing by
+ *   the grid change to C(k) = prod_x,y (1 - 2/3 sin^2(k h/2)), has been
+ *   replaced by its true value 1 (Jing 2005).
+ *
+ * With rho_a(k) the transform of the N_a points of object type a
+ *
+ *      S(k)    = (|sum_a rho_a(k)|^2 / N - C(k)) / W(k)^2 + 1
+ *      S_aa(k) = (|rho_a(k)|^2 / N_a - C(k)) / W(k)^2 + 1
+ *      S_ab(k) = Re(rho_a(k) rho_b(k)*) / sqrt(N_a N_b) / W(k)^2
+ *
+ * are averaged over the directions of k, in bins of width 2 pi / L where L is
+ * the larger side of the box, up to the Nyquist limit of the grid, and over
+ * the samples. k = 0 is left out.
+ *
+ * The deposition and the transforms are shared between n_threads threads,
+ * each deposits a part of the objects on its own grid (the grids are added
+ * together) and the rows and columns are divided between the threads.
+ *
+ * The output has a comment line naming the columns followed by one line per
+ * non empty bin: k, the number of wave vectors averaged in each sample, the
+ * total S(k) and the partial S(k) for the pairs of types 0-0, 0-1, ... 1-1, ...
+ */
+
+#ifndef SFACTOR_H
+#define SFACTOR_H
+
+#include <vector>
+#include <complex>
+#include "analyzer.h"
+
+using namespace std;
+
+class sfactor : public analyzer {
+public:
+    sfactor(const char *fname, int n_grid, bool atoms,
+            int n_threads);                 ///< Constructor with the output file, grid size, points and threads.
+    virtual ~sfactor();                     ///< Destructor
+    virtual void    sample(config *state);  ///< Accumulate S(k) for one configuration.
+    virtual int     write(FILE *dest);      ///< Write the averaged S(k).
+    int     n_grid;                         ///< Grid points along each side, a power of two.
+    bool    atoms;                          ///< Deposit the atoms rather than the object centers.
+    int     n_threads;                      ///< Number of threads used for a sample.
+private:
+    void    deposit(config *state, int type, int first, int last,
+                    vector<double> *grid);  ///< Add the points of objects first..last-1 of a type.
+    void    fft(complex<double> *data, int stride);     ///< In place transform of n_grid points.
+    void    fft_rows(complex<double> *data, int first, int last,
+                     bool columns);         ///< Transform rows (or columns) first..last-1.
+    void    transform(vector< complex<double> > &data);  ///< Two dimensional transform.
+    int     n_types;                        ///< Number of object types.
+    double  dk;                             ///< Width of the k bins.
+    vector< complex<double> >   twiddle;    ///< exp(-2 pi i m / n_grid) for m < n_grid/2.
+    vector<long>    n_modes;                ///< Wave vectors in each bin per sample.
+    vector<double>  total;                  ///< Accumulated total S(k).
+    vector< vector<double> > partial;       ///< Accumulated S(k) for each pair of types a <= b.
+};
+
+#endif /* SFACTOR_H */
@@ -0,0 +1,189 @@
+/**
+ * @file    surrogate.cpp
+ * @author  agent
+ * @date    October 17, 2026
+ *
+ * Implementation of the surrogate, a tabulated object level estimate of the
+ * interaction energy used to screen Monte Carlo moves.
+ */
+
+#include <math.h>
+#include "surrogate.h"
+#include "common.h"
+
+#define SURR_DR         0.05        // Distance step of the tables
+#define SURR_ANGLES     24          // Orientations averaged for each object
+
+/**
+ * Build the certain overlap distances and the tabulated energies for all the
+ * pairs of object types of the topology.
+ *
+ * @param the_forces    The force field.
+ * @param the_topology  The object topologies.
+ */
+surrogate::surrogate(force_field *the_forces, topology *the_topology) {
+    atom    *at1, *at2;
+    double  d1, d2, hard, h_max, r, sum;
+    double  a1, a2, x1, y1, x2, y2, dx, dy;
+    int     n_bins;
+
+    n_types = the_topology->n_types();
+    dr      = SURR_DR;
+    reach   = 0.0;
+    grid    = (cell_list *)NULL;
+    certain.assign(n_types*n_types, 0.0);
+    range.assign(n_types*n_types, 0.0);
+    table.resize(n_types*n_types);
+
+    for(int t1 = 0; t1 < n_types; t1++){
+        for(int t2 = t1; t2 < n_types; t2++){
+            h_max = 0.0;                    // Strict overlap bound and range
+            for(int i = 0; i < the_topology->n_atom(t1); i++){
+                at1 = the_topology->atoms(t1, i);
+                d1  = sqrt(at1->x_pos*at1->x_pos + at1->y_pos*at1->y_pos);
+                for(int j = 0; j < the_topology->n_atom(t2); j++){
+                    at2  = the_topology->atoms(t2, j);
+                    d2   = sqrt(at2->x_pos*at2->x_pos + at2->y_pos*at2->y_pos);
+                    hard = the_forces->size(at1->type) + the_forces->size(at2->type);
+                    h_max = max(h_max, the_forces->range(at1->type, at2->type));
+                    if(hard > 0.0)
+                        certain[t1*n_types+t2] = max(certain[t1*n_types+t2],
+                                hard - d1 - d2);
+                }
+            }
+            range[t1*n_types+t2] = min(the_forces->cut_off,
+                    the_topology->extent(t1) + the_topology->extent(t2)
+                    + h_max);
+            reach = max(reach, range[t1*n_types+t2]);
+
+            n_bins = (int)ceil(range[t1*n_types+t2]/dr) + 1;
+            table[t1*n_types+t2].assign(n_bins, 0.0);
+            for(int k = 0; k < n_bins; k++){    // Orientation averages
+                r   = k*dr;
+                sum = 0.0;
+                for(int k1 = 0; k1 < SURR_ANGLES; k1++){
+                    a1 = k1*M_2PI/SURR_ANGLES;
+                    for(int k2 = 0; k2 < SURR_ANGLES; k2++){
+                        a2 = k2*M_2PI/SURR_ANGLES;
+                        for(int i = 0; i < the_topology->n_atom(t1); i++){
+                            at1 = the_topology->atoms(t1, i);
+                            x1 = cos(a1)*at1->x_pos - sin(a1)*at1->y_pos;
+                            y1 = sin(a1)*at1->x_pos + cos(a1)*at1->y_pos;
+                            for(int j = 0; j < the_topology->n_atom(t2); j++){
+                                at2 = the_topology->atoms(t2, j);
+                                x2 = r + cos(a2)*at2->x_pos - sin(a2)*at2->y_pos;
+                                y2 = sin(a2)*at2->x_pos + cos(a2)*at2->y_pos;
+                                dx = x2 - x1;
+                                dy = y2 - y1;
+                                hard = the_forces->size(at1->type)
+                                        + the_forces->size(at2->type);
+                                sum += the_forces->interaction(at1->type,
+                                        at2->type, max(sqrt(dx*dx + dy*dy), hard));
+                            }
+                        }
+                    }
+                }
+                table[t1*n_types+t2][k] = sum/(SURR_ANGLES*SURR_ANGLES);
+            }
+            certain[t2*n_types+t1] = certain[t1*n_types+t2];
+            range[t2*n_types+t1]   = range[t1*n_types+t2];
+            table[t2*n_types+t1]   = table[t1*n_types+t2];
+        }
+    }
+    big_energy = the_forces->big_energy;
+}
+
+/**
+ * Destructor to destroy a surrogate.
+ */
+surrogate::~surrogate() {
+    if(grid) delete grid;
+}
+
+/**
+ * The estimated interaction energy of two objects, linear interpolation in the
+ * table or big_energy if the objects certainly overlap.
+ *
+ * @param t1    The type of the first object.
+ * @param t2    The type of the second object.
+ * @param r     The distance between the object centers.
+ * @return      The energy.
+ */
+double  surrogate::pair(int t1, int t2, double r){
+    int     p = t1*n_types + t2;
+    int     k;
+    double  f;
+
+    if(r < certain[p]) return big_energy;
+    if(r >= range[p])  return 0.0;
+    f = r/dr;
+    k = (int)f;
+    f -= k;
+    return (1.0-f)*table[p][k] + f*table[p][k+1];
+}
+
+/**
+ * Build the spatial index for a configuration, a new grid is made for its box
+ * with cells at least as large as the range of the tables. It must be called
+ * again if the box or the number of objects change.
+ *
+ * @param state The configuration.
+ */
+void    surrogate::track(config *state){
+    if(grid) delete grid;
+    grid = new cell_list(state->x_size, state->y_size, max(reach, dr),
+            state->periodic());
+    state->fill_grid(grid);
+}
+
+/**
+ * Move an object of the tracked configuration in the spatial index.
+ *
+ * @param index The index of the object.
+ * @param obj   The object at its new position.
+ */
+void    surrogate::moved(int index, object *obj){
+    grid->update(index, obj->pos_x, obj->pos_y);
+}
+
+/**
+ * @brief Estimated energy of an object with the objects of a configuration.
+ *
+ * Only the objects within the range of the tables, found with the spatial
+ * index of the tracked configuration, are visited.
+ *
+ * @param state The tracked configuration.
+ * @param obj   The object (need not be in the configuration).
+ * @param skip  Index of an object to leave out (or -1).
+ * @return      The sum of the pair estimates.
+ */
+double  surrogate::object_energy(config *state, object *obj, int skip){
+    object  *obj2;
+    double  dx, dy, value = 0.0;
+    vector<int> near;
+
+    grid->neighbours(obj->pos_x, obj->pos_y, reach, near);
+    for(unsigned int i = 0; i < near.size(); i++){
+        if(near[i] == skip) continue;
+        obj2 = state->get_object(near[i]);
+        state->image_shift(obj, obj2, &dx, &dy);
+        dx += obj2->pos_x - obj->pos_x;
+        dy += obj2->pos_y - obj->pos_y;
+        value += pair(obj->o_type, obj2->o_type, sqrt(dx*dx + dy*dy));
+    }
+    return value;
+}
+
+/**
+ * The estimated change of the energy of the configuration when an object is
+ * moved.
+ *
+ * @param state The tracked configuration, unchanged.
+ * @param index The index of the object that is moved.
+ * @param trial The object at its new position and orientation.
+ * @return      The estimated energy change.
+ */
+double  surrogate::energy_change(config *state, int index, object *trial){
+    return object_energy(state, trial, index)
+            - object_energy(state, state->get_object(index), index);
+}
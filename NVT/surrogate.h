@@ -0,0 +1,66 @@
+/**
+ * @file    surrogate.h
+ * @author  agent
+ * @date    October 17, 2026
+ * \brief   Header file for the surrogate class
+ *
+ * @class   surrogate surrogate.h
+ * @brief   A cheap object level estimate of the interaction energy.
+ *
+ * The surrogate is used for the first stage of delayed acceptance Monte Carlo
+ * (see integrator). It replaces the atom by atom interaction between two
+ * objects by a function of the object types and of the distance between their
+ * centers only:
+ * * a tabulated energy, the full interaction averaged over the orientations of
+ *   the two objects, with touching atoms counted at their hard core distance
+ *   so the average does not include core penalties;
+ * * a certain overlap distance below which two atoms of the objects overlap
+ *   whatever the orientations, there the surrogate returns big_energy.
+ *
+ * The certain overlap distance is a strict bound (the largest, over pairs of
+ * atoms, of their hard core distance minus their distances from the object
+ * centers), so rejecting a move at the first stage because of it never
+ * rejects a move that the full energy would have allowed. The tabulated energy
+ * is only an estimate, the second stage of the delayed acceptance corrects
+ * for it exactly.
+ *
+ * The tables are built from a topology and a force field when the surrogate is
+ * created and must be rebuilt if either changes.
+ *
+ * The estimates are zero beyond the range of the tables, so only the objects
+ * in the cells of a cell_list within this range are visited and the cost of
+ * an estimate does not grow with the number of objects. The spatial index is
+ * filled by track() for the configuration that is being integrated and must
+ * be told, with moved(), where the objects of the accepted moves go.
+ */
+
+#ifndef SURROGATE_H
+#define SURROGATE_H
+
+#include <vector>
+#include "config.h"
+
+using namespace std;
+
+class surrogate {
+public:
+    surrogate(force_field *the_forces, topology *the_topology);  ///< Build the tables.
+    virtual ~surrogate();                   ///< Destructor
+    double  pair(int t1, int t2, double r); ///< The estimated energy of two objects at distance r.
+    double  energy_change(config *state, int index,
+                          object *trial);   ///< Estimated energy change when object index is replaced by trial.
+    void    track(config *state);           ///< Index the objects of a configuration.
+    void    moved(int index, object *obj);  ///< Follow an object of the tracked configuration.
+private:
+    double  object_energy(config *state, object *obj, int skip);  ///< Estimated energy of obj with the others.
+    int     n_types;                        ///< Number of object types.
+    double  dr;                             ///< Distance step of the tables.
+    double  reach;                          ///< Largest range of the tables.
+    cell_list   *grid;                      ///< Spatial index of the tracked configuration.
+    double  big_energy;                     ///< Energy returned for a certain overlap.
+    vector<double>  certain;                ///< Certain overlap distance for each pair of types.
+    vector<double>  range;                  ///< Distance beyond which the energy is zero.
+    vector< vector<double> > table;         ///< Tabulated energy for each pair of types.
+};
+
+#endif /* SURROGATE_H */
@@ -0,0 +1,151 @@
+/**
+ * @file    tessellation.cpp
+ * @author  agent
+ * @date    October 17, 2026
+ *
+ * Implementation of the tessellation analyzer, statistics of the Voronoi or
+ * radical cells of the objects.
+ */
+
+#include <math.h>
+#include "tessellation.h"
+#include "common.h"
+
+/**
+ * Constructor for the tessellation analyzer.
+ *
+ * @param a_fname   The output file.
+ * @param forces    The force field, for the object radii.
+ * @param use_radical   Use the radical tessellation.
+ */
+tessellation::tessellation(const char *a_fname, force_field *forces,
+                           bool use_radical) : analyzer("voronoi", a_fname) {
+    the_forces = forces;
+    radical    = use_radical;
+    n_types    = 0;
+}
+
+/**
+ * Destructor to destroy the analyzer.
+ */
+tessellation::~tessellation() {
+}
+
+/**
+ * Tessellate a configuration and add the cell statistics.
+ *
+ * @param state The configuration.
+ */
+void    tessellation::sample(config *state){
+    int     n = state->n_objects();
+    int     t, k;
+    object  *obj;
+    vector<double>  radii;
+    vector<int>     count;
+
+    if(n_types == 0){
+        n_types = state->get_topology()->n_types();
+        sum_area.assign(n_types, 0.0);
+        sum_defects.assign(n_types, 0.0);
+        sum_count.assign(n_types, 0);
+        histogram.assign(n_types, vector<long>());
+    }
+    if(radical)
+        for(t = 0; t < n_types; t++) radii.push_back(state->reach(the_forces, t));
+    voronoi cells(radii);
+    cells.build(state);
+
+    type.resize(n); pos_x.resize(n); pos_y.resize(n);
+    area.resize(n); n_nbr.resize(n);
+    last.assign(5*n_types, 0.0);
+    count.assign(n_types, 0);
+    for(int i = 0; i < n; i++){
+        obj = state->get_object(i);
+        t = type[i] = obj->o_type;
+        pos_x[i] = obj->pos_x;
+        pos_y[i] = obj->pos_y;
+        area[i]  = cells.area(i);
+        k = n_nbr[i] = cells.n_neighbours(i);
+        if((int)histogram[t].size() <= k) histogram[t].resize(k+1, 0);
+        histogram[t][k]++;
+        count[t]++;
+        last[5*t]   += area[i];
+        last[5*t+1] += k;
+        if(k != 6) last[5*t+2] += 1.0;
+        if(k == 5) last[5*t+3] += 1.0;
+        if(k == 7) last[5*t+4] += 1.0;
+    }
+    for(t = 0; t < n_types; t++){
+        sum_area[t]    += last[5*t];
+        sum_defects[t] += last[5*t+2];
+        sum_count[t]   += count[t];
+        if(count[t] > 0){
+            last[5*t]   /= count[t];
+            last[5*t+1] /= count[t];
+        }
+    }
+}
+
+/**
+ * Write for each type the mean area and fraction of defects, then the
+ * neighbour count distributions and the cells of the last sample.
+ *
+ * @param dest  The file, open for writing.
+ * @return      The return value of the last print statement.
+ */
+int     tessellation::write(FILE *dest){
+    int     rc;
+
+    rc = fprintf(dest, "# type objects area defects\n");
+    for(int t = 0; t < n_types; t++)
+        if(sum_count[t] > 0)
+            rc = fprintf(dest, "%d %g %g %g\n", t,
+                    (double)sum_count[t]/max(n_samples, 1),
+                    sum_area[t]/sum_count[t], sum_defects[t]/sum_count[t]);
+    rc = fprintf(dest, "\n# type neighbours fraction\n");
+    for(int t = 0; t < n_types; t++)
+        for(unsigned int k = 0; k < histogram[t].size(); k++)
+            if(histogram[t][k] > 0)
+                rc = fprintf(dest, "%d %d %g\n", t, k,
+                        (double)histogram[t][k]/sum_count[t]);
+    rc = fprintf(dest, "\n# index type x y area neighbours\n");
+    for(unsigned int i = 0; i < area.size(); i++)
+        rc = fprintf(dest, "%d %d %g %g %g %d\n", i, type[i], pos_x[i],
+                pos_y[i], area[i], n_nbr[i]);
+    return rc;
+}
+
+/**
+ * Write the mean area, mean number of neighbours and defect counts of the
+ * last sample to the log, one line for each object type present.
+ *
+ * @param the_log   The log file.
+ * @return          The number of lines written.
+ */
+int     tessellation::log(FILE *the_log){
+    int     n_lines = 0;
+
+    for(int t = 0; t < n_types && !last.empty(); t++){
+        if(last[5*t+1] == 0.0) continue;
+        fprintf(the_log, "Voronoi type %d: area = %g neighbours = %g "
+                "defects = %g n5 = %g n7 = %g\n", t, last[5*t], last[5*t+1],
+                last[5*t+2], last[5*t+3], last[5*t+4]);
+        n_lines++;
+    }
+    return n_lines;
+}
+
+/**
+ * The fraction of the objects of the last sample that are defects.
+ *
+ * @param value Set to the fraction.
+ * @return      True if there has been a sample.
+ */
+bool    tessellation::scalar(double *value){
+    double  defects = 0.0;
+
+    if(area.empty()) return false;
+    for(int t = 0; t < n_types; t++) defects += last[5*t+2];
+    *value = defects/area.size();
+    return true;
+}
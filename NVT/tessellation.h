@@ -0,0 +1,63 @@
+/**
+ * @file    tessellation.h
+ * @author  agent
+ * @date    October 17, 2026
+ * \brief   Header file for the tessellation class
+ *
+ * @class   tessellation tessellation.h
+ * @brief   Local area and neighbour statistics from a Voronoi tessellation.
+ *
+ * Each sample the configuration is tessellated (see voronoi), either with
+ * Voronoi cells or with the radical tessellation where the radius of an
+ * object is its reach in the force field, so larger objects get larger
+ * cells. For each object type the analyzer accumulates:
+ * * the mean cell area, the local area per object to compare with the AFM
+ *   images (its inverse is the local density);
+ * * the distribution of the number of neighbours (cells sharing an edge);
+ * * the number of topological defects, objects with other than six
+ *   neighbours, and among them those with five and seven.
+ *
+ * At each report the log has one line per object type present with the
+ * values of the last sample:
+ *
+ *      Voronoi type t: area = .. neighbours = .. defects = .. n5 = .. n7 = ..
+ *
+ * The output file has the averages for each type, the neighbour count
+ * distributions and the area and number of neighbours of each object in the
+ * last sample.
+ */
+
+#ifndef TESSELLATION_H
+#define TESSELLATION_H
+
+#include <vector>
+#include "analyzer.h"
+#include "voronoi.h"
+
+using namespace std;
+
+class tessellation : public analyzer {
+public:
+    tessellation(const char *fname, force_field *the_forces,
+                 bool radical);             ///< Constructor with the output file and kind of tessellation.
+    virtual ~tessellation();                ///< Destructor
+    virtual void    sample(config *state);  ///< Tessellate one configuration.
+    virtual int     write(FILE *dest);      ///< Write the averages, distributions and last cells.
+    virtual int     log(FILE *the_log);     ///< Write the values of the last sample.
+    virtual bool    scalar(double *value);  ///< The fraction of defects.
+    bool    radical;                        ///< Use the radical tessellation.
+private:
+    force_field *the_forces;
+    int     n_types;                        ///< Number of object types.
+    vector<double>  sum_area;               ///< Sum of the cell areas of each type.
+    vector<double>  sum_defects;            ///< Sum of the defects of each type.
+    vector<long>    sum_count;              ///< Sum of the numbers of objects of each type.
+    vector< vector<long> >  histogram;      ///< Neighbour count distribution of each type.
+    vector<double>  last;                   ///< Values of the last sample, 5 per type.
+    vector<int>     type;                   ///< Type of each object in the last sample.
+    vector<double>  pos_x, pos_y;           ///< Position of each object in the last sample.
+    vector<double>  area;                   ///< Cell area of each object in the last sample.
+    vector<int>     n_nbr;                  ///< Neighbours of each object in the last sample.
+};
+
+#endif /* TESSELLATION_H */
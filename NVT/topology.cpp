@@ -8,9 +8,13 @@
  * @todo Read a topology file
  */
 #include <malloc.h>
+#include <math.h>
+#include <vector>
 #include "topology.h"
 #include "common.h"
 
+using namespace std;
+
 /**
  * Initialize hard coded topology should really be empty topology and then allow
  * the manipulation of the topology. It would be beter if there was no hard coded
@@ -40,9 +44,41 @@ topology::topology() {
     len[1]= 4;          // JS 16/4
 }
 
+/**
+ * Create an empty topology with a number of object types that have no atoms
+ * yet, the atoms are then added with add_atom().
+ *
+ * @param n_obj_types   The number of object types.
+ */
+topology::topology(int n_obj_types) {
+    assert(n_obj_types <= MAX_TOPO);
+    for(int i = 0; i < MAX_TOPO; i++){
+        data[i] = (atom **)NULL;
+        len[i]  = 0;
+        if(i < n_obj_types){
+            data[i] = (atom **)malloc(MAX_ATOMS*sizeof(atom*));
+            for(int j = 0; j < MAX_ATOMS; j++) data[i][j] = (atom *)NULL;
+        }
+    }
+}
+
+/**
+ * Copy a topology, the atoms are copied so the new topology is independent
+ * of the original.
+ *
+ * @param orig  The topology to copy.
+ */
 topology::topology(topology* orig){
-    topology();                             // Cheat
-    assert(true);
+    for(int i = 0; i < MAX_TOPO; i++){
+        data[i] = (atom **)NULL;
+        len[i]  = orig->len[i];
+        if(orig->data[i] != (atom **)NULL){
+            data[i] = (atom **)malloc(MAX_ATOMS*sizeof(atom*));
+            for(int j = 0; j < MAX_ATOMS; j++)
+                data[i][j] = (orig->data[i][j] != (atom *)NULL)
+                        ? new atom(*orig->data[i][j]) : (atom *)NULL;
+        }
+    }
 }
 
 topology::topology(const topology& orig) {
@@ -86,6 +122,119 @@ atom*   topology::atoms(int type, int i) {
     return data[type][i];
 }
 
+/**
+ * How many object types are defined? The types are numbered from 0 and
+ * the first undefined type ends the list.
+ * @return      The number of object types.
+ */
+int     topology::n_types(){
+    int     i;
+    for(i = 0; i < MAX_TOPO; i++){
+        if (data[i] == (atom **)NULL ) break;
+    }
+    return i;
+}
+
+/**
+ * The distance from the object reference point to the furthest atom center.
+ * Adding the largest atom radius gives a disc that bounds the object whatever
+ * its orientation.
+ * @param type  The type of object concerned.
+ * @return      The distance.
+ */
+double  topology::extent(int type){
+    double  r2, value = 0.0;
+    atom    *at;
+
+    for(int i = 0; i < n_atom(type); i++){
+        at = atoms(type, i);
+        r2 = at->x_pos*at->x_pos + at->y_pos*at->y_pos;
+        if(r2 > value) value = r2;
+    }
+    return sqrt(value);
+}
+
+/**
+ * Add an atom to an object type.
+ * @param type      The object type (already defined).
+ * @param an_atom   The atom, it then belongs to the topology.
+ */
+void    topology::add_atom(int type, atom *an_atom){
+    assert(data[type] != (atom **)NULL);
+    assert(len[type] < MAX_ATOMS);
+    data[type][len[type]++] = an_atom;
+}
+
+/**
+ * Make a coarse topology in which each object type is a single disc that
+ * bounds the object whatever its orientation. For each object type a new atom
+ * type is added to the force field, with a radius equal to the extent of the
+ * object plus its largest atom radius and the color of its first atom.
+ *
+ * The well depth between two proxies is the interaction energy of the full
+ * objects averaged over their orientations when the proxies are in contact.
+ * Atoms that touch at contact are counted at the hard core distance so the
+ * rounding of the positions does not add core penalties to the average.
+ * The cut off of the force field is increased if necessary so the proxy
+ * wells are not truncated.
+ *
+ * @param the_forces    The force field, modified to add the proxy atom types.
+ * @return              The new topology, with the same object types.
+ */
+topology *topology::proxy(force_field *the_forces){
+    int     n = n_types();
+    topology    *value = new topology(n);
+    vector<int>     proxy_type;
+    vector<double>  proxy_radius;
+    double  r, reach;
+    double  a1, a2, x1, y1, x2, y2, dx, dy, hard, sum;
+    atom    *at1, *at2;
+
+    for(int t = 0; t < n; t++){
+        r = 0.0;
+        for(int i = 0; i < n_atom(t); i++)
+            r = max(r, the_forces->size(atoms(t, i)->type));
+        proxy_radius.push_back(extent(t) + r);
+        proxy_type.push_back(the_forces->add_type(proxy_radius[t],
+                the_forces->get_color(atoms(t, 0)->type)));
+        value->add_atom(t, new atom(proxy_type[t], 0.0, 0.0));
+    }
+
+    for(int t1 = 0; t1 < n; t1++){          // Orientation averaged well depths
+        for(int t2 = t1; t2 < n; t2++){
+            reach = proxy_radius[t1] + proxy_radius[t2];
+            sum   = 0.0;
+            for(int k1 = 0; k1 < PROXY_ANGLES; k1++){
+                a1 = k1*M_2PI/PROXY_ANGLES;
+                for(int k2 = 0; k2 < PROXY_ANGLES; k2++){
+                    a2 = k2*M_2PI/PROXY_ANGLES;
+                    for(int i = 0; i < n_atom(t1); i++){
+                        at1 = atoms(t1, i);
+                        x1 = cos(a1)*at1->x_pos - sin(a1)*at1->y_pos;
+                        y1 = sin(a1)*at1->x_pos + cos(a1)*at1->y_pos;
+                        for(int j = 0; j < n_atom(t2); j++){
+                            at2 = atoms(t2, j);
+                            x2 = reach + cos(a2)*at2->x_pos - sin(a2)*at2->y_pos;
+                            y2 = sin(a2)*at2->x_pos + cos(a2)*at2->y_pos;
+                            dx = x2 - x1;
+                            dy = y2 - y1;
+                            hard = the_forces->size(at1->type)
+                                    + the_forces->size(at2->type);
+                            sum += the_forces->interaction(at1->type, at2->type,
+                                    max(sqrt(dx*dx + dy*dy), hard));
+                        }
+                    }
+                }
+            }
+            the_forces->set_energy(proxy_type[t1], proxy_type[t2],
+                    sum/(PROXY_ANGLES*PROXY_ANGLES));
+            the_forces->cut_off = max(the_forces->cut_off,
+                    reach + the_forces->get_length());
+        }
+    }
+    return value;
+}
+
 int     topology::write(FILE *dest){
     int     i;
     int     rc;
@@ -8,25 +8,37 @@
  * \class   topology topology.h
  * \brief   A class describing the structure of objects.
  *
+ * For each object type the topology holds the atoms that make up the object,
+ * with their positions relative to the object reference point.
+ *
+ * proxy(ff) makes a coarse version of the topology in which each object type
+ * is a single disc bounding the object, this is much faster to simulate and
+ * is used for a first equilibration of large systems.
  */
 
 #ifndef TOPOLOGY_H
 #define TOPOLOGY_H
 
 #include "atom.h"
+#include "force_field.h"
 
 #define MAX_ATOMS   16
 #define MAX_TOPO     8
+#define PROXY_ANGLES 24         // Orientations averaged for the proxy wells
 
 class topology {
 public:
-    topology();
-    topology(int i);
-    topology(topology *orig);
+    topology();                         ///< The hard coded topology.
+    topology(int n_obj_types);          ///< Empty object types to fill with add_atom().
+    topology(topology *orig);           ///< Copy a topology.
     topology(const topology& orig);
     virtual ~topology();
     int     n_atom(int type);           ///< Number of atoms in this topology
     atom    *atoms(int type, int i);    ///< Function to read data
+    int     n_types();                  ///< Number of object types defined
+    double  extent(int type);           ///< Largest distance from the object center to an atom
+    void    add_atom(int type, atom *an_atom);  ///< Add an atom to an object type.
+    topology *proxy(force_field *the_forces);   ///< Single disc proxies of the object types.
     int     write(FILE *dest);          ///< Write the topology info.
 private:
     int     check();                    ///< Verify all is well with the topology.
@@ -0,0 +1,59 @@
+/**
+ * @file    trajectory.cpp
+ * @author  agent
+ * @date    October 17, 2026
+ *
+ * Implementation of the trajectory analyzer that stores the sampled
+ * configurations.
+ */
+
+#include <stdlib.h>
+#include "trajectory.h"
+#include "common.h"
+
+/**
+ * Constructor for the trajectory analyzer, the output file is created.
+ *
+ * @param a_fname   The output file.
+ */
+trajectory::trajectory(const char *a_fname) : analyzer("trajectory", a_fname) {
+    if(! (dest = fopen(fname, "w"))){
+        fprintf(stderr, "Unable to open %s for writing\n", fname);
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * Destructor that closes the output file.
+ */
+trajectory::~trajectory() {
+    fclose(dest);
+}
+
+/**
+ * Append a configuration to the output file.
+ *
+ * @param state The configuration.
+ */
+void    trajectory::sample(config *state){
+    state->write(dest);
+}
+
+/**
+ * Flush the output file so the configurations so far can be read.
+ *
+ * @return EXIT_SUCCESS or EXIT_FAILURE if the file cannot be written.
+ */
+int     trajectory::save(){
+    return fflush(dest) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/**
+ * Write the number of configurations stored.
+ *
+ * @param a_dest    The file, open for writing.
+ * @return          The return value of the print statement.
+ */
+int     trajectory::write(FILE *a_dest){
+    return fprintf(a_dest, "%d configurations in %s\n", n_samples, fname);
+}
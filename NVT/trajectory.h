@@ -0,0 +1,38 @@
+/**
+ * @file    trajectory.h
+ * @author  agent
+ * @date    October 17, 2026
+ * \brief   Header file for the trajectory class
+ *
+ * @class   trajectory trajectory.h
+ * @brief   Stores the sampled configurations.
+ *
+ * Some analyses are made after the run, for example the re-evaluation of the
+ * energies with other force field parameters (see the ffreweight program).
+ * This analyzer appends each sampled configuration to its output file, in the
+ * configuration file format, so the file is a sequence of configurations
+ * that can be read one after the other with the config file constructor.
+ * The samples are the same as those of the other analyzers, in particular
+ * those of frames, line for line.
+ *
+ * The file is opened when the analyzer is created and written as the samples
+ * are taken, save() only flushes it.
+ */
+
+#ifndef TRAJECTORY_H
+#define TRAJECTORY_H
+
+#include "analyzer.h"
+
+class trajectory : public analyzer {
+public:
+    trajectory(const char *fname);          ///< Constructor with the output file.
+    virtual ~trajectory();                  ///< Destructor, closes the file.
+    virtual void    sample(config *state);  ///< Append the configuration.
+    virtual int     save();                 ///< Flush the output file.
+    virtual int     write(FILE *dest);      ///< Write the number of configurations.
+private:
+    FILE    *dest;                          ///< The output file.
+};
+
+#endif /* TRAJECTORY_H */
@@ -0,0 +1,212 @@
+/**
+ * @file    voronoi.cpp
+ * @author  agent
+ * @date    October 17, 2026
+ *
+ * Implementation of the Voronoi and radical tessellations by half plane
+ * clipping.
+ */
+
+#include <math.h>
+#include <algorithm>
+#include "voronoi.h"
+#include "common.h"
+
+#define VOR_SEARCH      3.0         // First search distance in mean spacings
+
+/**
+ * Constructor for a tessellation. With radii the radical tessellation is
+ * made, the weight of an object is the square of the radius of its type.
+ *
+ * @param radii The radius of each object type, or empty for Voronoi.
+ */
+voronoi::voronoi(const vector<double> &radii) {
+    for(unsigned int t = 0; t < radii.size(); t++)
+        weight.push_back(radii[t]*radii[t]);
+    grid = (cell_list *)NULL;
+}
+
+/**
+ * Destructor to destroy a tessellation.
+ */
+voronoi::~voronoi() {
+    if(grid) delete grid;
+}
+
+/**
+ * @brief Build the cell of one object.
+ *
+ * The cell starts as a square larger than the box (or as the box itself
+ * without periodic conditions) and is clipped by the boundaries with the
+ * objects found within a search distance, closest first. If the cell could
+ * still be cut by an object beyond the search distance the search distance
+ * is doubled and the cell built again.
+ *
+ * @param state The configuration.
+ * @param i     The object.
+ */
+void    voronoi::make_cell(config *state, int i){
+    object  *obj1 = state->get_object(i), *obj2;
+    double  r_max, s, w_i, w_max = 0.0, w_j;
+    double  sx, sy, d2, d, ux, uy, p, da, db, f, v_max, h;
+    vector< pair<double, int> > cand;
+    vector<double>  px, py, qx, qy;
+    vector<int>     pe, qe;
+    bool    periodic = state->periodic();
+    int     n = state->n_objects();
+
+    for(unsigned int t = 0; t < weight.size(); t++) w_max = max(w_max, weight[t]);
+    w_i = weight.empty() ? 0.0 : weight[obj1->o_type];
+    r_max = sqrt(state->x_size*state->x_size + state->y_size*state->y_size);
+    if(periodic) r_max *= 0.5;
+    s = min(r_max, VOR_SEARCH*sqrt(state->area()/n));
+
+    while(true){
+        if(periodic){                       // Starting polygon
+            h  = max(state->x_size, state->y_size);
+            px = {-h, h, h, -h};
+            py = {-h, -h, h, h};
+        } else {
+            px = {-obj1->pos_x, state->x_size - obj1->pos_x,
+                  state->x_size - obj1->pos_x, -obj1->pos_x};
+            py = {-obj1->pos_y, -obj1->pos_y,
+                  state->y_size - obj1->pos_y, state->y_size - obj1->pos_y};
+        }
+        pe.assign(4, -1);
+
+        cand.clear();                       // Objects within s, closest first
+        grid->neighbours(obj1->pos_x, obj1->pos_y, s, found);
+        for(unsigned int m = 0; m < found.size(); m++){
+            if(found[m] == i) continue;
+            obj2 = state->get_object(found[m]);
+            state->image_shift(obj1, obj2, &sx, &sy);
+            sx += obj2->pos_x - obj1->pos_x;
+            sy += obj2->pos_y - obj1->pos_y;
+            d2 = sx*sx + sy*sy;
+            if(d2 > 0.0 && (d2 < s*s || s >= r_max))
+                cand.push_back(make_pair(d2, found[m]));
+        }
+        sort(cand.begin(), cand.end());
+
+        for(unsigned int m = 0; m < cand.size() && !px.empty(); m++){
+            obj2 = state->get_object(cand[m].second);
+            state->image_shift(obj1, obj2, &sx, &sy);
+            sx += obj2->pos_x - obj1->pos_x;
+            sy += obj2->pos_y - obj1->pos_y;
+            d  = sqrt(cand[m].first);
+            ux = sx/d;
+            uy = sy/d;
+            w_j = weight.empty() ? 0.0 : weight[obj2->o_type];
+            p  = (d*d + w_i - w_j)/(2.0*d); // Boundary at u.v = p
+            qx.clear(); qy.clear(); qe.clear();
+            for(unsigned int k = 0; k < px.size(); k++){    // Clip
+                unsigned int l = (k + 1) % px.size();
+                da = ux*px[k] + uy*py[k] - p;
+                db = ux*px[l] + uy*py[l] - p;
+                if(da <= 0.0){
+                    qx.push_back(px[k]); qy.push_back(py[k]); qe.push_back(pe[k]);
+                }
+                if((da <= 0.0) != (db <= 0.0)){
+                    f = da/(da - db);
+                    qx.push_back(px[k] + f*(px[l] - px[k]));
+                    qy.push_back(py[k] + f*(py[l] - py[k]));
+                    qe.push_back((da <= 0.0) ? cand[m].second : pe[k]);
+                }
+            }
+            px.swap(qx); py.swap(qy); pe.swap(qe);
+        }
+
+        v_max = 0.0;
+        for(unsigned int k = 0; k < px.size(); k++)
+            v_max = max(v_max, px[k]*px[k] + py[k]*py[k]);
+        v_max = sqrt(v_max);
+        if(s >= r_max || (s*s > w_max && v_max <= (s*s - w_max)/(2.0*s))) break;
+        s = min(2.0*s, r_max);
+    }
+
+    vx[i] = px;
+    vy[i] = py;
+    edge[i] = pe;
+    nbr[i].clear();
+    areas[i] = 0.0;
+    for(unsigned int k = 0; k < px.size(); k++){
+        unsigned int l = (k + 1) % px.size();
+        areas[i] += 0.5*(px[k]*py[l] - px[l]*py[k]);
+        if(pe[k] >= 0 && find(nbr[i].begin(), nbr[i].end(), pe[k]) == nbr[i].end())
+            nbr[i].push_back(pe[k]);
+    }
+}
+
+/**
+ * Tessellate a configuration, all the cells are built.
+ *
+ * @param state The configuration.
+ */
+void    voronoi::build(config *state){
+    int     n = state->n_objects();
+
+    if(grid) delete grid;
+    grid = new cell_list(state->x_size, state->y_size,
+                         sqrt(state->area()/max(n, 1)), state->periodic());
+    state->fill_grid(grid);
+    vx.assign(n, vector<double>());
+    vy.assign(n, vector<double>());
+    edge.assign(n, vector<int>());
+    nbr.assign(n, vector<int>());
+    areas.assign(n, 0.0);
+    for(int i = 0; i < n; i++) make_cell(state, i);
+}
+
+/**
+ * @return The number of cells, the number of objects at the last build.
+ */
+int     voronoi::n_cells(){
+    return areas.size();
+}
+
+/**
+ * @param i The cell.
+ * @return  The area of the cell.
+ */
+double  voronoi::area(int i){
+    return areas[i];
+}
+
+/**
+ * @param i The cell.
+ * @return  The number of cells that share an edge with cell i.
+ */
+int     voronoi::n_neighbours(int i){
+    return nbr[i].size();
+}
+
+/**
+ * @param i The cell.
+ * @param k The neighbour, 0..n_neighbours(i)-1.
+ * @return  The index of the neighbouring object.
+ */
+int     voronoi::neighbour(int i, int k){
+    return nbr[i][k];
+}
+
+/**
+ * @param i The cell.
+ * @return  The number of vertices of the cell.
+ */
+int     voronoi::n_vertices(int i){
+    return vx[i].size();
+}
+
+/**
+ * The position of a vertex of a cell, relative to the object center and in
+ * anticlockwise order.
+ *
+ * @param i The cell.
+ * @param k The vertex, 0..n_vertices(i)-1.
+ * @param x Set to the x position.
+ * @param y Set to the y position.
+ */
+void    voronoi::vertex(int i, int k, double *x, double *y){
+    *x = vx[i][k];
+    *y = vy[i][k];
+}
@@ -0,0 +1,61 @@
+/**
+ * @file    voronoi.h
+ * @author  agent
+ * @date    October 17, 2026
+ * \brief   Header file for the voronoi class
+ *
+ * @class   voronoi voronoi.h
+ * @brief   Voronoi or radical tessellation of the object centers.
+ *
+ * The Voronoi cell of an object is the region of the plane closer to its
+ * center than to any other. In the radical (power) tessellation each object
+ * has a weight, the square of a radius depending on its type, and the
+ * boundary between two cells is shifted towards the smaller object so larger
+ * objects get larger cells. With periodic conditions the nearest images are
+ * used and the tessellation is periodic, otherwise the cells are limited by
+ * the walls of the box.
+ *
+ * Each cell is built separately by clipping a large square (or the box) with
+ * the half planes of its neighbours, taken in order of distance from a
+ * cell_list. The clipping stops when no object further away can cut the
+ * cell: for the Voronoi tessellation when the search distance is more than
+ * twice the distance from the center to the furthest vertex of the cell. The
+ * cost is proportional to the number of objects. Each cell records its
+ * vertices, its area and, for each edge, the object on the other side, so the
+ * neighbours in the tessellation are known.
+ *
+ * The tessellation needs enough objects for the cells to be smaller than half
+ * the box, so that the nearest images are the only ones that matter.
+ */
+
+#ifndef VORONOI_H
+#define VORONOI_H
+
+#include <vector>
+#include "config.h"
+
+using namespace std;
+
+class voronoi {
+public:
+    voronoi(const vector<double> &radii);   ///< Constructor with a radius per object type (empty for Voronoi).
+    virtual ~voronoi();                     ///< Destructor
+    void    build(config *state);           ///< Tessellate a configuration.
+    int     n_cells();                      ///< Number of cells.
+    double  area(int i);                    ///< Area of cell i.
+    int     n_neighbours(int i);            ///< Number of neighbours of cell i.
+    int     neighbour(int i, int k);        ///< The k'th neighbour of cell i.
+    int     n_vertices(int i);              ///< Number of vertices of cell i.
+    void    vertex(int i, int k, double *x, double *y);   ///< The k'th vertex of cell i, relative to its center.
+private:
+    void    make_cell(config *state, int i);    ///< Build cell i.
+    vector<double>  weight;                 ///< Square of the radius of each type.
+    cell_list       *grid;                  ///< Spatial index of the objects.
+    vector< vector<double> >    vx, vy;     ///< Vertices of each cell, relative to the center.
+    vector< vector<int> >       edge;       ///< Object across the edge after each vertex (-1 for a wall).
+    vector< vector<int> >       nbr;        ///< Neighbours of each cell.
+    vector<double>  areas;                  ///< Area of each cell.
+    vector<int>     found;                  ///< Work space for neighbour searches.
+};
+
+#endif /* VORONOI_H */
@@ -0,0 +1,479 @@
+/**
+ * \file    bench.cpp
+ * \author  agent
+ * \date    October 17, 2026
+ * \version 1.0
+ * \brief   Micro benchmarks of the kernels of the simulation programmes.
+ *
+ * This file contains the main routine for the bench program that is part of
+ * the Very Coarse Grained disc simulation programmes.
+ *
+ * The program times the functions that the integration spends its time in,
+ * so the effect of a change to one of them can be measured:
+ *      force_field     force_field::interaction() for each pair of the atom
+ *                      types used by the topology, at distances uniform in 0
+ *                      to the cut off plus twice the reach of the objects.
+ *      interaction     object::interaction() for each pair of object types,
+ *                      on the pairs of neighbouring objects of the
+ *                      configuration (closer than the cut off plus twice the
+ *                      reach), the second object moved to its nearest image.
+ *      distance        object::distance() with periodic boundaries between
+ *                      random objects of the configuration.
+ *      energy_full     config::energy() with all the objects to recalculate.
+ *      energy_step     config::energy() after a step of the integrator, one
+ *                      object moved and config::invalidate_within() called.
+ *      invalidate      config::invalidate_within() with the cut off.
+ *      screen          surrogate::energy_change() for random moves of random
+ *                      objects, the first stage of delayed acceptance. The
+ *                      surrogate visits only the neighbours of the object so
+ *                      the time per move should not grow with n_objects; its
+ *                      result is first checked against the sum over all the
+ *                      objects.
+ *      read            config(FILE *) from a temporary file.
+ *      write           config::write() to a temporary file.
+ *
+ * The inputs are configurations made, as by makeconfig, by random sequential
+ * adsorption in a periodic box for each number of objects and packing
+ * fraction (the area of the atom hard cores over the box area), with the
+ * object types drawn in the proportions of the mix. The random number
+ * generator is seeded before each configuration so the inputs are the same
+ * from one run to the next and independent of the other sizes.
+ *
+ * Each kernel is calibrated to run for at least the given time, then timed
+ * (processor time) the given number of repetitions. The result is written
+ * as a table, one line per kernel and input, with the median and the
+ * standard deviation over the repetitions of the time per call, and the
+ * pairs (or objects) processed per second at the median:
+ *
+ *      kernel detail n_objects packing calls ns_per_op ns_sd items_per_s unit
+ *
+ * The unit is atom_pairs, object_pairs, objects or moves. Progress is reported on the
+ * standard error stream.
+ *
+ * Usage:
+ *          bench [options] > results
+ *
+ * The options are:
+ *      --sizes n,..    The numbers of objects (100,400,1600).
+ *      --packing f,..  The packing fractions (0.1,0.2,0.3).
+ *      --mix p,..      The proportions of the object types (0.7,0.3).
+ *      --repeat n      The number of repetitions (5).
+ *      --time t        The least processor time of a repetition (0.1 s).
+ *      --seed s        The seed of the configurations (1).
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <assert.h>
+#include <vector>
+#include <algorithm>
+#include "../NVT/config.h"
+#include "../NVT/object.h"
+#include "../NVT/options.h"
+#include "../NVT/placer.h"
+#include "../NVT/surrogate.h"
+#include "../NVT/common.h"
+
+using namespace std;
+
+#define fatal_error(format, value) {\
+                    fprintf(stderr, format, value ); \
+                    usage(); \
+                    exit(EXIT_FAILURE); \
+                }
+
+#define BENCH_ATTEMPTS  10000       // Trials to place an object
+#define BENCH_POOL      4096        // Inputs cycled through by a kernel
+
+void usage(){
+    fprintf(stderr, "Usage: bench %s\n",
+        "[--sizes n,..] [--packing f,..] [--mix p,..] [--repeat n]\n"
+        "             [--time t] [--seed s] > results");
+}
+
+/**
+ * The inputs of the kernels for one configuration.
+ */
+struct bench_input {
+    config      *state;                     ///< The configuration.
+    force_field *the_forces;                ///< The force field.
+    topology    *the_topology;              ///< The object topologies.
+    int         t1, t2;                     ///< The types of the current pairs.
+    vector<double>  r;                      ///< Atom distances.
+    vector<object>  first, second;          ///< Pairs of objects, by type.
+    vector<int>     index;                  ///< Random object indices.
+    vector<object>  trial;                  ///< Moved copies of the indexed objects.
+    surrogate   *the_surrogate;             ///< Surrogate tracking the configuration.
+    FILE        *tmp;                       ///< Temporary file, one per configuration.
+    double      sink;                       ///< Results, so they are used.
+};
+
+typedef void (*kernel)(bench_input *in, long n);  ///< Make n calls.
+
+/**
+ * The timing of a kernel.
+ */
+struct bench_result {
+    long    calls;                          ///< Calls in each repetition.
+    double  median, sd;                     ///< Time per call in ns.
+};
+
+/**
+ * The kernels, each makes n calls cycling through its inputs.
+ */
+void    k_force_field(bench_input *in, long n){
+    for(long i = 0; i < n; i++)
+        in->sink += in->the_forces->interaction(in->t1, in->t2,
+                in->r[i % in->r.size()]);
+}
+
+void    k_interaction(bench_input *in, long n){
+    for(long i = 0, k; i < n; i++){
+        k = i % in->first.size();
+        in->sink += in->first[k].interaction(in->the_forces, in->the_topology,
+                &in->second[k]);
+    }
+}
+
+void    k_distance(bench_input *in, long n){
+    config  *s = in->state;
+
+    for(long i = 0; i < n; i++)
+        in->sink += s->get_object(in->index[i % in->index.size()])->distance(
+                s->get_object(in->index[(i+1) % in->index.size()]),
+                s->x_size, s->y_size, true);
+}
+
+void    k_energy_full(bench_input *in, long n){
+    for(long i = 0; i < n; i++){
+        for(int j = 0; j < in->state->n_objects(); j++)
+            in->state->get_object(j)->recalculate = true;
+        in->state->unchanged = false;
+        in->sink += in->state->energy(in->the_forces);
+    }
+}
+
+void    k_energy_step(bench_input *in, long n){
+    object  *obj;
+    int     j;
+
+    for(long i = 0; i < n; i++){            // Back and forth so the
+        j = in->index[(i/2) % in->index.size()];    // configuration stays
+        obj = in->state->get_object(j);
+        obj->pos_x += (i % 2) ? -0.01 : 0.01;
+        obj->recalculate = true;
+        in->state->invalidate_within(in->the_forces->cut_off, j);
+        in->state->unchanged = false;
+        in->sink += in->state->energy(in->the_forces);
+    }
+}
+
+void    k_invalidate(bench_input *in, long n){
+    for(long i = 0; i < n; i++)
+        in->state->invalidate_within(in->the_forces->cut_off,
+                in->index[i % in->index.size()]);
+}
+
+void    k_screen(bench_input *in, long n){
+    for(long i = 0, k; i < n; i++){
+        k = i % in->index.size();
+        in->sink += in->the_surrogate->energy_change(in->state, in->index[k],
+                &in->trial[k]);
+    }
+}
+
+void    k_read(bench_input *in, long n){
+    config  *copy;
+
+    for(long i = 0; i < n; i++){
+        rewind(in->tmp);
+        copy = new config(in->tmp);
+        assert(copy->n_objects() == in->state->n_objects());
+        in->sink += copy->n_objects();
+        delete copy;
+    }
+}
+
+void    k_write(bench_input *in, long n){
+    for(long i = 0; i < n; i++){
+        rewind(in->tmp);
+        in->sink += in->state->write(in->tmp);
+    }
+}
+
+/**
+ * @brief Processor time of n calls of a kernel.
+ * @param f     The kernel.
+ * @param in    Its inputs.
+ * @param n     The number of calls.
+ * @return      The time in seconds.
+ */
+double  run_kernel(kernel f, bench_input *in, long n){
+    clock_t start = clock();
+
+    f(in, n);
+    return (double)(clock() - start)/CLOCKS_PER_SEC;
+}
+
+/**
+ * @brief Time a kernel.
+ *
+ * The number of calls is doubled until they take a tenth of min_time, then
+ * scaled to take min_time, and the calls repeated n_repeat times.
+ *
+ * @param f         The kernel.
+ * @param in        Its inputs.
+ * @param n_repeat  The number of repetitions.
+ * @param min_time  The least time of a repetition.
+ * @return          The timing.
+ */
+bench_result    time_kernel(kernel f, bench_input *in, int n_repeat,
+                            double min_time){
+    bench_result    result;
+    vector<double>  ns;
+    double  t, mean = 0.0, var = 0.0;
+    long    n = 1;
+
+    while((t = run_kernel(f, in, n)) < 0.1*min_time) n *= 2;
+    result.calls = max(1L, (long)ceil(n*min_time/max(t, 1e-9)));
+    for(int k = 0; k < n_repeat; k++){
+        ns.push_back(1e9*run_kernel(f, in, result.calls)/result.calls);
+        mean += ns.back();
+    }
+    mean /= n_repeat;
+    for(int k = 0; k < n_repeat; k++) var += (ns[k] - mean)*(ns[k] - mean);
+    result.sd = (n_repeat > 1) ? sqrt(var/(n_repeat - 1)) : 0.0;
+    sort(ns.begin(), ns.end());
+    result.median = (n_repeat % 2) ? ns[n_repeat/2]
+                                   : 0.5*(ns[n_repeat/2 - 1] + ns[n_repeat/2]);
+    return result;
+}
+
+/**
+ * @brief Time a kernel and write its line of the table.
+ * @param name      The kernel name.
+ * @param detail    The types, or "-".
+ * @param f         The kernel.
+ * @param in        Its inputs.
+ * @param packing   The packing fraction of the configuration.
+ * @param items     Pairs or objects processed by a call.
+ * @param unit      Their name.
+ * @param n_repeat  The number of repetitions.
+ * @param min_time  The least time of a repetition.
+ */
+void    report(const char *name, const char *detail, kernel f, bench_input *in,
+               double packing, double items, const char *unit,
+               int n_repeat, double min_time){
+    bench_result    result = time_kernel(f, in, n_repeat, min_time);
+
+    printf("%s %s %d %g %ld %.4g %.3g %.4g %s\n", name, detail,
+            in->state->n_objects(), packing, result.calls, result.median,
+            result.sd, 1e9*items/result.median, unit);
+    fflush(stdout);
+}
+
+/**
+ * @brief Surrogate energy change of a move summed over all the objects.
+ * @param in    The inputs, with the surrogate.
+ * @param k     The move, in->index[k] replaced by in->trial[k].
+ * @return      The energy change.
+ */
+double  screen_all(bench_input *in, int k){
+    object  *obj, *obj2;
+    double  dx, dy, value = 0.0;
+
+    for(int i = 0; i < in->state->n_objects(); i++){
+        if(i == in->index[k]) continue;
+        obj  = in->state->get_object(in->index[k]);
+        obj2 = in->state->get_object(i);
+        in->state->image_shift(&in->trial[k], obj2, &dx, &dy);
+        dx += obj2->pos_x - in->trial[k].pos_x;
+        dy += obj2->pos_y - in->trial[k].pos_y;
+        value += in->the_surrogate->pair(obj->o_type, obj2->o_type,
+                sqrt(dx*dx + dy*dy));
+        in->state->image_shift(obj, obj2, &dx, &dy);
+        dx += obj2->pos_x - obj->pos_x;
+        dy += obj2->pos_y - obj->pos_y;
+        value -= in->the_surrogate->pair(obj->o_type, obj2->o_type,
+                sqrt(dx*dx + dy*dy));
+    }
+    return value;
+}
+
+/**
+ * Read the options, then for each size and packing fraction generate the
+ * configuration and time the kernels.
+ */
+int main(int argc, char **argv)
+{
+    int     i, n_repeat = 5, n;
+    long    seed = 1;
+    double  min_time = 0.1, reach, dx, dy, pairs;
+    char    detail[32];
+    vector<double>  sizes, packing, mix;
+    vector<int>     atom_types;
+    topology    *the_topology = new topology();
+    force_field *the_forces = new force_field();
+    placer      *the_placer = new placer(the_forces, BENCH_ATTEMPTS);
+    bench_input in;
+    object      *obj1, *obj2;
+    const char  *rest;
+
+    for(i = 1; (i < argc) && (argv[i][0] == '-') && (argv[i][1] == '-'); i++){
+        if(!strcmp(argv[i], "--sizes") && (i+1 < argc)){
+            rest = parse_list(argv[++i], sizes);
+            if(!rest || *rest) fatal_error("Bad list: %s\n", argv[i]);
+        } else if(!strcmp(argv[i], "--packing") && (i+1 < argc)){
+            rest = parse_list(argv[++i], packing);
+            if(!rest || *rest) fatal_error("Bad list: %s\n", argv[i]);
+        } else if(!strcmp(argv[i], "--mix") && (i+1 < argc)){
+            rest = parse_list(argv[++i], mix);
+            if(!rest || *rest) fatal_error("Bad list: %s\n", argv[i]);
+        } else if(!strcmp(argv[i], "--repeat") && (i+1 < argc)){
+            n_repeat = atoi(argv[++i]);
+            if(n_repeat < 1) fatal_error("Bad number of repetitions: %d\n", n_repeat);
+        } else if(!strcmp(argv[i], "--time") && (i+1 < argc)){
+            min_time = atof(argv[++i]);
+            if(min_time <= 0.0) fatal_error("Bad time: %g\n", min_time);
+        } else if(!strcmp(argv[i], "--seed") && (i+1 < argc)){
+            seed = atol(argv[++i]);
+        } else {
+            fatal_error("Unknown option or missing value: %s\n", argv[i]);
+        }
+    }
+    if( argc != i ) fatal_error("%s\n", "Wrong number of arguments");
+    if(sizes.empty()){ sizes.push_back(100); sizes.push_back(400); sizes.push_back(1600); }
+    if(packing.empty()){ packing.push_back(0.1); packing.push_back(0.2); packing.push_back(0.3); }
+    if(mix.empty()){ mix.push_back(0.7); mix.push_back(0.3); }
+    if((int)mix.size() > the_topology->n_types())
+        fatal_error("No topology for object type %d\n", (int)mix.size() - 1);
+    for(unsigned int k = 0; k < sizes.size(); k++)
+        if(sizes[k] < 2) fatal_error("Bad number of objects: %g\n", sizes[k]);
+    for(unsigned int k = 0; k < packing.size(); k++)
+        if(packing[k] <= 0.0 || packing[k] >= 1.0)
+            fatal_error("Bad packing fraction: %g\n", packing[k]);
+
+    for(unsigned int t = 0; t < mix.size(); t++)    // The atom types used
+        for(int j = 0; j < the_topology->n_atom(t); j++)
+            atom_types.push_back(the_topology->atoms(t, j)->type);
+    sort(atom_types.begin(), atom_types.end());
+    atom_types.erase(unique(atom_types.begin(), atom_types.end()), atom_types.end());
+
+    in.the_forces   = the_forces;
+    in.the_topology = the_topology;
+    in.the_surrogate = new surrogate(the_forces, the_topology);
+    in.sink = 0.0;
+
+    printf("# kernel detail n_objects packing calls ns_per_op ns_sd items_per_s unit\n");
+    for(unsigned int s = 0; s < sizes.size(); s++){
+        for(unsigned int p = 0; p < packing.size(); p++){
+            srand(seed);
+            in.state = the_placer->generate(the_topology, (int)sizes[s],
+                    packing[p], mix);
+            if(!in.state){
+                fprintf(stderr, "Random sequential adsorption jammed for %d "
+                        "objects at packing %g, skipped\n", (int)sizes[s], packing[p]);
+                continue;
+            }
+            n = in.state->n_objects();
+            fprintf(stderr, "%d objects at packing %g in a %g box\n",
+                    n, packing[p], in.state->x_size);
+            reach = in.state->reach(the_forces);
+            in.index.clear();
+            for(int k = 0; k < BENCH_POOL; k++) in.index.push_back(rand() % n);
+
+            in.r.clear();                   // force_field::interaction
+            for(int k = 0; k < BENCH_POOL; k++)
+                in.r.push_back(rnd_lin(the_forces->cut_off + 2.0*reach));
+            for(unsigned int a = 0; a < atom_types.size(); a++){
+                for(unsigned int b = a; b < atom_types.size(); b++){
+                    in.t1 = atom_types[a];
+                    in.t2 = atom_types[b];
+                    snprintf(detail, sizeof(detail), "%d-%d", in.t1, in.t2);
+                    report("force_field", detail, k_force_field, &in,
+                            packing[p], 1.0, "atom_pairs", n_repeat, min_time);
+                }
+            }
+
+            for(unsigned int a = 0; a < mix.size(); a++){   // object::interaction
+                for(unsigned int b = a; b < mix.size(); b++){
+                    in.first.clear();
+                    in.second.clear();
+                    for(int j = 0; j < n && (int)in.first.size() < BENCH_POOL; j++){
+                        obj1 = in.state->get_object(j);
+                        if(obj1->o_type != (int)a) continue;
+                        for(int k = 0; k < n && (int)in.first.size() < BENCH_POOL; k++){
+                            obj2 = in.state->get_object(k);
+                            if(k == j || obj2->o_type != (int)b) continue;
+                            if(obj1->distance(obj2, in.state->x_size,
+                                    in.state->y_size, true)
+                                    >= the_forces->cut_off + 2.0*reach) continue;
+                            in.state->image_shift(obj1, obj2, &dx, &dy);
+                            in.first.push_back(*obj1);
+                            in.second.push_back(*obj2);
+                            in.second.back().pos_x += dx;
+                            in.second.back().pos_y += dy;
+                        }
+                    }
+                    if(in.first.empty()) continue;
+                    snprintf(detail, sizeof(detail), "%d-%d", a, b);
+                    report("interaction", detail, k_interaction, &in, packing[p],
+                            the_topology->n_atom(a)*the_topology->n_atom(b),
+                            "atom_pairs", n_repeat, min_time);
+                }
+            }
+
+            report("distance", "-", k_distance, &in, packing[p], 1.0,
+                    "object_pairs", n_repeat, min_time);
+            report("energy_full", "-", k_energy_full, &in, packing[p],
+                    n*(n - 1.0), "object_pairs", n_repeat, min_time);
+            pairs = 0.0;                    // Objects recalculated by a step
+            for(int k = 0; k < BENCH_POOL; k++){
+                for(int j = 0; j < n; j++) in.state->get_object(j)->recalculate = false;
+                in.state->invalidate_within(the_forces->cut_off, in.index[k]);
+                for(int j = 0; j < n; j++)
+                    if(in.state->get_object(j)->recalculate) pairs += 1.0;
+            }
+            pairs = (1.0 + pairs/BENCH_POOL)*(n - 1.0);
+            report("energy_step", "-", k_energy_step, &in, packing[p], pairs,
+                    "object_pairs", n_repeat, min_time);
+            report("invalidate", "-", k_invalidate, &in, packing[p], n - 1.0,
+                    "object_pairs", n_repeat, min_time);
+            in.the_surrogate->track(in.state);  // surrogate::energy_change
+            in.trial.clear();
+            for(int k = 0; k < BENCH_POOL; k++){
+                in.trial.push_back(*in.state->get_object(in.index[k]));
+                in.trial.back().move(1.0, in.state->x_size, in.state->y_size, true);
+                in.trial.back().rotate(M_2PI);
+                dx = in.the_surrogate->energy_change(in.state, in.index[k],
+                        &in.trial[k]);
+                dy = screen_all(&in, k);
+                if(fabs(dx - dy) > 1e-9*max(1.0, fabs(dy)))
+                    fatal_error("Surrogate energy change differs from the sum "
+                            "over all the objects: %g\n", dx - dy);
+            }
+            report("screen", "-", k_screen, &in, packing[p], 1.0, "moves",
+                    n_repeat, min_time);
+            if(!(in.tmp = tmpfile()))       // The file read, empty
+                fatal_error("%s\n", "Unable to open a temporary file");
+            in.state->write(in.tmp);
+            fflush(in.tmp);
+            report("read", "-", k_read, &in, packing[p], n, "objects",
+                    n_repeat, min_time);
+            report("write", "-", k_write, &in, packing[p], n, "objects",
+                    n_repeat, min_time);
+            fclose(in.tmp);
+            delete in.state;
+        }
+    }
+    fprintf(stderr, "Checksum %g\n", in.sink);
+
+    delete in.the_surrogate;
+    delete the_placer;
+    delete the_forces;
+    delete the_topology;
+
+    return 0;
+}
@@ -0,0 +1,214 @@
+/**
+ * \file    compress.cpp
+ * \author  agent
+ * \date    October 17, 2026
+ * \version 1.0
+ * \brief   Compress a configuration to a target area.
+ *
+ * This file contains the main routine for the compress program that is part of
+ * the Very Coarse Grained disc simulation programmes.
+ *
+ * The program reads a dilute configuration without hard core overlaps (such as
+ * produced by makeconfig) and shrinks the box towards a target area, keeping
+ * the configuration free of overlaps. This gives dense starting points for NVT
+ * much faster than jiggling an overlapping configuration.
+ *
+ * The compression is in the spirit of the Lubachevsky-Stillinger algorithm.
+ * Each cycle:
+ * * finds, with config::contact_scale(), the smallest expansion factor at
+ *   which two hard cores would touch, and compresses the configuration with
+ *   config::expand() by most of this amount (or down to the target);
+ * * relaxes the configuration with a few sweeps of hard core Monte Carlo
+ *   (random translations and rotations rejected only on overlap) to open up
+ *   room for the next compression. The step size is adjusted to keep about
+ *   half the moves accepted.
+ *
+ * The same cell_list is used throughout, it is rescaled with the configuration
+ * and only rebuilt when its cells become smaller than the object size. If no
+ * progress is made for a number of cycles the configuration is jammed, this is
+ * reported with the density reached, the densest configuration reached is
+ * written and the program ends with EXIT_FAILURE so scripts can tell it from
+ * a compression that reached the target.
+ *
+ * Usage:
+ *          compress [--sweeps n] [--seed s] target_area < initial_config > final_config
+ *
+ * The options are:
+ *      --sweeps n      The number of relaxation sweeps between compressions (2).
+ *      --seed s        Seed for the random number generator.
+ *
+ * Progress is reported on the standard error stream.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <vector>
+#include "../NVT/config.h"
+#include "../NVT/common.h"
+
+using namespace std;
+
+#define fatal_error(format, value) {\
+                    fprintf(stderr, format, value ); \
+                    usage(); \
+                    exit(EXIT_FAILURE); \
+                }
+
+#define S_MIN       0.9             // Largest compression in one cycle
+#define USE_ROOM    0.9             // Fraction of the free room used
+#define MAX_STALL   100             // Cycles without progress before giving up
+
+void usage(){
+    fprintf(stderr, "Usage: compress %s\n",
+        "[--sweeps n] [--seed s] target_area < initial_config > final_config");
+}
+
+/**
+ * @brief Put a coordinate back into the box with periodic conditions.
+ * @param x     The coordinate.
+ * @param size  The box size in this direction.
+ * @return      The wrapped coordinate.
+ */
+double  wrap(double x, double size){
+    x = fmod(x, size);
+    if(x < 0.0) x += size;
+    return x;
+}
+
+/**
+ * @brief Hard core Monte Carlo sweeps.
+ *
+ * Each step moves a random object by a random displacement of up to 'step'
+ * in each direction and rotates it by up to 'turn'. The move is rejected only
+ * if it creates a hard core overlap. The grid is kept up to date.
+ *
+ * @param state     The configuration (periodic, no overlaps).
+ * @param forces    The force field giving the atom sizes.
+ * @param grid      A spatial index of the configuration.
+ * @param n_sweeps  The number of sweeps (each of n_objects() moves).
+ * @param step      Maximum displacement.
+ * @param turn      Maximum rotation.
+ * @return          The fraction of accepted moves.
+ */
+double  relax(config *state, force_field *forces, cell_list *grid,
+              int n_sweeps, double step, double turn){
+    int     n = state->n_objects();
+    int     i, n_good = 0;
+    object  *obj;
+    double  old_x, old_y, old_theta;
+
+    for(int k = 0; k < n_sweeps*n; k++){
+        i   = rand() % n;
+        obj = state->get_object(i);
+        old_x     = obj->pos_x;
+        old_y     = obj->pos_y;
+        old_theta = obj->orientation;
+        obj->pos_x = wrap(old_x + rnd_lin(2.0*step) - step, state->x_size);
+        obj->pos_y = wrap(old_y + rnd_lin(2.0*step) - step, state->y_size);
+        obj->orientation = wrap(old_theta + rnd_lin(2.0*turn) - turn, M_2PI);
+        if(state->overlap(forces, obj, i, grid)){
+            obj->pos_x       = old_x;       // Rejected
+            obj->pos_y       = old_y;
+            obj->orientation = old_theta;
+        } else {
+            grid->update(i, obj->pos_x, obj->pos_y);
+            obj->recalculate = true;
+            n_good++;
+        }
+    }
+    return (n_sweeps*n > 0) ? (double)n_good/(n_sweeps*n) : 0.0;
+}
+
+/**
+ * Read the options and configuration, compress it and write the result.
+ */
+int main(int argc, char **argv)
+{
+    int     i, cycle, stall;
+    int     n_sweeps = 2;
+    double  target, s, s_contact;
+    double  reach, accepted;
+    double  step, turn = 0.5;
+    bool    jammed;
+    config  *state;
+    force_field *forces = new force_field();
+    cell_list   *grid;
+    clock_t start = clock();
+
+    for(i = 1; (i < argc) && (argv[i][0] == '-') && (argv[i][1] == '-'); i++){
+        if(!strcmp(argv[i], "--sweeps") && (i+1 < argc)){
+            n_sweeps = atoi(argv[++i]);
+        } else if(!strcmp(argv[i], "--seed") && (i+1 < argc)){
+            srand(atol(argv[++i]));
+        } else {
+            fatal_error("Unknown option or missing value: %s\n", argv[i]);
+        }
+    }
+    if( argc - i != 1 ) fatal_error("%s\n", "Wrong number of arguments");
+    target = atof(argv[i]);
+    if( target <= 0.0 ) fatal_error("Bad target area: %g\n", target);
+
+    state = new config(stdin);
+    state->add_topology(new topology());
+    if(state->n_objects() < 1) fatal_error("%s\n", "Empty configuration");
+    reach = state->reach(forces);
+    step  = 0.5*reach;
+
+    grid = new cell_list(state->x_size, state->y_size, 2.0*reach,
+            state->periodic());
+    state->fill_grid(grid);
+    for(i = 0; i < state->n_objects(); i++)
+        if(state->overlap(forces, state->get_object(i), i, grid))
+            fatal_error("Object %d overlaps, the input must be overlap free\n", i);
+
+    stall  = 0;
+    jammed = false;
+    for(cycle = 0; state->area() > target*(1.0+1E-9); cycle++){
+                                            // Compress by most of the room
+        s_contact = state->contact_scale(forces, grid, S_MIN);
+        s = 1.0 - USE_ROOM*(1.0 - s_contact);
+        s = max(s, sqrt(target/state->area()));
+        if(s < 1.0){
+            state->expand(s);
+            grid->rescale(s);
+            step *= s;
+            if(min(grid->cell_x, grid->cell_y) < 2.0*reach){
+                delete grid;                // Cells too small, rebuild
+                grid = new cell_list(state->x_size, state->y_size, 2.0*reach,
+                        state->periodic());
+                state->fill_grid(grid);
+            }
+        }
+        stall = (s > 1.0 - 1E-6) ? stall+1 : 0;
+        if(stall > MAX_STALL){
+            fprintf(stderr, "Jammed at area %g density %g (target %g density "
+                    "%g) after %d cycles\n", state->area(),
+                    state->n_objects()/state->area(), target,
+                    state->n_objects()/target, cycle);
+            jammed = true;
+            break;
+        }
+                                            // Relax to make room
+        accepted = relax(state, forces, grid, n_sweeps, step, turn);
+        if(accepted < 0.4){ step *= 0.7; turn *= 0.7; }
+        if(accepted > 0.6){ step = min(step*1.3, reach); turn = min(turn*1.3, M_PI); }
+
+        if(cycle % 10 == 0)
+            fprintf(stderr, "Cycle %d area %g density %g accepted %g step %g\n",
+                    cycle, state->area(), state->n_objects()/state->area(),
+                    accepted, step);
+    }
+
+    fprintf(stderr, "Final area %g density %g after %d cycles in %g s\n",
+            state->area(), state->n_objects()/state->area(), cycle,
+            (double)(clock()-start)/CLOCKS_PER_SEC);
+    state->write(stdout);
+
+    delete grid;
+    delete forces;
+    delete state;
+
+    return jammed ? EXIT_FAILURE : 0;
+}
@@ -15,26 +15,56 @@
  * the output area.
  *
  * Usage:
- *          config2eps < config_file > eps_file.
+ *          config2eps [--window x0 y0 x1 y1] [--zoom factor] < config_file > eps_file.
+ *
+ * With --window only the region x0..x1, y0..y1 of the configuration (which may
+ * extend beyond the box, when periodic images are drawn) is shown, the figure
+ * is the shape of the window and the bounding box is set accordingly. The
+ * objects to draw are found with a cell_list so the cost of drawing a small
+ * window does not depend on the size of the configuration. Otherwise the
+ * figure is the shape of the box. The zoom factor multiplies the scale, by
+ * default the largest side of the box (or window) is 8 cm.
+ *
+ * Batch usage:
+ *          config2eps [options] --batch prefix [--threads n] [config_file ...]
+ *
+ * In batch mode each frame of a trajectory read from the input (configurations
+ * one after another in the same file), or each of the configuration files
+ * given, is drawn to the file prefix_NNNNN.eps numbered from 0 in the input
+ * order. The frames are drawn concurrently by n threads (by default one per
+ * processor) while the input is read. All the frames use the same scale,
+ * set by the window or by the box of the first frame, so they can be
+ * assembled into a movie. A file that cannot be opened or read is reported
+ * and skipped, its number is not reused and the program ends with an error.
+ * A truncated or malformed frame of a trajectory is reported, ends the input
+ * and the program ends with an error.
  *
- * \todo        Non square areas scaled correctly.
  * \todo        More control on preamble and ending of output.
  */
 
 #include <cstdlib>
+#include <cstring>
+#include <cctype>
 #include <string>
 #include <iostream>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <math.h>
 #include "../NVT/config.h"
+#include "../NVT/common.h"
 
 using namespace std;
 
-string preamble = ""
+string header = ""
 "%!PS-Adobe-2.0 EPSF-1.2 \n"
 "%%Title: Postscript figure for configuration \n"
 "%%Creator: James \n"
 "%%CreationDate: Today \n"
-"%%DocumentFonts: (atend) \n"
-"%%BoundingBox: 0 0 227 227 \n"
+"%%DocumentFonts: (atend) \n";
+
+string prolog = ""
 "%%EndComments \n"
 " \n"
 "/mydict 128 dict def \n"
@@ -136,19 +166,21 @@ string preamble = ""
 "newpath \n"
 " \n"
 "0.005 UL		% set standard line width \n"
-"LTb			% set line colour, width and dash. \n"
+"LTb			% set line colour, width and dash. \n";
+
+string frame = ""                           // Format for the width and height
 " 0 0   moveto		% draw bounding box \n"
-" 8 0  lineto \n"
-" 8 8  lineto \n"
-" 0 8  lineto \n"
+" %g 0  lineto \n"
+" %g %g  lineto \n"
+" 0 %g  lineto \n"
 "closepath \n"
 "stroke \n"
 " \n"
 "newpath \n"
 "0  0  moveto		% and again bounding box \n"
-"8  0  lineto \n"
-"8  8  lineto \n"
-"0  8  lineto \n"
+"%g  0  lineto \n"
+"%g  %g  lineto \n"
+"0  %g  lineto \n"
 "closepath \n"
 "clip \n"
 " \n"
@@ -164,26 +196,321 @@ string ending = ""
 "%%DocumentFonts: Helvetica \n"
 "%%Pages: 1 \n";
 
+#define fatal_error(format, value) {\
+                    fprintf(stderr, format, value ); \
+                    usage(); \
+                    exit(EXIT_FAILURE); \
+                }
+
+#define CM_TO_PT    28.3            // Postscript points per cm (see prolog)
+#define FIG_SIZE    8.0             // Size of the figure in cm (without zoom)
+
+void usage(){
+    fprintf(stderr, "Usage: config2eps %s\n",
+        "[--window x0 y0 x1 y1] [--zoom factor] < config_file > eps_file\n"
+        "   or: config2eps [--window x0 y0 x1 y1] [--zoom factor] "
+        "--batch prefix [--threads n] [config_file ...]");
+}
+
+/**
+ * @brief Write an eps figure of a configuration.
+ *
+ * @param dest      The file to write to (opened for writing).
+ * @param state     The configuration (with a topology).
+ * @param forces    The force field giving atom sizes and colors.
+ * @param scale     Figure cm per unit of length in the configuration.
+ * @param window    If true only the window x0, y0, x1, y1 is drawn.
+ * @param grid      Spatial index used for the window, can be NULL otherwise.
+ */
+void write_eps(FILE *dest, config *state, force_field *forces, double scale,
+               bool window, double x0, double y0, double x1, double y1,
+               cell_list *grid){
+    double  width, height;
+
+    if(window){                             // Figure size in cm
+        width  = (x1-x0)*scale;
+        height = (y1-y0)*scale;
+    } else {
+        width  = state->x_size*scale;
+        height = state->y_size*scale;
+    }
+
+    fputs(header.c_str(), dest);
+    fprintf(dest, "%%%%BoundingBox: 0 0 %d %d \n",
+            (int)ceil(width*CM_TO_PT), (int)ceil(height*CM_TO_PT));
+    fputs(prolog.c_str(), dest);
+    fprintf(dest, frame.c_str(), width, width, height, height,
+            width, width, height, height);
+    fprintf(dest, "%g dup scale \n", scale);
+    fprintf(dest, "%g UL\n", 0.5/scale);
+    if(window){
+        fprintf(dest, "%g %g translate \n", -x0, -y0);
+        state->fill_grid(grid);
+        state->ps_window(forces, dest, x0, y0, x1, y1, grid);
+    } else {
+        state->ps_atoms(forces, dest);
+    }
+    fputs(ending.c_str(), dest);
+}
+
+/**
+ * \brief A bounded queue of frames shared by the reader and the workers.
+ *
+ * The reader pushes frames (configurations with their sequence number) and
+ * the workers pop them. The queue holds at most 'limit' frames so that the
+ * reader does not get too far ahead of the workers when frames are large.
+ */
+struct frame_queue {
+    deque<pair<int, config *> > frames;     ///< Frames waiting to be drawn.
+    size_t              limit;              ///< Maximum number of waiting frames.
+    bool                done;               ///< No more frames will be pushed.
+    mutex               lock;               ///< Protects the queue.
+    condition_variable  changed;            ///< Signalled on push, pop and done.
+};
+
+/**
+ * @brief Worker thread drawing frames from the queue until it is empty.
+ *
+ * Each worker reuses its output buffer and spatial index for all the
+ * frames it draws. The index is only rebuilt if the box size changes.
+ */
+void batch_worker(frame_queue *queue, const char *prefix, force_field *forces,
+                  double scale, bool window,
+                  double x0, double y0, double x1, double y1){
+    vector<char>    buffer(1 << 20);
+    cell_list       *grid = (cell_list *)NULL;
+    pair<int, config *> frame;
+    char            fname[FILENAME_MAX];
+    FILE            *dest;
+
+    for(;;){
+        {
+            unique_lock<mutex> guard(queue->lock);
+            while(queue->frames.empty() && !queue->done)
+                queue->changed.wait(guard);
+            if(queue->frames.empty()) break;
+            frame = queue->frames.front();
+            queue->frames.pop_front();
+            queue->changed.notify_all();
+        }
+
+        if(window && (!grid || grid->x_size != frame.second->x_size
+                            || grid->y_size != frame.second->y_size)){
+            if(grid) delete grid;
+            grid = new cell_list(frame.second->x_size, frame.second->y_size,
+                    2.0*forces->cut_off, frame.second->periodic());
+        }
+
+        snprintf(fname, FILENAME_MAX, "%s_%05d.eps", prefix, frame.first);
+        if(!(dest = fopen(fname, "w"))){
+            fprintf(stderr, "Unable to open %s for writing\n", fname);
+        } else {
+            setvbuf(dest, &buffer[0], _IOFBF, buffer.size());
+            write_eps(dest, frame.second, forces, scale,
+                      window, x0, y0, x1, y1, grid);
+            fclose(dest);
+        }
+        delete frame.second;
+    }
+    if(grid) delete grid;
+}
+
+/**
+ * @brief Is there another frame in a trajectory file?
+ *
+ * Skips white space and checks for the end of the file.
+ *
+ * @param src   The trajectory file.
+ * @return      True if there is more to read.
+ */
+bool more_frames(FILE *src){
+    int     c;
+
+    while(isspace(c = fgetc(src)));
+    if(c == EOF) return false;
+    ungetc(c, src);
+    return true;
+}
+
 /**
+ * @brief Read one frame of a trajectory or a configuration file.
+ *
+ * The format is that of config(FILE *), but each value is checked so a
+ * truncated or malformed frame is detected instead of being read as
+ * garbage.
  *
+ * @param src   The file.
+ * @return      The configuration, with its topology, or NULL if malformed.
+ */
+config *read_frame(FILE *src){
+    config  *frame = new config();
+    double  x_pos, y_pos, angle;
+    int     n_obj, o_type;
+
+    if(fscanf(src, "%lf %lf %d", &frame->x_size, &frame->y_size, &n_obj) != 3
+            || n_obj < 0){
+        delete frame;
+        return (config *)NULL;
+    }
+    for(int i = 0; i < n_obj; i++){
+        if(fscanf(src, "%d %lf %lf %lf", &o_type, &x_pos, &y_pos, &angle) != 4){
+            delete frame;
+            return (config *)NULL;
+        }
+        frame->add_object(new object(o_type, x_pos, y_pos, angle));
+    }
+    frame->set_periodic(true);
+    frame->add_topology(new topology());
+    return frame;
+}
+
+/**
+ * @brief Draw all the frames of a trajectory, or a list of files, on threads.
+ *
+ * The frames are read in order by the calling thread and drawn by n_threads
+ * workers. The scale is fixed by the window, or by the box of the first
+ * frame, so all the images are drawn at the same scale. The output files
+ * are numbered by the position of the frame in the input, a file that
+ * cannot be opened or read is reported and skipped without changing the
+ * numbering. A malformed frame in a trajectory is reported and ends it, as
+ * the next frame cannot be found.
+ *
+ * @param n_files   Number of configuration files (0 to read a trajectory).
+ * @param files     The configuration file names.
+ * @return          The number of files or frames that could not be read.
+ */
+int batch(int n_files, char **files, const char *prefix, int n_threads,
+          force_field *forces, double zoom, bool window,
+          double x0, double y0, double x1, double y1){
+    frame_queue     queue;
+    vector<thread>  workers;
+    config          *frame;
+    FILE            *src = stdin;
+    double          scale = 0.0;
+    int             n = 0, n_bad = 0;
+
+    queue.limit = 2*n_threads;
+    queue.done  = false;
+    if(window) scale = zoom*FIG_SIZE/max(x1-x0, y1-y0);
+
+    for(;;){                                // Read the next frame
+        if(n_files > 0){
+            if(n >= n_files) break;
+            if(!(src = fopen(files[n], "r"))){
+                fprintf(stderr, "Unable to open %s for reading, skipped\n",
+                        files[n]);
+                n++;                        // Keep the numbering of the others
+                n_bad++;
+                continue;
+            }
+        } else if(!more_frames(src)) break;
+        frame = read_frame(src);
+        if(n_files > 0){
+            fclose(src);
+            if(!frame){
+                fprintf(stderr, "Malformed configuration in %s, skipped\n",
+                        files[n]);
+                n++;
+                n_bad++;
+                continue;
+            }
+        } else if(!frame){
+            fprintf(stderr, "Frame %d of the trajectory is truncated or "
+                    "malformed, the rest is ignored\n", n);
+            n_bad++;
+            break;
+        }
+
+        if(workers.empty()){                // Fix the scale and start the
+            if(!window)                     // workers on the first frame.
+                scale = zoom*FIG_SIZE/max(frame->x_size, frame->y_size);
+            for(int i = 0; i < n_threads; i++)
+                workers.push_back(thread(batch_worker, &queue, prefix, forces,
+                        scale, window, x0, y0, x1, y1));
+        }
+
+        unique_lock<mutex> guard(queue.lock);
+        while(queue.frames.size() >= queue.limit) queue.changed.wait(guard);
+        queue.frames.push_back(make_pair(n++, frame));
+        queue.changed.notify_all();
+    }
+
+    {
+        lock_guard<mutex> guard(queue.lock);
+        queue.done = true;
+        queue.changed.notify_all();
+    }
+    for(unsigned int i = 0; i < workers.size(); i++) workers[i].join();
+    return n_bad;
+}
+
+/**
+ * Read the options, the configuration from the standard input and write the
+ * figure to the standard output. In batch mode read a trajectory, or the
+ * configuration files given, and write one figure per frame.
  */
 int main(int argc, char** argv) {
-    topology    *a_topology    = new topology();
-    config      *current_state = new config(stdin);
+    topology    *a_topology;
+    config      *current_state;
     force_field *the_forces    = new force_field();
+    cell_list   *grid          = (cell_list *)NULL;
     double      scale;
+    double      zoom = 1.0;
+    double      x0 = 0.0, y0 = 0.0, x1 = 0.0, y1 = 0.0;
+    bool        window = false;
+    char        *prefix = (char *)NULL;
+    int         n_threads = thread::hardware_concurrency();
+    int         i, n_bad;
+
+    for(i = 1; i < argc; i++){
+        if(!strcmp(argv[i], "--window")){
+            if(i+4 >= argc) fatal_error("%s\n", "--window needs 4 values");
+            x0 = atof(argv[++i]);
+            y0 = atof(argv[++i]);
+            x1 = atof(argv[++i]);
+            y1 = atof(argv[++i]);
+            if((x1 <= x0) || (y1 <= y0))
+                fatal_error("%s\n", "Empty window");
+            window = true;
+        } else if(!strcmp(argv[i], "--zoom")){
+            if(i+1 >= argc) fatal_error("%s\n", "--zoom needs a value");
+            zoom = atof(argv[++i]);
+            if(zoom <= 0.0) fatal_error("Bad zoom factor: %g\n", zoom);
+        } else if(!strcmp(argv[i], "--batch")){
+            if(i+1 >= argc) fatal_error("%s\n", "--batch needs a prefix");
+            prefix = argv[++i];
+        } else if(!strcmp(argv[i], "--threads")){
+            if(i+1 >= argc) fatal_error("%s\n", "--threads needs a value");
+            n_threads = atoi(argv[++i]);
+        } else if(argv[i][0] == '-'){
+            fatal_error("Unknown option: %s\n", argv[i]);
+        } else break;                       // Start of the file list
+    }
+
+    if(prefix){
+        if(n_threads < 1) n_threads = 1;
+        n_bad = batch(argc-i, argv+i, prefix, n_threads, the_forces,
+                zoom, window, x0, y0, x1, y1);
+        delete the_forces;
+        return n_bad ? EXIT_FAILURE : 0;
+    }
+    if(i < argc) fatal_error("Files only used with --batch: %s\n", argv[i]);
 
+    a_topology    = new topology();
+    current_state = new config(stdin);
     current_state->add_topology(a_topology);
-    scale = 8.0/max(current_state->x_size,current_state->y_size);
+    if(window){                             // Index with cells of about the
+        scale = zoom*FIG_SIZE/max(x1-x0, y1-y0);    // object size.
+        grid  = new cell_list(current_state->x_size, current_state->y_size,
+                2.0*the_forces->cut_off, current_state->periodic());
+    } else {
+        scale = zoom*FIG_SIZE/max(current_state->x_size,current_state->y_size);
+    }
 
-    cout << preamble;
-    cout << scale;
-    cout << " dup scale \n";
-    cout << 0.5/scale;
-    cout << " UL\n";
-    current_state->ps_atoms(the_forces, stdout);
-    cout << ending;
+    write_eps(stdout, current_state, the_forces, scale,
+              window, x0, y0, x1, y1, grid);
 
+    if(grid) delete grid;
     delete the_forces;
     delete current_state;
 
@@ -0,0 +1,366 @@
+/**
+ * \file    ffreweight.cpp
+ * \author  agent
+ * \date    October 17, 2026
+ * \version 1.0
+ * \brief   Estimate averages for other force field parameters by reweighting.
+ *
+ * This file contains the main routine for the ffreweight program that is part
+ * of the Very Coarse Grained disc simulation programmes.
+ *
+ * When the force field parameters are tuned, for example the well depths, a
+ * new simulation for each candidate set is expensive. For sets close to the
+ * one simulated the configurations already sampled are enough: each
+ * configuration n of a run at beta with the reference energy U_0 is weighted
+ * by exp(-beta (U_s(n) - U_0(n))) to give averages for the parameter set s.
+ *
+ * The program reads the configurations stored by NVT (option --trajectory)
+ * and the parameter sets, and evaluates the energy of every configuration
+ * with every set. The geometry is the same for all the sets, so for each
+ * configuration the atom pairs that can interact with any of the sets are
+ * found once, with a cell_list, and their types and distances are kept. The
+ * energies for all the sets are then sums over this list. Without periodic
+ * conditions the energy of each object with the walls, which depends on the
+ * atom radii, is added with each set as config::energy() does. The
+ * configurations are shared between threads.
+ *
+ * For each set the output gives:
+ * * the free energy difference with the reference, from the exponential
+ *   average of the energy difference (Zwanzig 1954), and the mean energy
+ *   difference;
+ * * the effective number of configurations (sum w)^2 / sum w^2 and its
+ *   fraction of the configurations. When this fraction is below --min-ess the
+ *   two ensembles overlap too little for the estimates to be trusted, and a
+ *   warning is written;
+ * * the reweighted mean energy and, if a frames file of the same run (option
+ *   --frames of NVT) is given, the reweighted mean of each of its
+ *   observables. The errors are those of a weighted mean of independent
+ *   samples, so they are too small if the configurations are correlated.
+ *
+ * The first line of the output is the reference set itself. The reference
+ * energies are compared with those of the frames file, if any, to check that
+ * the reference is the force field that was simulated.
+ *
+ * Usage:
+ *          ffreweight [options] beta parameter_sets < trajectory > estimates
+ *
+ * The options are:
+ *      --reference file    Parameters used for the simulation, if not the
+ *                      default force field (see force_field::read()).
+ *      --frames file   The frames file of the run, for the observables.
+ *      --min-ess f     Fraction of effective configurations below which the
+ *                      overlap is too poor (0.1).
+ *      --threads n     The number of threads (1).
+ *
+ * The parameter sets file holds the sets one after the other, each ends with
+ * a line "end" (see force_field::read()), only the parameters that differ
+ * from the reference need to be given. Progress is reported on the standard
+ * error stream.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <vector>
+#include <string>
+#include <thread>
+#include "../NVT/config.h"
+#include "../NVT/common.h"
+
+using namespace std;
+
+#define fatal_error(format, value) {\
+                    fprintf(stderr, format, value ); \
+                    usage(); \
+                    exit(EXIT_FAILURE); \
+                }
+
+#define FF_LINE         4096        // Longest line of a frames file
+#define FF_CHECK        1E-3        // Relative energy difference to report
+
+void usage(){
+    fprintf(stderr, "Usage: ffreweight %s\n",
+        "[--reference file] [--frames file] [--min-ess f] [--threads n]\n"
+        "           beta parameter_sets < trajectory > estimates");
+}
+
+/**
+ * A pair of atoms that may interact.
+ */
+struct atom_pair {
+    int     t1, t2;                         ///< The atom types.
+    double  r;                              ///< Their distance.
+};
+
+/**
+ * @brief Find the pairs of atoms of different objects closer than a range.
+ *
+ * Each pair of objects is counted once, with the periodic image closest to
+ * the first object, as in config::energy().
+ *
+ * @param state     The configuration, with its topology.
+ * @param r_atom    The range of the atom pairs.
+ * @param r_object  The range of the object pairs (r_atom plus the extents).
+ * @param pairs     Set to the pairs.
+ */
+void    find_pairs(config *state, double r_atom, double r_object,
+                   vector<atom_pair> &pairs){
+    topology    *the_topology = state->get_topology();
+    cell_list   grid(state->x_size, state->y_size, r_object, state->periodic());
+    vector<int> found;
+    object      *obj1, *obj2;
+    atom        *at1, *at2;
+    atom_pair   p;
+    double      dx, dy, x1, y1, x2, y2;
+
+    pairs.clear();
+    state->fill_grid(&grid);
+    for(int i = 0; i < state->n_objects(); i++){
+        obj1 = state->get_object(i);
+        grid.neighbours(obj1->pos_x, obj1->pos_y, r_object, found);
+        for(unsigned int k = 0; k < found.size(); k++){
+            if(found[k] <= i) continue;
+            obj2 = state->get_object(found[k]);
+            state->image_shift(obj1, obj2, &dx, &dy);
+            dx += obj2->pos_x - obj1->pos_x;
+            dy += obj2->pos_y - obj1->pos_y;
+            if(dx*dx + dy*dy >= r_object*r_object) continue;
+            for(int a = 0; a < the_topology->n_atom(obj1->o_type); a++){
+                at1 = the_topology->atoms(obj1->o_type, a);
+                x1 = cos(obj1->orientation)*at1->x_pos - sin(obj1->orientation)*at1->y_pos;
+                y1 = sin(obj1->orientation)*at1->x_pos + cos(obj1->orientation)*at1->y_pos;
+                for(int b = 0; b < the_topology->n_atom(obj2->o_type); b++){
+                    at2 = the_topology->atoms(obj2->o_type, b);
+                    x2 = dx + cos(obj2->orientation)*at2->x_pos
+                            - sin(obj2->orientation)*at2->y_pos;
+                    y2 = dy + sin(obj2->orientation)*at2->x_pos
+                            + cos(obj2->orientation)*at2->y_pos;
+                    p.r = sqrt((x2-x1)*(x2-x1) + (y2-y1)*(y2-y1));
+                    if(p.r >= r_atom) continue;
+                    p.t1 = at1->type;
+                    p.t2 = at2->type;
+                    pairs.push_back(p);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Energies of one configuration with all the parameter sets.
+ *
+ * The pair energies and, without periodic conditions, the wall energies
+ * (half of object::box_energy() for each object, as config::energy() counts
+ * them).
+ *
+ * @param state     The configuration.
+ * @param sets      The force fields, the reference first.
+ * @param r_atom    The range of the atom pairs.
+ * @param r_object  The range of the object pairs.
+ * @param energy    Set to the energy with each set.
+ */
+void    evaluate(config *state, vector<force_field *> *sets, double r_atom,
+                 double r_object, double *energy){
+    vector<atom_pair>   pairs;
+    topology    *the_topology = state->get_topology();
+
+    find_pairs(state, r_atom, r_object, pairs);
+    for(unsigned int s = 0; s < sets->size(); s++){
+        energy[s] = 0.0;
+        for(unsigned int k = 0; k < pairs.size(); k++)
+            energy[s] += (*sets)[s]->interaction(pairs[k].t1, pairs[k].t2,
+                    pairs[k].r);
+        if(!state->periodic())              // The walls
+            for(int i = 0; i < state->n_objects(); i++)
+                energy[s] += 0.5*state->get_object(i)->box_energy((*sets)[s],
+                        the_topology, state->x_size, state->y_size);
+    }
+}
+
+/**
+ * @brief Read the observables of a frames file written by NVT.
+ * @param fname The file name.
+ * @param names Set to the names of the values, the energy first.
+ * @param n_val Set to the number of values per sample.
+ * @param values    Set to the values.
+ */
+void    read_frames(const char *fname, vector<string> &names, int *n_val,
+                    vector<double> &values){
+    FILE    *src;
+    char    line[FF_LINE], *p, *tok;
+    double  value;
+    int     n;
+
+    if(! (src = fopen(fname, "r")))
+        fatal_error("Unable to open %s for reading\n", fname);
+    if(! fgets(line, FF_LINE, src) || strncmp(line, "# frames", 8))
+        fatal_error("Not a frames file: %s\n", fname);
+    if(! fgets(line, FF_LINE, src) || line[0] != '#')
+        fatal_error("No value names in %s\n", fname);
+    for(tok = strtok(line+1, " \t\n"); tok; tok = strtok(NULL, " \t\n"))
+        names.push_back(tok);
+    *n_val = names.size();
+    while(fgets(line, FF_LINE, src)){
+        if(line[0] == '#') continue;
+        for(p = line, n = 0; n < *n_val; n++){
+            value = strtod(p, &tok);
+            if(tok == p) break;
+            values.push_back(value);
+            p = tok;
+        }
+        if(n != 0 && n != *n_val)
+            fatal_error("Incomplete sample in %s\n", fname);
+    }
+    fclose(src);
+}
+
+/**
+ * Read the options, parameter sets and trajectory, evaluate the energies and
+ * write the estimates.
+ */
+int main(int argc, char **argv)
+{
+    int     i, n_threads = 1, n_val = 0, n_conf, n_sets, c;
+    double  beta, min_ess = 0.1, r_atom = 0.0, r_object, extent = 0.0;
+    double  ess, w, w_sum, w2_sum, top, dev;
+    FILE    *src;
+    char    *frames_file = NULL;
+    force_field *reference = new force_field(), *forces;
+    topology    *the_topology = new topology();
+    vector<force_field *>   sets;
+    vector<config *>    batch;
+    vector<thread>  workers;
+    vector<double>  energy, values, log_w, mean;
+    vector<string>  names;
+    clock_t start = clock();
+
+    for(i = 1; (i < argc) && (argv[i][0] == '-') && (argv[i][1] == '-'); i++){
+        if(!strcmp(argv[i], "--reference") && (i+1 < argc)){
+            if(! (src = fopen(argv[++i], "r")))
+                fatal_error("Unable to open %s for reading\n", argv[i]);
+            if(reference->read(src) < 0)
+                fatal_error("Bad force field file %s\n", argv[i]);
+            fclose(src);
+        } else if(!strcmp(argv[i], "--frames") && (i+1 < argc)){
+            frames_file = argv[++i];
+        } else if(!strcmp(argv[i], "--min-ess") && (i+1 < argc)){
+            min_ess = atof(argv[++i]);
+            if(min_ess < 0.0 || min_ess > 1.0)
+                fatal_error("Bad effective fraction: %g\n", min_ess);
+        } else if(!strcmp(argv[i], "--threads") && (i+1 < argc)){
+            n_threads = atoi(argv[++i]);
+            if(n_threads < 1) fatal_error("Bad number of threads: %d\n", n_threads);
+        } else {
+            fatal_error("Unknown option or missing value: %s\n", argv[i]);
+        }
+    }
+    if( argc - i != 2 ) fatal_error("%s\n", "Wrong number of arguments");
+    beta = atof(argv[i]);
+    if( beta <= 0.0 ) fatal_error("Bad beta: %g\n", beta);
+
+    sets.push_back(reference);              // The parameter sets
+    if(! (src = fopen(argv[i+1], "r")))
+        fatal_error("Unable to open %s for reading\n", argv[i+1]);
+    for(;;){
+        forces = new force_field(*reference);
+        c = forces->read(src);
+        if(c < 0) fatal_error("Bad parameter set %d\n", (int)sets.size());
+        if(c == 0 && feof(src)){ delete forces; break; }
+        sets.push_back(forces);
+    }
+    fclose(src);
+    n_sets = sets.size();
+    if(n_sets < 2) fatal_error("%s\n", "No parameter sets");
+
+    for(int s = 0; s < n_sets; s++)         // Range of the interactions
+        for(int t1 = 0; t1 < sets[s]->n_atom_types(); t1++)
+            for(int t2 = 0; t2 < sets[s]->n_atom_types(); t2++)
+                r_atom = max(r_atom, sets[s]->range(t1, t2));
+    for(int t = 0; t < the_topology->n_types(); t++)
+        extent = max(extent, the_topology->extent(t));
+    r_object = r_atom + 2.0*extent;
+
+    for(n_conf = 0; ; ){                    // Energies, n_threads at a time
+        while((int)batch.size() < n_threads){
+            while((c = fgetc(stdin)) != EOF && (c == ' ' || c == '\n'));
+            if(c == EOF) break;
+            ungetc(c, stdin);
+            batch.push_back(new config(stdin));
+            batch.back()->add_topology(new topology(the_topology));
+        }
+        if(batch.empty()) break;
+        energy.resize((n_conf + batch.size())*n_sets);
+        for(unsigned int t = 1; t < batch.size(); t++)
+            workers.push_back(thread(evaluate, batch[t], &sets, r_atom,
+                    r_object, &energy[(n_conf + t)*n_sets]));
+        evaluate(batch[0], &sets, r_atom, r_object, &energy[n_conf*n_sets]);
+        for(unsigned int t = 0; t < workers.size(); t++) workers[t].join();
+        workers.clear();
+        n_conf += batch.size();
+        for(unsigned int t = 0; t < batch.size(); t++) delete batch[t];
+        batch.clear();
+    }
+    if(n_conf < 1) fatal_error("%s\n", "No configurations");
+    fprintf(stderr, "Evaluated %d configurations with %d parameter sets in %g s\n",
+            n_conf, n_sets, (double)(clock()-start)/CLOCKS_PER_SEC);
+
+    if(frames_file){                        // Observables of the same samples
+        read_frames(frames_file, names, &n_val, values);
+        if((int)values.size() != n_conf*n_val)
+            fatal_error("The frames file %s does not match the trajectory\n",
+                    frames_file);
+        c = 0;
+        for(int n = 0; n < n_conf; n++)
+            if(fabs(values[n*n_val] - energy[n*n_sets])
+                    > FF_CHECK*max(1.0, fabs(values[n*n_val]))) c++;
+        if(c) fprintf(stderr, "Warning: %d reference energies differ from "
+                "those of the frames file, is the reference right?\n", c);
+    }
+
+    printf("# set delta_f mean_du ess ess_fraction energy d_energy");
+    for(int k = 1; k < n_val; k++)
+        printf(" %s d_%s", names[k].c_str(), names[k].c_str());
+    printf("\n");
+    log_w.resize(n_conf);
+    for(int s = 0; s < n_sets; s++){
+        top = -HUGE_VAL;                    // Weights of the configurations
+        mean.assign(max(n_val, 1) + 1, 0.0);
+        for(int n = 0; n < n_conf; n++){
+            log_w[n] = -beta*(energy[n*n_sets+s] - energy[n*n_sets]);
+            top = max(top, log_w[n]);
+            mean[0] += energy[n*n_sets+s] - energy[n*n_sets];
+        }
+        w_sum = w2_sum = 0.0;
+        for(int n = 0; n < n_conf; n++){
+            w = exp(log_w[n] - top);
+            w_sum  += w;
+            w2_sum += w*w;
+            mean[1] += w*energy[n*n_sets+s];
+            for(int k = 1; k < n_val; k++) mean[k+1] += w*values[n*n_val+k];
+        }
+        ess = w_sum*w_sum/w2_sum;
+        printf("%d %g %g %g %g", s, s ? -(top + log(w_sum/n_conf))/beta : 0.0,
+                mean[0]/n_conf, ess, ess/n_conf);
+        for(int k = 0; k < max(n_val, 1); k++){
+            mean[k+1] /= w_sum;
+            dev = 0.0;
+            for(int n = 0; n < n_conf; n++){
+                w = exp(log_w[n] - top)/w_sum;
+                double  x = (k == 0) ? energy[n*n_sets+s] : values[n*n_val+k];
+                dev += w*w*(x - mean[k+1])*(x - mean[k+1]);
+            }
+            printf(" %g %g", mean[k+1], sqrt(dev));
+        }
+        printf("\n");
+        if(ess < min_ess*n_conf)
+            fprintf(stderr, "Warning: set %d has %g effective configurations "
+                    "of %d, the overlap with the reference is too poor\n",
+                    s, ess, n_conf);
+    }
+
+    for(int s = 0; s < n_sets; s++) delete sets[s];
+    delete the_topology;
+
+    return 0;
+}
@@ -0,0 +1,421 @@
+/**
+ * \file    ibi.cpp
+ * \author  agent
+ * \date    October 17, 2026
+ * \version 1.0
+ * \brief   Fit tabulated pair potentials to target pair correlation functions.
+ *
+ * This file contains the main routine for the ibi program that is part of the
+ * Very Coarse Grained disc simulation programmes.
+ *
+ * The force field is fitted to measured pair correlation functions, for
+ * example those of AFM images, by iterative Boltzmann inversion (Reith, Putz
+ * and Muller-Plathe 2003). The potentials between the pairs of atom types
+ * that have a target are replaced by tables (see force_field), that start as
+ * the current potentials, and each iteration:
+ * * runs a short NVT Monte Carlo simulation, warm started from the final
+ *   configuration of the previous iteration, and accumulates the partial
+ *   pair correlation functions g(r) of the atoms of different objects after
+ *   a few equilibration sweeps;
+ * * updates each table, at the distances outside the hard core where both
+ *   g(r) and the target are above G_MIN, by
+ *
+ *      u(r) += mix kT ln(g(r) / g_target(r))
+ *
+ *   the update is smoothed over three points and the table shifted so it is
+ *   zero at its end.
+ * The log gives, for each iteration and pair, the root mean squared
+ * difference between g(r) and the target.
+ *
+ * For objects made of a single atom, such as discs, the atom g(r) is the g(r)
+ * of the object centers, the one measured experimentally.
+ *
+ * The same cell_list is used for all the samples of all the iterations, only
+ * the positions of the objects are updated. The pairs of objects are shared
+ * between threads, each with its own histograms.
+ *
+ * Usage:
+ *          ibi [options] beta initial_config final_config final_forces
+ *
+ * The options are:
+ *      --target t1 t2 file The target g(r) between atom types t1 and t2, a
+ *                      file of lines "r g" (lines starting with # are
+ *                      comments). At least one is needed, they can be
+ *                      repeated for other pairs.
+ *      --forces file   Starting force field parameters (see
+ *                      force_field::read()).
+ *      --iterations n  The number of iterations (10).
+ *      --sweeps n      Sweeps of the simulation of each iteration (100).
+ *      --equilibrate n Sweeps before the g(r) is accumulated (20).
+ *      --range r       Range of the tables (the last target distance, at
+ *                      most the cut off).
+ *      --bin dr        Distance step of the tables and g(r) (0.05).
+ *      --mix a         Fraction of the Boltzmann inversion applied (0.5).
+ *      --gr file       Write the g(r) and targets of the last iteration.
+ *      --threads n     The number of threads for g(r) (1).
+ *
+ * The final force field parameters, in the force_field::read() format, are
+ * written after each iteration and can be given to NVT with its --forces
+ * option. The log is written to the standard output stream.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <vector>
+#include <thread>
+#include "../NVT/integrator.h"
+#include "../NVT/relaxer.h"
+#include "../NVT/common.h"
+
+using namespace std;
+
+#define fatal_error(format, value) {\
+                    fprintf(stderr, format, value ); \
+                    usage(); \
+                    exit(EXIT_FAILURE); \
+                }
+
+#define G_MIN       1E-3            // Smallest g(r) used for the updates
+#define IBI_LINE    1024            // Longest line of a target file
+
+void usage(){
+    fprintf(stderr, "Usage: ibi %s\n",
+        "[--target t1 t2 file]... [--forces file] [--iterations n]\n"
+        "           [--sweeps n] [--equilibrate n] [--range r] [--bin dr]\n"
+        "           [--mix a] [--gr file] [--threads n]\n"
+        "           beta initial_config final_config final_forces");
+}
+
+/**
+ * A pair of atom types that is fitted.
+ */
+struct fit_pair {
+    int     t1, t2;                         ///< The atom types.
+    vector<double>  r, g;                   ///< The target as read.
+    vector<double>  target;                 ///< The target on the table grid.
+    vector<double>  gr;                     ///< The g(r) of the last iteration.
+    vector<double>  u;                      ///< The table.
+};
+
+/**
+ * @brief Read a target g(r).
+ * @param fname The file name.
+ * @param pair  The pair, its r and g are filled.
+ */
+void    read_target(const char *fname, fit_pair *pair){
+    FILE    *src;
+    char    line[IBI_LINE];
+    double  r, g;
+
+    if(! (src = fopen(fname, "r")))
+        fatal_error("Unable to open %s for reading\n", fname);
+    while(fgets(line, IBI_LINE, src)){
+        if(line[0] == '#' || sscanf(line, "%lf %lf", &r, &g) != 2) continue;
+        if(!pair->r.empty() && r <= pair->r.back())
+            fatal_error("Distances not increasing in %s\n", fname);
+        pair->r.push_back(r);
+        pair->g.push_back(g);
+    }
+    fclose(src);
+    if(pair->r.size() < 2) fatal_error("Too few points in %s\n", fname);
+}
+
+/**
+ * @brief Linear interpolation of a target, 0 before its first point and 1
+ * after its last.
+ * @param pair  The pair.
+ * @param r     The distance.
+ * @return      The target g(r).
+ */
+double  target_at(fit_pair *pair, double r){
+    unsigned int k = 1;
+
+    if(r < pair->r[0]) return 0.0;
+    if(r >= pair->r.back()) return 1.0;
+    while(pair->r[k] <= r) k++;
+    return pair->g[k-1] + (pair->g[k] - pair->g[k-1])
+            *(r - pair->r[k-1])/(pair->r[k] - pair->r[k-1]);
+}
+
+/**
+ * @brief Histogram the atom pairs of the fitted types for a range of objects.
+ *
+ * Each pair of objects is counted once, by the object with the lower index.
+ * The histogram bins are centered on the table distances.
+ *
+ * @param state     The configuration.
+ * @param grid      The cell_list of the configuration.
+ * @param index     Index of the fitted pair for each pair of atom types (-1).
+ * @param n_types   The number of atom types.
+ * @param n_bins    The number of bins.
+ * @param dr        The bin width.
+ * @param r_object  The range of the object pairs.
+ * @param first     The first object.
+ * @param last      After the last object.
+ * @param hist      The histograms, n_bins for each fitted pair, added to.
+ */
+void    count_pairs(config *state, cell_list *grid, const vector<int> *index,
+                    int n_types, int n_bins, double dr, double r_object,
+                    int first, int last, vector<double> *hist){
+    topology    *the_topology = state->get_topology();
+    vector<int> found;
+    object      *obj1, *obj2;
+    atom        *at1, *at2;
+    double      dx, dy, x1, y1, x2, y2, r;
+    int         p, k;
+
+    for(int i = first; i < last; i++){
+        obj1 = state->get_object(i);
+        grid->neighbours(obj1->pos_x, obj1->pos_y, r_object, found);
+        for(unsigned int m = 0; m < found.size(); m++){
+            if(found[m] <= i) continue;
+            obj2 = state->get_object(found[m]);
+            state->image_shift(obj1, obj2, &dx, &dy);
+            dx += obj2->pos_x - obj1->pos_x;
+            dy += obj2->pos_y - obj1->pos_y;
+            if(dx*dx + dy*dy >= r_object*r_object) continue;
+            for(int a = 0; a < the_topology->n_atom(obj1->o_type); a++){
+                at1 = the_topology->atoms(obj1->o_type, a);
+                x1 = cos(obj1->orientation)*at1->x_pos - sin(obj1->orientation)*at1->y_pos;
+                y1 = sin(obj1->orientation)*at1->x_pos + cos(obj1->orientation)*at1->y_pos;
+                for(int b = 0; b < the_topology->n_atom(obj2->o_type); b++){
+                    at2 = the_topology->atoms(obj2->o_type, b);
+                    p = (*index)[at1->type*n_types + at2->type];
+                    if(p < 0) continue;
+                    x2 = dx + cos(obj2->orientation)*at2->x_pos
+                            - sin(obj2->orientation)*at2->y_pos;
+                    y2 = dy + sin(obj2->orientation)*at2->x_pos
+                            + cos(obj2->orientation)*at2->y_pos;
+                    r = sqrt((x2-x1)*(x2-x1) + (y2-y1)*(y2-y1));
+                    k = (int)(r/dr + 0.5);
+                    if(k < n_bins) (*hist)[p*n_bins + k] += 1.0;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Read the options, targets and configuration and make the iterations.
+ */
+int main(int argc, char **argv)
+{
+    int     i, arg, n_iter = 10, n_sweeps = 100, n_equil = 20, n_threads = 1;
+    int     n_bins, n_types, n_obj, n_t, p, k, samples;
+    double  beta, range = 0.0, dr = 0.05, mix = 0.5, r, hard, shell, area;
+    double  extent = 0.0, r_object, residual;
+    char    *gr_file = NULL;
+    FILE    *src, *dest;
+    config  *state;
+    force_field *the_forces = new force_field();
+    topology    *the_topology = new topology();
+    integrator  *the_integrator;
+    cell_list   *grid;
+    vector<fit_pair>    pairs;
+    vector<int>     index, n_atoms;
+    vector< vector<double> >    hist;
+    vector<double>  du;
+    vector<thread>  workers;
+    object      *obj;
+    clock_t     start = clock();
+
+    for(i = 1; (i < argc) && (argv[i][0] == '-') && (argv[i][1] == '-'); i++){
+        if(!strcmp(argv[i], "--target") && (i+3 < argc)){
+            pairs.push_back(fit_pair());
+            pairs.back().t1 = atoi(argv[++i]);
+            pairs.back().t2 = atoi(argv[++i]);
+            read_target(argv[++i], &pairs.back());
+        } else if(!strcmp(argv[i], "--forces") && (i+1 < argc)){
+            if(! (src = fopen(argv[++i], "r")))
+                fatal_error("Unable to open %s for reading\n", argv[i]);
+            if(the_forces->read(src) < 0)
+                fatal_error("Bad force field file %s\n", argv[i]);
+            fclose(src);
+        } else if(!strcmp(argv[i], "--iterations") && (i+1 < argc)){
+            n_iter = atoi(argv[++i]);
+            if(n_iter < 0) fatal_error("Bad number of iterations: %d\n", n_iter);
+        } else if(!strcmp(argv[i], "--sweeps") && (i+1 < argc)){
+            n_sweeps = atoi(argv[++i]);
+            if(n_sweeps < 1) fatal_error("Bad number of sweeps: %d\n", n_sweeps);
+        } else if(!strcmp(argv[i], "--equilibrate") && (i+1 < argc)){
+            n_equil = atoi(argv[++i]);
+            if(n_equil < 0) fatal_error("Bad number of sweeps: %d\n", n_equil);
+        } else if(!strcmp(argv[i], "--range") && (i+1 < argc)){
+            range = atof(argv[++i]);
+            if(range <= 0.0) fatal_error("Bad range: %g\n", range);
+        } else if(!strcmp(argv[i], "--bin") && (i+1 < argc)){
+            dr = atof(argv[++i]);
+            if(dr <= 0.0) fatal_error("Bad bin width: %g\n", dr);
+        } else if(!strcmp(argv[i], "--mix") && (i+1 < argc)){
+            mix = atof(argv[++i]);
+            if(mix <= 0.0) fatal_error("Bad mixing factor: %g\n", mix);
+        } else if(!strcmp(argv[i], "--gr") && (i+1 < argc)){
+            gr_file = argv[++i];
+        } else if(!strcmp(argv[i], "--threads") && (i+1 < argc)){
+            n_threads = atoi(argv[++i]);
+            if(n_threads < 1) fatal_error("Bad number of threads: %d\n", n_threads);
+        } else {
+            fatal_error("Unknown option or missing value: %s\n", argv[i]);
+        }
+    }
+    if( argc - i != 4 ) fatal_error("%s\n", "Wrong number of arguments");
+    arg = i;
+    if( pairs.empty() ) fatal_error("%s\n", "No target g(r)");
+    if( n_equil >= n_sweeps ) fatal_error("%s\n", "No sweeps left after equilibration");
+    beta = atof(argv[arg]);
+    if( beta <= 0.0 ) fatal_error("Bad beta: %g\n", beta);
+    if(! (src = fopen(argv[arg+1], "r")))
+        fatal_error("Unable to open %s for reading\n", argv[arg+1]);
+    state = new config(src);
+    fclose(src);
+    state->add_topology(new topology(the_topology));
+    n_obj = state->n_objects();
+    if( n_obj < 2 ) fatal_error("%s\n", "Too few objects");
+    if( state->energy(the_forces) > the_forces->big_energy ){
+        relaxer the_relaxer(the_forces);    // Remove the overlaps
+        if( the_relaxer.run(state, 1000*n_obj) < 0 )
+            fatal_error("Unable to remove overlaps in %d iterations\n",
+                    the_relaxer.n_iter);
+    }
+
+    n_types = the_forces->n_atom_types();   // The tables
+    index.assign(n_types*n_types, -1);
+    if( range == 0.0 )
+        for(p = 0; p < (int)pairs.size(); p++) range = max(range, pairs[p].r.back());
+    if( range > the_forces->cut_off )
+        fatal_error("The range is beyond the cut off %g\n", the_forces->cut_off);
+    n_bins = (int)(range/dr) + 1;
+    for(p = 0; p < (int)pairs.size(); p++){
+        fit_pair    &f = pairs[p];
+        if( f.t1 < 0 || f.t1 >= n_types || f.t2 < 0 || f.t2 >= n_types )
+            fatal_error("No atom type for target %d\n", p);
+        if( index[f.t1*n_types + f.t2] >= 0 )
+            fatal_error("Two targets for pair %d\n", p);
+        index[f.t1*n_types + f.t2] = index[f.t2*n_types + f.t1] = p;
+        hard = the_forces->size(f.t1) + the_forces->size(f.t2);
+        f.u.resize(n_bins);
+        f.target.resize(n_bins);
+        for(k = 0; k < n_bins; k++){
+            f.u[k] = the_forces->interaction(f.t1, f.t2, max(k*dr, hard));
+            f.target[k] = target_at(&f, k*dr);
+        }
+    }
+    for(p = 0; p < (int)pairs.size(); p++)
+        the_forces->set_table(pairs[p].t1, pairs[p].t2, dr, pairs[p].u);
+
+    n_atoms.assign(n_types, 0);             // Atoms of each type
+    for(i = 0; i < n_obj; i++){
+        obj = state->get_object(i);
+        for(k = 0; k < the_topology->n_atom(obj->o_type); k++)
+            n_atoms[the_topology->atoms(obj->o_type, k)->type]++;
+    }
+    for(int t = 0; t < the_topology->n_types(); t++)
+        extent = max(extent, the_topology->extent(t));
+    r_object = range + dr + 2.0*extent;
+    area = state->area();
+    grid = new cell_list(state->x_size, state->y_size, r_object, state->periodic());
+    state->fill_grid(grid);
+    n_t = min(n_threads, n_obj);
+    hist.resize(n_t);
+
+    the_integrator = new integrator(the_forces);
+    the_integrator->dl_max = min(state->x_size, state->y_size)/2.0;
+    printf("IBI of %d pairs with %d objects, beta = %g, range = %g, bin = %g\n",
+            (int)pairs.size(), n_obj, beta, range, dr);
+    for(int it = 1; it <= n_iter; it++){
+        for(i = 0; i < n_obj; i++) state->get_object(i)->recalculate = true;
+        state->unchanged = false;           // The force field has changed
+        the_integrator->run(&state, beta, 0.0, n_equil*n_obj);
+        for(int t = 0; t < n_t; t++) hist[t].assign(pairs.size()*n_bins, 0.0);
+        for(samples = 0; samples < n_sweeps - n_equil; samples++){
+            the_integrator->run(&state, beta, 0.0, n_obj);
+            for(i = 0; i < n_obj; i++){
+                obj = state->get_object(i);
+                grid->update(i, obj->pos_x, obj->pos_y);
+            }
+            for(int t = 1; t < n_t; t++)
+                workers.push_back(thread(count_pairs, state, grid, &index,
+                        n_types, n_bins, dr, r_object, (t*n_obj)/n_t,
+                        ((t+1)*n_obj)/n_t, &hist[t]));
+            count_pairs(state, grid, &index, n_types, n_bins, dr, r_object,
+                    0, n_obj/n_t, &hist[0]);
+            for(unsigned int t = 0; t < workers.size(); t++) workers[t].join();
+            workers.clear();
+        }
+        printf("Iteration %d: energy = %g moves %d in %d\n", it,
+                state->energy(the_forces), the_integrator->n_good,
+                the_integrator->n_good + the_integrator->n_bad);
+
+        for(p = 0; p < (int)pairs.size(); p++){ // Update the tables
+            fit_pair    &f = pairs[p];
+            hard = the_forces->size(f.t1) + the_forces->size(f.t2);
+            f.gr.assign(n_bins, 0.0);
+            du.assign(n_bins, 0.0);
+            residual = 0.0;
+            for(k = 0; k < n_bins; k++){
+                for(int t = 1; t < n_t; t++) hist[0][p*n_bins + k] += hist[t][p*n_bins + k];
+                shell = (k == 0) ? 0.25*M_PI*dr*dr : M_2PI*k*dr*dr;
+                f.gr[k] = area*hist[0][p*n_bins + k]/(samples*shell
+                        *((f.t1 == f.t2) ? 0.5*n_atoms[f.t1]*(n_atoms[f.t1] - 1.0)
+                                         : (double)n_atoms[f.t1]*n_atoms[f.t2]));
+                residual += (f.gr[k] - f.target[k])*(f.gr[k] - f.target[k]);
+                if(k*dr >= hard && f.gr[k] > G_MIN && f.target[k] > G_MIN)
+                    du[k] = mix*log(f.gr[k]/f.target[k])/beta;
+            }
+            for(k = 0; k < n_bins; k++){
+                r = (k > 0 && k+1 < n_bins) ? 0.25*(du[k-1] + 2.0*du[k] + du[k+1])
+                                            : du[k];
+                f.u[k] += r;
+            }
+            for(k = n_bins-1; k >= 0; k--){     // Zero at the end, flat in the core
+                if(k < n_bins-1 && k*dr < hard) f.u[k] = f.u[k+1];
+            }
+            r = f.u[n_bins-1];
+            for(k = 0; k < n_bins; k++) f.u[k] -= r;
+            the_forces->set_table(f.t1, f.t2, dr, f.u);
+            printf("Pair %d-%d: residual = %g\n", f.t1, f.t2,
+                    sqrt(residual/n_bins));
+        }
+
+        if(! (dest = fopen(argv[arg+3], "w")))
+            fatal_error("Unable to open %s for writing\n", argv[arg+3]);
+        the_forces->write_tables(dest);
+        fprintf(dest, "end\n");
+        fclose(dest);
+        fflush(stdout);
+    }
+
+    if(gr_file){
+        if(! (dest = fopen(gr_file, "w")))
+            fatal_error("Unable to open %s for writing\n", gr_file);
+        fprintf(dest, "# r");
+        for(p = 0; p < (int)pairs.size(); p++)
+            fprintf(dest, " g_%d-%d target_%d-%d u_%d-%d", pairs[p].t1,
+                    pairs[p].t2, pairs[p].t1, pairs[p].t2, pairs[p].t1, pairs[p].t2);
+        fprintf(dest, "\n");
+        for(k = 0; k < n_bins; k++){
+            fprintf(dest, "%g", k*dr);
+            for(p = 0; p < (int)pairs.size(); p++)
+                fprintf(dest, " %g %g %g", pairs[p].gr.empty() ? 0.0 : pairs[p].gr[k],
+                        pairs[p].target[k], pairs[p].u[k]);
+            fprintf(dest, "\n");
+        }
+        fclose(dest);
+    }
+
+    if(! (dest = fopen(argv[arg+2], "w")))
+        fatal_error("Unable to open %s for writing\n", argv[arg+2]);
+    state->write(dest);
+    fclose(dest);
+    printf("%d iterations in %g s\n", n_iter, (double)(clock()-start)/CLOCKS_PER_SEC);
+
+    delete grid;
+    delete the_integrator;
+    delete state;
+    delete the_topology;
+    delete the_forces;
+
+    return 0;
+}
@@ -12,20 +12,45 @@
  * proteins in the composition requested in a relatively random organization.
  *
  * The algorithm will create an empty configuration with the desired geometry
- * and then try to randomly place the objects into the space. The first two
- * parameters give the size of the configuration and then the following parameters
- * are the number of object of the different types, O, 1, ...
+ * and then place the objects, in a random order, by random sequential
+ * adsorption (see placer). For each object random positions and orientations
+ * are tried until one is found where its atoms do not overlap the hard cores
+ * of the atoms of the objects already placed (using the topology and the force
+ * field radii). The neighbours are found through a cell_list so the generation
+ * takes a time proportional to the number of objects. The result has no
+ * hard core overlaps, so its energy is finite. If an object cannot be placed
+ * in the allowed number of attempts the requested density is beyond what
+ * random sequential adsorption can reach, this is reported together with the
+ * packing fraction reached and no configuration is written.
  *
- * \todo    Make sure that the configuration has non-infinate energy and if
- *          it does, take steps to find one that does not.
+ * For densities beyond the reach of random sequential adsorption the objects
+ * can instead be put on a lattice: hexagonal (for discs), square or
+ * rectangular (fitted to the shape of the objects, for the squares). The number
+ * of rows and columns is chosen so the lattice tiles the box exactly and the
+ * periodic boundaries close cleanly. With several object types the types are
+ * assigned to the sites at random. A fraction of the sites can be left as
+ * randomly placed vacancies and the orientations can be given some noise. If
+ * the objects do not fit on the lattice this is reported and no configuration
+ * is written.
+ *
+ * The first two parameters give the size of the configuration and then the
+ * following parameters are the number of object of the different types,
+ * O, 1, ... They can be preceded by the options:
+ *      --attempts n    The number of trials to place an object (1000).
+ *      --seed s        Seed for the random number generator.
+ *      --lattice l     Use a lattice: hex, square or rect.
+ *      --vacancy f     Fraction of the lattice sites left empty (0).
+ *      --noise a       Orientations are uniform in -a..a radians (0).
  */
 
 #include "../NVT/config.h"
 #include "../NVT/object.h"
-#include "../NVT/common.h"
+#include "../NVT/placer.h"
 #include <stdio.h>
 #include <math.h>
 #include <iostream>
+#include <string.h>
+#include "../NVT/common.h"
 
 using namespace std;
 
@@ -35,37 +60,213 @@ using namespace std;
                     exit(EXIT_FAILURE); \
                 }
 
+#define MAX_ATTEMPTS    1000        // Default trials to place an object
+
 void usage(){
     fprintf(stderr, "Usage: makeconfig %s\n",
-        "x_size y_size (n_type_0 (n_type_1 (...))");
+        "[--attempts n] [--seed s] [--lattice hex|square|rect "
+        "[--vacancy f] [--noise a]] x_size y_size (n_type_0 (n_type_1 (...))");
+}
+
+/**
+ * @brief Choose the number of lattice rows and columns to fit the box.
+ *
+ * Among the lattices with at least n_sites sites that tile the box exactly,
+ * so the periodic boundaries close, choose the one whose cells give the most
+ * room to the objects. For the hexagonal lattice the number of rows must be
+ * even and the room is the nearest neighbour distance (within a row, to the
+ * neighbouring rows or to the next row with the same offset). For the rectangular
+ * lattices it is the smaller of the cell sides divided by the object
+ * width w and height h (w = h for square lattices).
+ *
+ * @param hex       Is the lattice hexagonal?
+ * @param x_size    Width of the box.
+ * @param y_size    Height of the box.
+ * @param n_sites   Minimum number of sites.
+ * @param w         Width of the objects (rectangular lattices).
+ * @param h         Height of the objects (rectangular lattices).
+ * @param n_x       Returns the number of columns.
+ * @param n_y       Returns the number of rows.
+ */
+void    lattice_shape(bool hex, double x_size, double y_size, int n_sites,
+                      double w, double h, int *n_x, int *n_y){
+    double  a_x, a_y, room, best = -1.0;
+    int     ny;
+
+    *n_x = *n_y = 1;
+    for(int nx = 1; nx <= n_sites; nx++){
+        ny = (n_sites + nx - 1)/nx;
+        if(hex && (ny % 2)) ny++;
+        a_x = x_size/nx;
+        a_y = y_size/ny;
+        if(hex) room = min(min(a_x, 2.0*a_y), sqrt(0.25*a_x*a_x + a_y*a_y));
+        else    room = min(a_x/w, a_y/h);
+        if(room > best){
+            best = room;
+            *n_x = nx;
+            *n_y = ny;
+        }
+    }
 }
 
+/**
+ * @brief Place the objects on a lattice fitted to the box.
+ *
+ * The lattice is chosen with enough sites for the objects and the requested
+ * fraction of vacancies. The objects, in the order given (which is random),
+ * are put on randomly chosen sites so the remaining sites are randomly
+ * distributed vacancies. The objects are aligned with the lattice axes with
+ * a random orientation noise uniform in -noise..noise.
+ *
+ * @param a_config      The (empty) configuration to fill.
+ * @param a_topology    The object topologies.
+ * @param the_forces    The force field giving the atom sizes.
+ * @param types         The types of the objects to place.
+ * @param kind          The lattice: "hex", "square" or "rect".
+ * @param vacancy       Fraction of the sites to leave empty.
+ * @param noise         Maximum orientation noise (radians).
+ */
+void    lattice(config *a_config, topology *a_topology, force_field *the_forces,
+                vector<int> &types, const char *kind,
+                double vacancy, double noise){
+    int     n_sites, n_x, n_y, k, tmp;
+    double  a_x, a_y, x, y, r;
+    double  w = 0.0, h = 0.0;
+    bool    hex = !strcmp(kind, "hex");
+    vector<int> sites;
+    atom    *at;
 
+    for(unsigned int j = 0; j < types.size(); j++){ // Object sizes at
+        for(int a = 0; a < a_topology->n_atom(types[j]); a++){   // orientation 0
+            at = a_topology->atoms(types[j], a);
+            r  = the_forces->size(at->type);
+            w  = max(w, fabs(at->x_pos) + r);
+            h  = max(h, fabs(at->y_pos) + r);
+        }
+    }
+    if(strcmp(kind, "rect")) w = h = 1.0;
+
+    n_sites = (int)ceil(types.size()/(1.0 - vacancy));
+    lattice_shape(hex, a_config->x_size, a_config->y_size, n_sites,
+                  w, h, &n_x, &n_y);
+    a_x = a_config->x_size/n_x;
+    a_y = a_config->y_size/n_y;
+
+    for(int j = 0; j < n_x*n_y; j++) sites.push_back(j);
+    for(unsigned int j = 0; j < types.size(); j++){ // Choose the occupied sites
+        k = j + rand() % (sites.size() - j);
+        tmp = sites[j]; sites[j] = sites[k]; sites[k] = tmp;
+        x = (sites[j] % n_x + 0.5)*a_x;
+        y = (sites[j] / n_x + 0.5)*a_y;
+        if(hex && ((sites[j] / n_x) % 2)) x += 0.5*a_x;
+        if(x >= a_config->x_size) x -= a_config->x_size;
+        a_config->add_object(new object(types[j], x, y,
+                rnd_lin(2.0*noise) - noise));
+    }
+}
+
+/**
+ * Read the options and composition, place the objects by random sequential
+ * adsorption, or on a lattice, and write the configuration to the standard
+ * output.
+ */
 int main(int argc, char **argv)
 {
-    int     type, n;
-    double  pos_x, pos_y, orient;
+    int     type, n, i;
+    int     max_attempts = MAX_ATTEMPTS;
+    double  vacancy = 0.0, noise = 0.0;
+    const char  *kind = (const char *)NULL;
     config  *a_config = new config();
+    topology    *a_topology = new topology();
+    force_field *the_forces = new force_field();
+    placer      *the_placer;
+    cell_list   *grid;
+    vector<int> types;
 
-    if( argc < 4 ){
+    for(i = 1; (i < argc) && (argv[i][0] == '-') && (argv[i][1] == '-'); i++){
+        if(!strcmp(argv[i], "--attempts") && (i+1 < argc)){
+            max_attempts = atoi(argv[++i]);
+            if(max_attempts < 1)
+                fatal_error("Too few attempts: %d\n", max_attempts);
+        } else if(!strcmp(argv[i], "--seed") && (i+1 < argc)){
+            srand(atol(argv[++i]));
+        } else if(!strcmp(argv[i], "--lattice") && (i+1 < argc)){
+            kind = argv[++i];
+            if(strcmp(kind, "hex") && strcmp(kind, "square")
+                    && strcmp(kind, "rect"))
+                fatal_error("Unknown lattice: %s\n", kind);
+        } else if(!strcmp(argv[i], "--vacancy") && (i+1 < argc)){
+            vacancy = atof(argv[++i]);
+            if(vacancy < 0.0 || vacancy >= 1.0)
+                fatal_error("Bad vacancy fraction: %g\n", vacancy);
+        } else if(!strcmp(argv[i], "--noise") && (i+1 < argc)){
+            noise = atof(argv[++i]);
+        } else {
+            fatal_error("Unknown option or missing value: %s\n", argv[i]);
+        }
+    }
+    if( argc - i < 3 ){
         fatal_error("%s\n", "Wrong number of arguments");
     }
 
-    a_config->x_size = atof(argv[1]);
-    a_config->y_size = atof(argv[2]);
-    type = 0;
-    while( type+3 < argc ){
-        n = atoi(argv[3+type]);
-        for(int i = 0; i < n; i++ ){
-            pos_x  = rnd_lin(a_config->x_size);
-            pos_y  = rnd_lin(a_config->y_size);
-            orient = rnd_lin(M_2PI);
-            a_config->add_object( new object( type, pos_x, pos_y, orient ));
+    a_config->x_size = atof(argv[i]);
+    a_config->y_size = atof(argv[i+1]);
+    a_config->set_periodic(true);
+    a_config->add_topology(a_topology);
+    if( a_config->x_size <= 0.0 || a_config->y_size <= 0.0 )
+        fatal_error("%s\n", "The box must have a positive size");
+
+    for(type = 0; i+2+type < argc; type++){ // The composition, in random order
+        if( type >= a_topology->n_types() )
+            fatal_error("No topology for object type %d\n", type);
+        n = atoi(argv[i+2+type]);
+        for(int j = 0; j < n; j++ ) types.push_back(type);
+    }
+    for(int j = types.size()-1; j > 0; j--){
+        n = rand() % (j+1);
+        type = types[j]; types[j] = types[n]; types[n] = type;
+    }
+
+    grid = new cell_list(a_config->x_size, a_config->y_size,
+            2.0*a_config->reach(the_forces), true);
+
+    if(kind){                               // Lattice, check it is not too
+        if(types.empty())                   // dense.
+            fatal_error("%s\n", "No objects to put on the lattice");
+        lattice(a_config, a_topology, the_forces, types,
+                kind, vacancy, noise);
+        a_config->fill_grid(grid);
+        n = 0;
+        for(int j = 0; j < a_config->n_objects(); j++)
+            if(a_config->overlap(the_forces, a_config->get_object(j), j, grid))
+                n++;
+        if(n){
+            fprintf(stderr,
+                "The %s lattice is too dense: %d of %d objects overlap\n",
+                kind, n, a_config->n_objects());
+            exit(EXIT_FAILURE);
         }
-        type++;
+    } else {
+        the_placer = new placer(the_forces, max_attempts);
+        if(!the_placer->place(a_config, types, grid)){  // Jammed, report
+            fprintf(stderr,                             // and give up
+                "Random sequential adsorption jammed after %d of %d objects\n"
+                "No room for an object of type %d in %d attempts\n"
+                "Packing fraction reached %g of %g requested\n",
+                the_placer->n_placed, (int)types.size(),
+                types[the_placer->n_placed], max_attempts,
+                the_placer->covered/a_config->area(),
+                the_placer->wanted/a_config->area());
+            exit(EXIT_FAILURE);
+        }
+        delete the_placer;
     }
 
     a_config->write(stdout);
 
+    delete grid;
+    delete the_forces;
+    delete a_config;
+
     return 0;
 }
@@ -0,0 +1,631 @@
+/**
+ * \file    pcf.cpp
+ * \author  agent
+ * \date    October 17, 2026
+ * \version 1.0
+ * \brief   Edge corrected pair correlation function of a measured configuration.
+ *
+ * This file contains the main routine for the pcf program that is part of the
+ * Very Coarse Grained disc simulation programmes.
+ *
+ * Configurations measured by AFM are not periodic, the particles are only
+ * known inside an irregular region of the image (the mask). Near its edges a
+ * particle has fewer neighbours seen, which biases the pair correlation
+ * function g(r) unless it is corrected. The program reads the particle
+ * positions, in the configuration file format, and the mask:
+ * * a polygon, a file of vertices "x y" one per line, a blank line starts a
+ *   new ring, the inside is given by the even-odd rule so rings can be holes;
+ * * a bitmap, a PGM image (P2 or P5) in which the pixels brighter than half
+ *   the maximum are inside, the first row is the top of the image and the
+ *   pixels are --pixel wide;
+ * * by default the rectangle of the configuration box.
+ * Particles outside the mask are ignored.
+ *
+ * The partial g(r) of each pair of particle types, and the total, are
+ * estimated with edge correction weights (see Illian et al. 2008):
+ * * isotropic (Ripley 1977, the default), a pair i, j at distance r has the
+ *   weight 1 / e_i(r) where e_i(r) is the fraction of the circle of radius r
+ *   around i that is inside the mask. For a polygon the fraction is exact,
+ *   from the intersections of the circle with the edges, for a bitmap the
+ *   circle is sampled every half pixel. Only the particles closer to an edge
+ *   than the range need these terms, they are calculated for each bin by
+ *   several threads;
+ * * translation (Ohser and Stoyan 1981, option --translation), the weight is
+ *   |W| / gamma(r) where gamma(r) is the area of the intersection of the mask
+ *   with itself shifted by r, averaged over the directions. It is calculated
+ *   on the pixels of the mask (a polygon is first rasterized with pixels
+ *   --pixel wide).
+ * The estimate is then
+ *
+ *      g(r) = |W| sum_{i != j, r_ij in bin} w_ij / (n (n-1) 2 pi r dr)
+ *
+ * with n (n-1) replaced by the numbers of pairs of the types for the partial
+ * g(r). The pairs are found with a cell_list and counted by several threads.
+ *
+ * Usage:
+ *          pcf [options] < configuration > pcf_file
+ *
+ * The options are:
+ *      --polygon file  The mask is a polygon.
+ *      --bitmap file   The mask is a PGM bitmap.
+ *      --pixel s       The pixel size of the bitmap, or of the raster of a
+ *                      polygon for the translation weights (1, dr/2 for a
+ *                      polygon).
+ *      --translation   Use the translation weights.
+ *      --range r       The range of g(r) (10).
+ *      --bin dr        The bin width (0.1).
+ *      --threads n     The number of threads (1).
+ *
+ * The output has the same format as that of the rdf analyzer of NVT. Progress
+ * is reported on the standard error stream.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include <time.h>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include "../NVT/config.h"
+#include "../NVT/common.h"
+
+using namespace std;
+
+#define fatal_error(format, value) {\
+                    fprintf(stderr, format, value ); \
+                    usage(); \
+                    exit(EXIT_FAILURE); \
+                }
+
+#define PCF_ANGLES  32              // Directions averaged for gamma(r)
+#define PCF_LINE    256             // Longest line of a polygon file
+
+void usage(){
+    fprintf(stderr, "Usage: pcf %s\n",
+        "[--polygon file | --bitmap file] [--pixel s] [--translation]\n"
+        "           [--range r] [--bin dr] [--threads n] < configuration > pcf_file");
+}
+
+/**
+ * A point of the plane.
+ */
+struct point {
+    double  x, y;                           ///< The coordinates.
+};
+
+/**
+ * The region in which the particles are observed, a polygon or a bitmap.
+ */
+struct mask {
+    vector< vector<point> > rings;          ///< The rings of a polygon.
+    bool    is_bitmap;                      ///< Is the mask a bitmap?
+    int     n_x, n_y;                       ///< Bitmap size in pixels.
+    double  pixel;                          ///< Bitmap pixel size.
+    vector<char>    bits;                   ///< Bitmap pixels, by rows from y = 0.
+    vector<int>     outside;                ///< Summed area table of the pixels outside.
+};
+
+/**
+ * @brief Read a polygon mask.
+ * @param fname The file name.
+ * @param m     The mask, filled.
+ */
+void    read_polygon(const char *fname, mask *m){
+    FILE    *src;
+    char    line[PCF_LINE];
+    point   p;
+
+    if(! (src = fopen(fname, "r")))
+        fatal_error("Unable to open %s for reading\n", fname);
+    m->is_bitmap = false;
+    m->rings.push_back(vector<point>());
+    while(fgets(line, PCF_LINE, src)){
+        if(line[0] == '#') continue;
+        if(sscanf(line, "%lf %lf", &p.x, &p.y) == 2){
+            m->rings.back().push_back(p);
+        } else if(!m->rings.back().empty()){
+            m->rings.push_back(vector<point>());
+        }
+    }
+    fclose(src);
+    if(m->rings.back().empty()) m->rings.pop_back();
+    for(unsigned int k = 0; k < m->rings.size(); k++)
+        if(m->rings[k].size() < 3) fatal_error("Ring %d has too few vertices\n", k);
+    if(m->rings.empty()) fatal_error("No polygon in %s\n", fname);
+}
+
+/**
+ * @brief Read the next number of a PGM header, skipping comments.
+ * @param src   The file.
+ * @return      The number or -1.
+ */
+int     pgm_number(FILE *src){
+    int     c, value;
+
+    while((c = fgetc(src)) != EOF){
+        if(c == '#') while((c = fgetc(src)) != EOF && c != '\n');
+        else if(!isspace(c)){ ungetc(c, src); break; }
+    }
+    return (fscanf(src, "%d", &value) == 1) ? value : -1;
+}
+
+/**
+ * @brief Build the summed area table of the pixels outside a bitmap mask.
+ * @param m The mask.
+ */
+void    sum_outside(mask *m){
+    m->outside.assign((m->n_x+1)*(m->n_y+1), 0);
+    for(int j = 0; j < m->n_y; j++)
+        for(int i = 0; i < m->n_x; i++)
+            m->outside[(j+1)*(m->n_x+1) + i+1] = !m->bits[j*m->n_x + i]
+                    + m->outside[j*(m->n_x+1) + i+1]
+                    + m->outside[(j+1)*(m->n_x+1) + i]
+                    - m->outside[j*(m->n_x+1) + i];
+}
+
+/**
+ * @brief Read a bitmap mask from a PGM file.
+ * @param fname The file name.
+ * @param pixel The pixel size.
+ * @param m     The mask, filled.
+ */
+void    read_bitmap(const char *fname, double pixel, mask *m){
+    FILE    *src;
+    char    magic[3] = "";
+    int     max_value, value;
+    bool    binary;
+
+    if(! (src = fopen(fname, "rb")))
+        fatal_error("Unable to open %s for reading\n", fname);
+    if(fread(magic, 1, 2, src) != 2 || magic[0] != 'P'
+            || (magic[1] != '2' && magic[1] != '5'))
+        fatal_error("Not a PGM file: %s\n", fname);
+    binary = magic[1] == '5';
+    m->is_bitmap = true;
+    m->pixel = pixel;
+    m->n_x = pgm_number(src);
+    m->n_y = pgm_number(src);
+    max_value = pgm_number(src);
+    if(m->n_x < 1 || m->n_y < 1 || max_value < 1 || max_value > 255)
+        fatal_error("Unsupported PGM header in %s\n", fname);
+    if(binary) fgetc(src);                  // The single white space
+    m->bits.assign(m->n_x*m->n_y, 0);
+    for(int j = m->n_y-1; j >= 0; j--){     // The first row is the top
+        for(int i = 0; i < m->n_x; i++){
+            value = binary ? fgetc(src) : pgm_number(src);
+            if(value < 0) fatal_error("Short PGM file %s\n", fname);
+            m->bits[j*m->n_x + i] = (2*value > max_value);
+        }
+    }
+    fclose(src);
+    sum_outside(m);
+}
+
+/**
+ * @brief Is a point inside the mask?
+ * @param m The mask.
+ * @param x The x coordinate.
+ * @param y The y coordinate.
+ * @return  True if inside.
+ */
+bool    inside(const mask &m, double x, double y){
+    bool    in = false;
+    int     i, j;
+
+    if(m.is_bitmap){
+        i = (int)floor(x/m.pixel);
+        j = (int)floor(y/m.pixel);
+        return i >= 0 && i < m.n_x && j >= 0 && j < m.n_y && m.bits[j*m.n_x + i];
+    }
+    for(unsigned int k = 0; k < m.rings.size(); k++){   // Even-odd rule
+        const vector<point> &r = m.rings[k];
+        for(unsigned int a = 0, b = r.size()-1; a < r.size(); b = a++)
+            if(((r[a].y > y) != (r[b].y > y))
+                    && (x < r[b].x + (r[a].x - r[b].x)*(y - r[b].y)/(r[a].y - r[b].y)))
+                in = !in;
+    }
+    return in;
+}
+
+/**
+ * @brief The area of the mask.
+ * @param m The mask.
+ * @return  The area.
+ */
+double  mask_area(const mask &m){
+    double  value = 0.0, a;
+    int     depth;
+
+    if(m.is_bitmap){
+        return (m.n_x*m.n_y - m.outside.back())*m.pixel*m.pixel;
+    }
+    for(unsigned int k = 0; k < m.rings.size(); k++){
+        const vector<point> &r = m.rings[k];
+        a = 0.0;                            // Shoelace
+        for(unsigned int i = 0, j = r.size()-1; i < r.size(); j = i++)
+            a += r[j].x*r[i].y - r[i].x*r[j].y;
+        depth = 0;                          // Holes are inside an odd number
+        for(unsigned int l = 0; l < m.rings.size(); l++){   // of rings
+            if(l == k) continue;
+            mask    other;
+            other.is_bitmap = false;
+            other.rings.push_back(m.rings[l]);
+            if(inside(other, r[0].x, r[0].y)) depth++;
+        }
+        value += ((depth % 2) ? -0.5 : 0.5)*fabs(a);
+    }
+    return value;
+}
+
+/**
+ * @brief Is the disc of radius r around a point entirely inside the mask?
+ * @param m The mask.
+ * @param x The x coordinate of the center.
+ * @param y The y coordinate of the center.
+ * @param r The radius.
+ * @return  True if no edge is closer than r.
+ */
+bool    clear_of_edges(const mask &m, double x, double y, double r){
+    double  dx, dy, ex, ey, t;
+    int     i0, i1, j0, j1;
+
+    if(m.is_bitmap){                        // No outside pixel in the square
+        i0 = (int)floor((x - r)/m.pixel); i1 = (int)floor((x + r)/m.pixel) + 1;
+        j0 = (int)floor((y - r)/m.pixel); j1 = (int)floor((y + r)/m.pixel) + 1;
+        if(i0 < 0 || j0 < 0 || i1 > m.n_x || j1 > m.n_y) return false;
+        return m.outside[j1*(m.n_x+1) + i1] - m.outside[j0*(m.n_x+1) + i1]
+                - m.outside[j1*(m.n_x+1) + i0] + m.outside[j0*(m.n_x+1) + i0] == 0;
+    }
+    for(unsigned int k = 0; k < m.rings.size(); k++){
+        const vector<point> &p = m.rings[k];
+        for(unsigned int a = 0, b = p.size()-1; a < p.size(); b = a++){
+            ex = p[a].x - p[b].x;           // Distance to the edge b-a
+            ey = p[a].y - p[b].y;
+            t  = ((x - p[b].x)*ex + (y - p[b].y)*ey)/(ex*ex + ey*ey);
+            t  = max(0.0, min(1.0, t));
+            dx = p[b].x + t*ex - x;
+            dy = p[b].y + t*ey - y;
+            if(dx*dx + dy*dy < r*r) return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief The fraction of a circle that is inside the mask.
+ *
+ * For a polygon the angles at which the circle crosses the edges are found
+ * and the middle of each arc between them is tested. For a bitmap the circle
+ * is sampled every half pixel.
+ *
+ * @param m The mask.
+ * @param x The x coordinate of the center.
+ * @param y The y coordinate of the center.
+ * @param r The radius.
+ * @return  The fraction inside.
+ */
+double  circle_fraction(const mask &m, double x, double y, double r){
+    vector<double>  angles;
+    double  ex, ey, fx, fy, a, b, c, d, t, mid, value = 0.0;
+    int     n;
+
+    if(m.is_bitmap){
+        n = max(16, (int)ceil(4.0*M_PI*r/m.pixel));
+        for(int k = 0; k < n; k++)
+            if(inside(m, x + r*cos((k+0.5)*M_2PI/n), y + r*sin((k+0.5)*M_2PI/n)))
+                value += 1.0;
+        return value/n;
+    }
+    for(unsigned int k = 0; k < m.rings.size(); k++){
+        const vector<point> &p = m.rings[k];
+        for(unsigned int i = 0, j = p.size()-1; i < p.size(); j = i++){
+            ex = p[i].x - p[j].x;           // |P_j + t e - C|^2 = r^2
+            ey = p[i].y - p[j].y;
+            fx = p[j].x - x;
+            fy = p[j].y - y;
+            a = ex*ex + ey*ey;
+            b = 2.0*(fx*ex + fy*ey);
+            c = fx*fx + fy*fy - r*r;
+            d = b*b - 4.0*a*c;
+            if(d <= 0.0) continue;
+            d = sqrt(d);
+            for(int s = -1; s <= 1; s += 2){
+                t = (-b + s*d)/(2.0*a);
+                if(t >= 0.0 && t < 1.0)
+                    angles.push_back(atan2(fy + t*ey, fx + t*ex));
+            }
+        }
+    }
+    if(angles.empty()) return inside(m, x + r, y) ? 1.0 : 0.0;
+    sort(angles.begin(), angles.end());
+    angles.push_back(angles[0] + M_2PI);
+    for(unsigned int k = 0; k+1 < angles.size(); k++){
+        mid = 0.5*(angles[k] + angles[k+1]);
+        if(inside(m, x + r*cos(mid), y + r*sin(mid)))
+            value += angles[k+1] - angles[k];
+    }
+    return value/M_2PI;
+}
+
+/**
+ * @brief Rasterize a polygon mask, the pixels whose centers are inside.
+ * @param m     The polygon mask.
+ * @param pixel The pixel size.
+ * @param x_max The largest x of the polygon.
+ * @param y_max The largest y of the polygon.
+ * @param r     The bitmap mask, filled.
+ */
+void    rasterize(const mask &m, double pixel, double x_max, double y_max,
+                  mask *r){
+    r->is_bitmap = true;
+    r->pixel = pixel;
+    r->n_x = (int)ceil(x_max/pixel) + 1;
+    r->n_y = (int)ceil(y_max/pixel) + 1;
+    r->bits.assign(r->n_x*r->n_y, 0);
+    for(int j = 0; j < r->n_y; j++)
+        for(int i = 0; i < r->n_x; i++)
+            r->bits[j*r->n_x + i] = inside(m, (i+0.5)*pixel, (j+0.5)*pixel);
+    sum_outside(r);
+}
+
+/**
+ * @brief The set covariance gamma(r) of a bitmap averaged over the
+ * directions, for a range of bins.
+ * @param m     The bitmap mask.
+ * @param dr    The bin width.
+ * @param first The first bin.
+ * @param last  After the last bin.
+ * @param gamma Set to gamma at the center of the bins.
+ */
+void    covariance(const mask *m, double dr, int first, int last,
+                   vector<double> *gamma){
+    int     sx, sy;
+    long    count;
+
+    for(int k = first; k < last; k++){
+        count = 0;
+        for(int a = 0; a < PCF_ANGLES; a++){
+            sx = (int)lround((k+0.5)*dr*cos(a*M_2PI/PCF_ANGLES)/m->pixel);
+            sy = (int)lround((k+0.5)*dr*sin(a*M_2PI/PCF_ANGLES)/m->pixel);
+            for(int j = max(0, -sy); j < min(m->n_y, m->n_y - sy); j++){
+                const char  *row1 = &m->bits[j*m->n_x];
+                const char  *row2 = &m->bits[(j+sy)*m->n_x];
+                for(int i = max(0, -sx); i < min(m->n_x, m->n_x - sx); i++)
+                    count += row1[i] & row2[i+sx];
+            }
+        }
+        (*gamma)[k] = count*m->pixel*m->pixel/PCF_ANGLES;
+    }
+}
+
+/**
+ * @brief The isotropic correction terms 1/e_i(r) of a range of particles.
+ * @param m         The mask.
+ * @param x         The x coordinates of the particles.
+ * @param y         The y coordinates of the particles.
+ * @param n_bins    The number of bins.
+ * @param dr        The bin width.
+ * @param first     The first particle.
+ * @param last      After the last particle.
+ * @param weight    The weights of the particles near the edges, n_bins each.
+ * @param slot      The first weight of each particle, -1 if far from edges.
+ */
+void    edge_terms(const mask *m, const vector<double> *x, const vector<double> *y,
+                   int n_bins, double dr, int first, int last,
+                   vector<double> *weight, const vector<int> *slot){
+    double  e;
+
+    for(int i = first; i < last; i++){
+        if((*slot)[i] < 0) continue;
+        for(int k = 0; k < n_bins; k++){
+            e = circle_fraction(*m, (*x)[i], (*y)[i], (k+0.5)*dr);
+            (*weight)[(*slot)[i] + k] = (e > 0.0) ? 1.0/e : 0.0;
+        }
+    }
+}
+
+/**
+ * @brief Histogram the weighted ordered pairs of a range of particles.
+ * @param x         The x coordinates of the particles.
+ * @param y         The y coordinates of the particles.
+ * @param type      The particle types.
+ * @param grid      The cell_list of the particles.
+ * @param n_types   The number of types.
+ * @param n_bins    The number of bins.
+ * @param dr        The bin width.
+ * @param iso       The isotropic weights, see edge_terms() (or NULL).
+ * @param slot      The first weight of each particle.
+ * @param trans     The translation weight of each bin (or NULL).
+ * @param first     The first particle.
+ * @param last      After the last particle.
+ * @param hist      The histograms, n_bins for each ordered pair of types.
+ */
+void    count_pairs(const vector<double> *x, const vector<double> *y,
+                    const vector<int> *type, cell_list *grid, int n_types,
+                    int n_bins, double dr, const vector<double> *iso,
+                    const vector<int> *slot, const vector<double> *trans,
+                    int first, int last, vector<double> *hist){
+    vector<int> found;
+    double  range = n_bins*dr, dx, dy, r, w;
+    int     j, k;
+
+    for(int i = first; i < last; i++){
+        grid->neighbours((*x)[i], (*y)[i], range, found);
+        for(unsigned int m = 0; m < found.size(); m++){
+            j = found[m];
+            if(j == i) continue;
+            dx = (*x)[j] - (*x)[i];
+            dy = (*y)[j] - (*y)[i];
+            r  = sqrt(dx*dx + dy*dy);
+            if(r >= range) continue;
+            k  = (int)(r/dr);
+            if(trans) w = (*trans)[k];
+            else w = ((*slot)[i] < 0) ? 1.0 : (*iso)[(*slot)[i] + k];
+            (*hist)[((*type)[i]*n_types + (*type)[j])*n_bins + k] += w;
+        }
+    }
+}
+
+/**
+ * Read the options, configuration and mask and write the pair correlation
+ * functions.
+ */
+int main(int argc, char **argv)
+{
+    int     i, n, n_types = 0, n_bins, n_t, n_threads = 1, n_edge = 0;
+    double  range = 10.0, dr = 0.1, pixel = 0.0, area, shell, norm;
+    double  x_max = 0.0, y_max = 0.0;
+    bool    translation = false;
+    char    *polygon_file = NULL, *bitmap_file = NULL;
+    config  *state;
+    object  *obj;
+    mask    the_mask, raster;
+    cell_list   *grid;
+    vector<double>  x, y, gamma, iso, total;
+    vector<int>     type, slot, count;
+    vector< vector<double> >    hist;
+    vector<thread>  workers;
+    point   p;
+    clock_t start = clock();
+
+    for(i = 1; (i < argc) && (argv[i][0] == '-') && (argv[i][1] == '-'); i++){
+        if(!strcmp(argv[i], "--polygon") && (i+1 < argc)){
+            polygon_file = argv[++i];
+        } else if(!strcmp(argv[i], "--bitmap") && (i+1 < argc)){
+            bitmap_file = argv[++i];
+        } else if(!strcmp(argv[i], "--pixel") && (i+1 < argc)){
+            pixel = atof(argv[++i]);
+            if(pixel <= 0.0) fatal_error("Bad pixel size: %g\n", pixel);
+        } else if(!strcmp(argv[i], "--translation")){
+            translation = true;
+        } else if(!strcmp(argv[i], "--range") && (i+1 < argc)){
+            range = atof(argv[++i]);
+            if(range <= 0.0) fatal_error("Bad range: %g\n", range);
+        } else if(!strcmp(argv[i], "--bin") && (i+1 < argc)){
+            dr = atof(argv[++i]);
+            if(dr <= 0.0) fatal_error("Bad bin width: %g\n", dr);
+        } else if(!strcmp(argv[i], "--threads") && (i+1 < argc)){
+            n_threads = atoi(argv[++i]);
+            if(n_threads < 1) fatal_error("Bad number of threads: %d\n", n_threads);
+        } else {
+            fatal_error("Unknown option or missing value: %s\n", argv[i]);
+        }
+    }
+    if( argc != i ) fatal_error("%s\n", "Wrong number of arguments");
+    if( polygon_file && bitmap_file ) fatal_error("%s\n", "Two masks");
+    n_bins = (int)ceil(range/dr);
+
+    state = new config(stdin);              // The particles and mask
+    if(bitmap_file){
+        read_bitmap(bitmap_file, (pixel > 0.0) ? pixel : 1.0, &the_mask);
+        x_max = the_mask.n_x*the_mask.pixel;
+        y_max = the_mask.n_y*the_mask.pixel;
+    } else {
+        if(polygon_file){
+            read_polygon(polygon_file, &the_mask);
+        } else {
+            the_mask.is_bitmap = false;
+            the_mask.rings.push_back(vector<point>());
+            p.x = 0.0;           p.y = 0.0;           the_mask.rings[0].push_back(p);
+            p.x = state->x_size;                      the_mask.rings[0].push_back(p);
+                                 p.y = state->y_size; the_mask.rings[0].push_back(p);
+            p.x = 0.0;                                the_mask.rings[0].push_back(p);
+        }
+        for(unsigned int k = 0; k < the_mask.rings.size(); k++)
+            for(unsigned int v = 0; v < the_mask.rings[k].size(); v++){
+                if(the_mask.rings[k][v].x < 0.0 || the_mask.rings[k][v].y < 0.0)
+                    fatal_error("%s\n", "The mask has negative coordinates");
+                x_max = max(x_max, the_mask.rings[k][v].x);
+                y_max = max(y_max, the_mask.rings[k][v].y);
+            }
+    }
+    for(i = 0; i < state->n_objects(); i++){
+        obj = state->get_object(i);
+        if(!inside(the_mask, obj->pos_x, obj->pos_y)) continue;
+        x.push_back(obj->pos_x);
+        y.push_back(obj->pos_y);
+        type.push_back(obj->o_type);
+        n_types = max(n_types, obj->o_type + 1);
+    }
+    n = x.size();
+    area = mask_area(the_mask);
+    fprintf(stderr, "%d particles inside the mask of area %g, %d outside\n",
+            n, area, state->n_objects() - n);
+    delete state;
+    if(n < 2) fatal_error("%s\n", "Too few particles");
+    n_t = min(n_threads, n);
+
+    if(translation){                        // The weights
+        const mask  *m = &the_mask;
+        if(!the_mask.is_bitmap){
+            rasterize(the_mask, (pixel > 0.0) ? pixel : 0.5*dr, x_max, y_max, &raster);
+            m = &raster;
+        }
+        gamma.assign(n_bins, 0.0);
+        for(int t = 1; t < n_t; t++)
+            workers.push_back(thread(covariance, m, dr, (t*n_bins)/n_t,
+                    ((t+1)*n_bins)/n_t, &gamma));
+        covariance(m, dr, 0, n_bins/n_t, &gamma);
+        for(unsigned int t = 0; t < workers.size(); t++) workers[t].join();
+        workers.clear();
+        for(int k = 0; k < n_bins; k++)
+            gamma[k] = (gamma[k] > 0.0) ? area/gamma[k] : 0.0;
+    } else {
+        slot.assign(n, -1);
+        for(i = 0; i < n; i++)
+            if(!clear_of_edges(the_mask, x[i], y[i], range))
+                slot[i] = n_bins*n_edge++;
+        iso.assign(n_bins*n_edge, 1.0);
+        for(int t = 1; t < n_t; t++)
+            workers.push_back(thread(edge_terms, &the_mask, &x, &y, n_bins, dr,
+                    (t*n)/n_t, ((t+1)*n)/n_t, &iso, &slot));
+        edge_terms(&the_mask, &x, &y, n_bins, dr, 0, n/n_t, &iso, &slot);
+        for(unsigned int t = 0; t < workers.size(); t++) workers[t].join();
+        workers.clear();
+        fprintf(stderr, "%d particles near the edges\n", n_edge);
+    }
+
+    grid = new cell_list(x_max, y_max, range, false);   // The pairs
+    for(i = 0; i < n; i++) grid->insert(i, x[i], y[i]);
+    hist.assign(n_t, vector<double>(n_types*n_types*n_bins, 0.0));
+    for(int t = 1; t < n_t; t++)
+        workers.push_back(thread(count_pairs, &x, &y, &type, grid, n_types,
+                n_bins, dr, &iso, &slot, translation ? &gamma : NULL,
+                (t*n)/n_t, ((t+1)*n)/n_t, &hist[t]));
+    count_pairs(&x, &y, &type, grid, n_types, n_bins, dr, &iso, &slot,
+            translation ? &gamma : NULL, 0, n/n_t, &hist[0]);
+    for(unsigned int t = 0; t < workers.size(); t++) workers[t].join();
+    for(int t = 1; t < n_t; t++)
+        for(unsigned int k = 0; k < hist[0].size(); k++) hist[0][k] += hist[t][k];
+
+    count.assign(n_types, 0);
+    for(i = 0; i < n; i++) count[type[i]]++;
+    printf("# r total");
+    for(int a = 0; a < n_types; a++)
+        for(int b = a; b < n_types; b++)
+            printf(" %d-%d", a, b);
+    printf("\n");
+    total.assign(n_bins, 0.0);
+    for(int k = 0; k < n_bins; k++){
+        shell = M_PI*dr*dr*(2*k+1);
+        for(int a = 0; a < n_types*n_types; a++) total[k] += hist[0][a*n_bins + k];
+        printf("%g %g", (k+0.5)*dr, area*total[k]/(n*(n-1.0)*shell));
+        for(int a = 0; a < n_types; a++){
+            for(int b = a; b < n_types; b++){
+                norm = (a == b) ? count[a]*(count[a] - 1.0) : 2.0*count[a]*count[b];
+                printf(" %g", (norm > 0.0) ? area*(hist[0][(a*n_types + b)*n_bins + k]
+                        + ((a == b) ? 0.0 : hist[0][(b*n_types + a)*n_bins + k]))
+                        /(norm*shell) : 0.0);
+            }
+        }
+        printf("\n");
+    }
+    fprintf(stderr, "g(r) of %d particles in %g s\n", n,
+            (double)(clock()-start)/CLOCKS_PER_SEC);
+
+    delete grid;
+
+    return 0;
+}
@@ -0,0 +1,379 @@
+/**
+ * \file    reweight.cpp
+ * \author  agent
+ * \date    October 17, 2026
+ * \version 1.0
+ * \brief   Estimate averages at other temperatures by histogram reweighting.
+ *
+ * This file contains the main routine for the reweight program that is part
+ * of the Very Coarse Grained disc simulation programmes.
+ *
+ * A run at one beta also samples, with less weight, the configurations that
+ * matter at nearby betas. The program reads the per sample energies and
+ * observables recorded by NVT (option --frames, see the frames class) for one
+ * or more runs of the same system at different betas and estimates the
+ * averages over a range of betas:
+ * * with one run this is single histogram reweighting (Ferrenberg and
+ *   Swendsen 1988), each sample n is weighted by exp(-(beta - beta_0) E_n);
+ * * with several runs the samples are pooled with the multiple histogram
+ *   method (Ferrenberg and Swendsen 1989), in its binless form that is also
+ *   the MBAR estimator (Shirts and Chodera 2008). The dimensionless free
+ *   energies f_k of the runs are the solution of
+ *
+ *      f_k = -ln sum_n exp(-beta_k E_n) / sum_j N_j exp(f_j - beta_j E_n)
+ *
+ *   found by iteration, and a sample then has the weight
+ *   exp(-beta E_n) / sum_j N_j exp(f_j - beta_j E_n) at beta.
+ *
+ * The errors are estimated by bootstrap: the samples of each run are
+ * resampled in blocks longer than twice their autocorrelation time (so the
+ * correlations are kept), the free energies are solved again and the
+ * averages recalculated, the error is the standard deviation over the
+ * replicas.
+ *
+ * The estimates are only reliable where the runs sample the important
+ * configurations. For each beta the effective number of samples (sum w)^2 /
+ * sum w^2 is given, and a warning written when it is small, which happens
+ * between runs too far apart and beyond the range of the runs.
+ *
+ * Usage:
+ *          reweight [options] beta_min beta_max frames_file ... > estimates
+ *
+ * The options are:
+ *      --points n      The number of betas in the range (21).
+ *      --bootstrap n   The number of bootstrap replicas, 0 for no errors (100).
+ *      --block l       The length of the bootstrap blocks (2 tau of the
+ *                      energy of each run).
+ *      --seed s        Seed for the random number generator.
+ *
+ * The output has one line per beta with: beta, the effective number of
+ * samples, the mean energy and its error, the heat capacity beta^2 var(E) and
+ * its error, then the mean and error of each observable of the frames files
+ * (which must all have the same observables). Progress is reported on the
+ * standard error stream.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include <string>
+#include "../NVT/blocking.h"
+#include "../NVT/common.h"
+
+using namespace std;
+
+#define fatal_error(format, value) {\
+                    fprintf(stderr, format, value ); \
+                    usage(); \
+                    exit(EXIT_FAILURE); \
+                }
+
+#define REW_TOL         1E-10       // Convergence of the free energies
+#define REW_MAX_ITER    100000      // Iterations allowed for the free energies
+#define REW_MIN_ESS     50.0        // Effective samples below which to warn
+#define REW_LINE        4096        // Longest line of a frames file
+
+void usage(){
+    fprintf(stderr, "Usage: reweight %s\n",
+        "[--points n] [--bootstrap n] [--block l] [--seed s]\n"
+        "           beta_min beta_max frames_file ... > estimates");
+}
+
+/**
+ * The samples of one run.
+ */
+struct run {
+    double  beta;                           ///< Temperature parameter of the run.
+    int     n_values;                       ///< Values per sample, the energy first.
+    vector<double>  values;                 ///< The values, n_values per sample.
+    int     block;                          ///< Bootstrap block length.
+    /// @return The number of samples.
+    int     size() const { return values.size()/n_values; }
+    /// @return The energy of sample i.
+    double  energy(int i) const { return values[i*n_values]; }
+};
+
+/**
+ * @brief Read a frames file written by NVT.
+ * @param fname The file name.
+ * @param a_run The run, filled.
+ * @param names The names of the values, set from the first file and checked
+ *              against it for the others.
+ */
+void    read_frames(const char *fname, run *a_run, vector<string> &names){
+    FILE    *src;
+    char    line[REW_LINE], *p, *tok;
+    vector<string>  these;
+    double  value;
+    int     n;
+
+    if(! (src = fopen(fname, "r")))
+        fatal_error("Unable to open %s for reading\n", fname);
+    if(! fgets(line, REW_LINE, src)
+            || sscanf(line, "# frames beta = %lf", &a_run->beta) != 1)
+        fatal_error("Not a frames file: %s\n", fname);
+    if(! fgets(line, REW_LINE, src) || line[0] != '#')
+        fatal_error("No value names in %s\n", fname);
+    for(tok = strtok(line+1, " \t\n"); tok; tok = strtok(NULL, " \t\n"))
+        these.push_back(tok);
+    if(these.empty() || these[0] != "energy")
+        fatal_error("No energy in %s\n", fname);
+    if(names.empty()) names = these;
+    if(these != names)
+        fatal_error("Values of %s differ from those of the first file\n", fname);
+    a_run->n_values = these.size();
+    while(fgets(line, REW_LINE, src)){
+        if(line[0] == '#') continue;
+        for(p = line, n = 0; n < a_run->n_values; n++){
+            value = strtod(p, &tok);
+            if(tok == p) break;
+            a_run->values.push_back(value);
+            p = tok;
+        }
+        if(n == 0) continue;                // Blank line
+        if(n != a_run->n_values)
+            fatal_error("Incomplete sample in %s\n", fname);
+    }
+    fclose(src);
+    if(a_run->size() < 2) fatal_error("Too few samples in %s\n", fname);
+}
+
+/**
+ * @brief The log of the denominator of the weights of a sample,
+ * ln sum_j N_j exp(f_j - beta_j E).
+ * @param runs  The runs.
+ * @param n_run The number of samples used from each run.
+ * @param f     The free energies of the runs.
+ * @param e     The energy of the sample.
+ * @return      The log of the denominator.
+ */
+double  log_denominator(const vector<run> &runs, const vector<int> &n_run,
+                        const vector<double> &f, double e){
+    double  top = -HUGE_VAL, sum = 0.0, t;
+
+    for(unsigned int j = 0; j < runs.size(); j++)
+        top = max(top, f[j] - runs[j].beta*e);
+    for(unsigned int j = 0; j < runs.size(); j++){
+        t = f[j] - runs[j].beta*e;
+        sum += n_run[j]*exp(t - top);
+    }
+    return top + log(sum);
+}
+
+/**
+ * @brief Solve the free energies of the runs by self consistent iteration.
+ *
+ * With a single run there is nothing to solve. The free energies are fixed
+ * by f_0 = 0.
+ *
+ * @param runs  The runs.
+ * @param pick  The samples used from each run (indices, repeats allowed).
+ * @param f     The free energies, the starting point on entry.
+ * @return      The number of iterations or -1 if they did not converge.
+ */
+int     solve(const vector<run> &runs, const vector< vector<int> > &pick,
+              vector<double> &f){
+    int     k_max = runs.size();
+    vector<int>     n_run(k_max);
+    vector<double>  log_den, g(k_max), top(k_max);
+    double  change, e;
+    int     iter;
+
+    for(int k = 0; k < k_max; k++) n_run[k] = pick[k].size();
+    if(k_max == 1){ f[0] = 0.0; return 0; }
+    for(iter = 1; iter <= REW_MAX_ITER; iter++){
+        log_den.clear();
+        for(int j = 0; j < k_max; j++)
+            for(unsigned int m = 0; m < pick[j].size(); m++)
+                log_den.push_back(log_denominator(runs, n_run, f,
+                        runs[j].energy(pick[j][m])));
+        for(int k = 0; k < k_max; k++){     // f_k = -ln sum exp(-b_k E - ln den)
+            top[k] = -HUGE_VAL;
+            for(int j = 0, n = 0; j < k_max; j++)
+                for(unsigned int m = 0; m < pick[j].size(); m++, n++)
+                    top[k] = max(top[k], -runs[k].beta*runs[j].energy(pick[j][m])
+                            - log_den[n]);
+            g[k] = 0.0;
+            for(int j = 0, n = 0; j < k_max; j++)
+                for(unsigned int m = 0; m < pick[j].size(); m++, n++){
+                    e = runs[j].energy(pick[j][m]);
+                    g[k] += exp(-runs[k].beta*e - log_den[n] - top[k]);
+                }
+            g[k] = -(top[k] + log(g[k]));
+        }
+        change = 0.0;
+        for(int k = k_max-1; k >= 0; k--){
+            g[k] -= g[0];
+            change = max(change, fabs(g[k] - f[k]));
+            f[k] = g[k];
+        }
+        if(change < REW_TOL) return iter;
+    }
+    return -1;
+}
+
+/**
+ * @brief The reweighted averages at one beta.
+ * @param runs  The runs.
+ * @param pick  The samples used from each run.
+ * @param f     The free energies of the runs.
+ * @param beta  The temperature parameter.
+ * @param ess   Set to the effective number of samples.
+ * @param out   Set to the mean energy, the heat capacity and the mean of
+ *              each observable.
+ */
+void    estimate(const vector<run> &runs, const vector< vector<int> > &pick,
+                 const vector<double> &f, double beta, double *ess,
+                 vector<double> &out){
+    int     n_val = runs[0].n_values;
+    vector<int>     n_run(runs.size());
+    vector<double>  log_w, sum(n_val + 1, 0.0);
+    double  top = -HUGE_VAL, w, w_sum = 0.0, w2_sum = 0.0, e;
+    const double  *v;
+
+    for(unsigned int k = 0; k < runs.size(); k++) n_run[k] = pick[k].size();
+    for(unsigned int j = 0; j < runs.size(); j++)
+        for(unsigned int m = 0; m < pick[j].size(); m++){
+            e = runs[j].energy(pick[j][m]);
+            log_w.push_back(-beta*e - log_denominator(runs, n_run, f, e));
+            top = max(top, log_w.back());
+        }
+    for(unsigned int j = 0, n = 0; j < runs.size(); j++)
+        for(unsigned int m = 0; m < pick[j].size(); m++, n++){
+            w = exp(log_w[n] - top);
+            v = &runs[j].values[pick[j][m]*n_val];
+            w_sum  += w;
+            w2_sum += w*w;
+            sum[0] += w*v[0]*v[0];          // Energy squared first
+            for(int k = 0; k < n_val; k++) sum[k+1] += w*v[k];
+        }
+    *ess = w_sum*w_sum/w2_sum;
+    out.assign(n_val + 1, 0.0);
+    out[0] = sum[1]/w_sum;                  // Energy, heat capacity, others
+    out[1] = beta*beta*(sum[0]/w_sum - out[0]*out[0]);
+    for(int k = 1; k < n_val; k++) out[k+1] = sum[k+1]/w_sum;
+}
+
+/**
+ * Read the options and frames files, solve the free energies and write the
+ * estimates.
+ */
+int main(int argc, char **argv)
+{
+    int     i, n_points = 21, n_boot = 100, block = 0, n, n_iter;
+    double  beta_min, beta_max, beta, ess;
+    vector<run>     runs;
+    vector<string>  names;
+    vector< vector<int> >   all, pick;
+    vector<double>  f, f_boot, out;
+    vector<double>  mean, mean2;
+    vector< vector<double> >    best;
+    vector<double>  best_ess;
+    blocking    *series;
+
+    for(i = 1; (i < argc) && (argv[i][0] == '-') && (argv[i][1] == '-'); i++){
+        if(!strcmp(argv[i], "--points") && (i+1 < argc)){
+            n_points = atoi(argv[++i]);
+            if(n_points < 1) fatal_error("Bad number of points: %d\n", n_points);
+        } else if(!strcmp(argv[i], "--bootstrap") && (i+1 < argc)){
+            n_boot = atoi(argv[++i]);
+            if(n_boot < 0) fatal_error("Bad number of replicas: %d\n", n_boot);
+        } else if(!strcmp(argv[i], "--block") && (i+1 < argc)){
+            block = atoi(argv[++i]);
+            if(block < 1) fatal_error("Bad block length: %d\n", block);
+        } else if(!strcmp(argv[i], "--seed") && (i+1 < argc)){
+            srand(atol(argv[++i]));
+        } else {
+            fatal_error("Unknown option or missing value: %s\n", argv[i]);
+        }
+    }
+    if( argc - i < 3 ) fatal_error("%s\n", "Wrong number of arguments");
+    beta_min = atof(argv[i]);
+    beta_max = atof(argv[i+1]);
+    if( beta_max < beta_min ) fatal_error("%s\n", "Bad range of beta");
+
+    runs.resize(argc - i - 2);
+    for(unsigned int k = 0; k < runs.size(); k++){
+        read_frames(argv[i+2+k], &runs[k], names);
+        series = new blocking();            // Block length from tau
+        for(n = 0; n < runs[k].size(); n++) series->add(runs[k].energy(n));
+        runs[k].block = block ? block : max(1, (int)ceil(2.0*series->tau()));
+        runs[k].block = min(runs[k].block, runs[k].size());
+        fprintf(stderr, "Run %d: beta = %g samples = %d tau = %g block = %d\n",
+                k, runs[k].beta, runs[k].size(), series->tau(), runs[k].block);
+        delete series;
+        all.push_back(vector<int>());
+        for(n = 0; n < runs[k].size(); n++) all[k].push_back(n);
+    }
+
+    f.assign(runs.size(), 0.0);             // All the samples
+    for(unsigned int k = 0; k < runs.size(); k++) f[k] = runs[k].beta*runs[k].energy(0);
+    n_iter = solve(runs, all, f);
+    if(n_iter < 0)
+        fprintf(stderr, "Warning: free energies not converged in %d iterations\n",
+                REW_MAX_ITER);
+    for(unsigned int k = 0; k < runs.size(); k++)
+        fprintf(stderr, "Run %d: f = %g\n", k, f[k]);
+    for(int p = 0; p < n_points; p++){
+        beta = (n_points > 1) ? beta_min + p*(beta_max-beta_min)/(n_points-1)
+                              : beta_min;
+        estimate(runs, all, f, beta, &ess, out);
+        best.push_back(out);
+        best_ess.push_back(ess);
+        if(ess < REW_MIN_ESS)
+            fprintf(stderr, "Warning: only %g effective samples at beta = %g\n",
+                    ess, beta);
+    }
+
+    mean.assign(n_points*best[0].size(), 0.0);  // Bootstrap replicas
+    mean2.assign(n_points*best[0].size(), 0.0);
+    pick.resize(runs.size());
+    for(int b = 0; b < n_boot; b++){
+        for(unsigned int k = 0; k < runs.size(); k++){
+            n = runs[k].size();
+            pick[k].clear();
+            while((int)pick[k].size() < n){
+                int start = rand() % (n - runs[k].block + 1);
+                for(int m = 0; m < runs[k].block && (int)pick[k].size() < n; m++)
+                    pick[k].push_back(start + m);
+            }
+        }
+        f_boot = f;
+        if(solve(runs, pick, f_boot) < 0)
+            fprintf(stderr, "Warning: replica %d not converged\n", b);
+        for(int p = 0; p < n_points; p++){
+            beta = (n_points > 1) ? beta_min + p*(beta_max-beta_min)/(n_points-1)
+                                  : beta_min;
+            estimate(runs, pick, f_boot, beta, &ess, out);
+            for(unsigned int q = 0; q < out.size(); q++){
+                mean[p*out.size()+q]  += out[q];
+                mean2[p*out.size()+q] += out[q]*out[q];
+            }
+        }
+    }
+
+    printf("# beta ess energy d_energy heat_capacity d_heat_capacity");
+    for(unsigned int k = 1; k < names.size(); k++)
+        printf(" %s d_%s", names[k].c_str(), names[k].c_str());
+    printf("\n");
+    for(int p = 0; p < n_points; p++){
+        beta = (n_points > 1) ? beta_min + p*(beta_max-beta_min)/(n_points-1)
+                              : beta_min;
+        printf("%g %g", beta, best_ess[p]);
+        for(unsigned int q = 0; q < best[p].size(); q++){
+            double  m = 0.0, err = 0.0;
+            if(n_boot > 1){
+                m   = mean[p*best[p].size()+q]/n_boot;
+                err = mean2[p*best[p].size()+q]/n_boot - m*m;
+                err = sqrt(max(0.0, err*n_boot/(n_boot-1)));
+            }
+            printf(" %g %g", best[p][q], err);
+        }
+        printf("\n");
+    }
+    fprintf(stderr, "%d runs, %d points, %d bootstrap replicas\n",
+            (int)runs.size(), n_points, n_boot);
+
+    return 0;
+}
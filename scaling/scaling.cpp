@@ -0,0 +1,365 @@
+/**
+ * \file    scaling.cpp
+ * \author  agent
+ * \date    October 17, 2026
+ * \version 1.0
+ * \brief   End to end scaling benchmark of the NVT integration.
+ *
+ * This file contains the main routine for the scaling program that is part
+ * of the Very Coarse Grained disc simulation programmes.
+ *
+ * Where the bench program times the kernels one by one, this program runs
+ * the NVT integration itself, in process, over a matrix of number of objects,
+ * packing fraction, object type mix and number of threads, to find where the
+ * scaling breaks and to catch performance regressions. For each combination:
+ * * generate, the configuration is made by random sequential adsorption in a
+ *   periodic box, as by makeconfig, after seeding the random number
+ *   generator so each run is reproducible;
+ * * energy, the first, full, evaluation of the energy;
+ * * warmup, the first sweeps (of n_objects steps) are not measured;
+ * * integrate, the integrator is called step by step, an accepted step
+ *   replaces the configuration so the accepted moves are counted exactly.
+ *   After each chunk of n_objects/10 steps (at most 1000) the distance moved
+ *   by each object is added up (as few objects move twice in a chunk this is
+ *   the accepted displacement) and after each sweep the energy is added to a
+ *   blocking estimator;
+ * * analysis, after each sweep the clusters are found (see cluster) with the
+ *   given number of threads. This is the only part of the run that uses
+ *   threads, the integration itself is serial, so the number of threads
+ *   changes t_analysis but not the integration rates;
+ * * write, the final configuration is written to a temporary file.
+ * The warmup and the integration each stop after their number of sweeps or
+ * once they have used the given time.
+ *
+ * The results are written as a table, one line per run:
+ *
+ *      n_objects packing mix threads steps moves_per_s acceptance
+ *      displacement_per_s ess ess_per_s peak_rss_kb t_generate t_energy
+ *      t_warmup t_integrate t_analysis t_write stopped
+ *
+ * the rates are per second of the integration (without the analyses), the
+ * effective samples (ess) of the energy are from the blocking estimate of
+ * its autocorrelation time, the times are wall clock seconds and stopped is 1
+ * if the run used up its time. The energy is sampled once per sweep and the
+ * estimate needs at least SCALING_MIN_SWEEPS samples, so fewer sweeps are
+ * refused and a run stopped before that many gives -1 for ess and ess_per_s. The peak resident memory is reset before each
+ * run where the system allows it (Linux /proc/self/clear_refs), otherwise it
+ * is the peak of the process so far. Progress is reported on the standard
+ * error stream.
+ *
+ * The full energy evaluation and each integrator step (which copies the
+ * configuration and recomputes the energies of the neighbours of the moved
+ * object against all the others) take a time proportional to n_objects^2 and
+ * n_objects, so the largest sizes are limited by the first energy, which
+ * cannot be interrupted, more than by the time allowed. In practice this is
+ * about 10^5 objects, larger sizes are run but a warning is given as the
+ * first energy alone takes hours.
+ *
+ * Usage:
+ *          scaling [options] > results
+ *
+ * The options are:
+ *      --sizes n,..    The numbers of objects (1000,4000).
+ *      --packing f,..  The packing fractions (0.1,0.3).
+ *      --mix p,../..   The proportions of the object types of each mix, the
+ *                      mixes separated by / (1,0/0.7,0.3).
+ *      --threads n,..  The numbers of threads of the cluster analysis (1,4).
+ *      --sweeps n      The sweeps measured in each run (100, at least 64).
+ *      --warmup n      The sweeps before the measures (1).
+ *      --max-time t    The time allowed for the warmup and for the
+ *                      integration of a run (60 s).
+ *      --beta b        The temperature parameter (1).
+ *      --delayed       Use delayed acceptance (see integrator).
+ *      --seed s        The seed of the configurations and integration (1).
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <sys/resource.h>
+#include <vector>
+#include "../NVT/integrator.h"
+#include "../NVT/cluster.h"
+#include "../NVT/blocking.h"
+#include "../NVT/options.h"
+#include "../NVT/placer.h"
+#include "../NVT/common.h"
+
+using namespace std;
+
+#define fatal_error(format, value) {\
+                    fprintf(stderr, format, value ); \
+                    usage(); \
+                    exit(EXIT_FAILURE); \
+                }
+
+#define SCALING_ATTEMPTS    10000   // Trials to place an object
+#define SCALING_CHUNK       1000    // Most steps between displacement measures
+#define SCALING_LINE        256     // Longest line of /proc/self/status
+#define SCALING_MIN_SWEEPS  64      // Fewest energy samples for the ess
+#define SCALING_LARGE       100000  // Most objects with a practical first energy
+
+void usage(){
+    fprintf(stderr, "Usage: scaling %s\n",
+        "[--sizes n,..] [--packing f,..] [--mix p,../..] [--threads n,..]\n"
+        "               [--sweeps n] [--warmup n] [--max-time t] [--beta b]\n"
+        "               [--delayed] [--seed s] > results");
+}
+
+/**
+ * @return The wall clock time in seconds.
+ */
+double  wall_time(){
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + 1e-9*now.tv_nsec;
+}
+
+/**
+ * @brief Reset the peak resident memory of the process, if possible.
+ * @return  True if it was reset.
+ */
+bool    reset_peak_rss(){
+    FILE    *dest = fopen("/proc/self/clear_refs", "w");
+
+    if(!dest) return false;
+    fprintf(dest, "5\n");
+    return fclose(dest) == 0;
+}
+
+/**
+ * @return The peak resident memory of the process in kB.
+ */
+long    peak_rss(){
+    FILE    *src = fopen("/proc/self/status", "r");
+    char    line[SCALING_LINE];
+    long    value = -1;
+    struct rusage   usage;
+
+    if(src){
+        while(fgets(line, SCALING_LINE, src))
+            if(sscanf(line, "VmHWM: %ld", &value) == 1) break;
+        fclose(src);
+    }
+    if(value < 0 && getrusage(RUSAGE_SELF, &usage) == 0) value = usage.ru_maxrss;
+    return value;
+}
+
+/**
+ * @brief The unwrapped positions of the objects.
+ * @param state The configuration.
+ * @param x     The x coordinates, filled.
+ * @param y     The y coordinates, filled.
+ */
+void    unwrapped(config *state, vector<double> &x, vector<double> &y){
+    object  *obj;
+
+    x.resize(state->n_objects());
+    y.resize(state->n_objects());
+    for(int i = 0; i < state->n_objects(); i++){
+        obj  = state->get_object(i);
+        x[i] = obj->pos_x + obj->image_x*state->x_size;
+        y[i] = obj->pos_y + obj->image_y*state->y_size;
+    }
+}
+
+/**
+ * Read the options, then make one run for each combination of the matrix
+ * and write its line of the results.
+ */
+int main(int argc, char **argv)
+{
+    int     i, n, n_sweeps = 100, n_warmup = 1, chunk, length, n_steps, n_accepted;
+    long    seed = 1;
+    double  max_time = 60.0, beta = 1.0, start, t_total, moved, dx, dy, ess;
+    double  t_generate, t_energy, t_warmup, t_integrate, t_analysis, t_write;
+    bool    delayed = false, stopped, can_reset;
+    const char  *p;
+    char    mix_name[64];
+    vector<double>  sizes, packing, n_threads, x0, y0, x1, y1;
+    vector< vector<double> >    mixes;
+    topology    *the_topology = new topology();
+    force_field *the_forces = new force_field();
+    placer      *the_placer = new placer(the_forces, SCALING_ATTEMPTS);
+    config      *state, *previous;
+    integrator  *the_integrator;
+    cluster     *the_clusters;
+    blocking    *energies;
+    FILE        *tmp;
+
+    for(i = 1; (i < argc) && (argv[i][0] == '-') && (argv[i][1] == '-'); i++){
+        if(!strcmp(argv[i], "--sizes") && (i+1 < argc)){
+            p = parse_list(argv[++i], sizes);
+            if(!p || *p) fatal_error("Bad list: %s\n", argv[i]);
+        } else if(!strcmp(argv[i], "--packing") && (i+1 < argc)){
+            p = parse_list(argv[++i], packing);
+            if(!p || *p) fatal_error("Bad list: %s\n", argv[i]);
+        } else if(!strcmp(argv[i], "--mix") && (i+1 < argc)){
+            for(p = argv[++i]; *p; ){
+                mixes.push_back(vector<double>());
+                p = parse_list(p, mixes.back());
+                if(!p) fatal_error("Bad list: %s\n", argv[i]);
+                if(*p == '/') p++;
+            }
+        } else if(!strcmp(argv[i], "--threads") && (i+1 < argc)){
+            p = parse_list(argv[++i], n_threads);
+            if(!p || *p) fatal_error("Bad list: %s\n", argv[i]);
+        } else if(!strcmp(argv[i], "--sweeps") && (i+1 < argc)){
+            n_sweeps = atoi(argv[++i]);
+            if(n_sweeps < SCALING_MIN_SWEEPS)
+                fatal_error("Too few sweeps for the ess: %d\n", n_sweeps);
+        } else if(!strcmp(argv[i], "--warmup") && (i+1 < argc)){
+            n_warmup = atoi(argv[++i]);
+            if(n_warmup < 0) fatal_error("Bad number of sweeps: %d\n", n_warmup);
+        } else if(!strcmp(argv[i], "--max-time") && (i+1 < argc)){
+            max_time = atof(argv[++i]);
+            if(max_time <= 0.0) fatal_error("Bad time: %g\n", max_time);
+        } else if(!strcmp(argv[i], "--beta") && (i+1 < argc)){
+            beta = atof(argv[++i]);
+        } else if(!strcmp(argv[i], "--delayed")){
+            delayed = true;
+        } else if(!strcmp(argv[i], "--seed") && (i+1 < argc)){
+            seed = atol(argv[++i]);
+        } else {
+            fatal_error("Unknown option or missing value: %s\n", argv[i]);
+        }
+    }
+    if( argc != i ) fatal_error("%s\n", "Wrong number of arguments");
+    if(sizes.empty()){ sizes.push_back(1000); sizes.push_back(4000); }
+    if(packing.empty()){ packing.push_back(0.1); packing.push_back(0.3); }
+    if(mixes.empty()){
+        mixes.resize(2);
+        mixes[0].push_back(1.0); mixes[0].push_back(0.0);
+        mixes[1].push_back(0.7); mixes[1].push_back(0.3);
+    }
+    if(n_threads.empty()){ n_threads.push_back(1); n_threads.push_back(4); }
+    for(unsigned int k = 0; k < sizes.size(); k++){
+        if(sizes[k] < 2) fatal_error("Bad number of objects: %g\n", sizes[k]);
+        if(sizes[k] > SCALING_LARGE)
+            fprintf(stderr, "Warning: the first energy of %g objects takes a "
+                    "time proportional to n_objects^2\n", sizes[k]);
+    }
+    for(unsigned int k = 0; k < packing.size(); k++)
+        if(packing[k] <= 0.0 || packing[k] >= 1.0)
+            fatal_error("Bad packing fraction: %g\n", packing[k]);
+    for(unsigned int k = 0; k < mixes.size(); k++)
+        if(mixes[k].empty() || (int)mixes[k].size() > the_topology->n_types())
+            fatal_error("Bad mix %d\n", k);
+    for(unsigned int k = 0; k < n_threads.size(); k++)
+        if(n_threads[k] < 1) fatal_error("Bad number of threads: %g\n", n_threads[k]);
+    if(!(tmp = tmpfile())) fatal_error("%s\n", "Unable to open a temporary file");
+
+    printf("# n_objects packing mix threads steps moves_per_s acceptance "
+           "displacement_per_s ess ess_per_s peak_rss_kb t_generate t_energy "
+           "t_warmup t_integrate t_analysis t_write stopped\n");
+    for(unsigned int s = 0; s < sizes.size(); s++)
+    for(unsigned int f = 0; f < packing.size(); f++)
+    for(unsigned int m = 0; m < mixes.size(); m++)
+    for(unsigned int t = 0; t < n_threads.size(); t++){
+        mix_name[0] = '\0';
+        for(unsigned int k = 0; k < mixes[m].size(); k++)
+            snprintf(mix_name + strlen(mix_name), sizeof(mix_name) - strlen(mix_name),
+                    k ? ":%g" : "%g", mixes[m][k]);
+        can_reset = reset_peak_rss();
+        srand(seed);
+
+        start = wall_time();                // Generate
+        state = the_placer->generate(the_topology, (int)sizes[s], packing[f],
+                mixes[m]);
+        t_generate = wall_time() - start;
+        if(!state){
+            fprintf(stderr, "Random sequential adsorption jammed for %d objects "
+                    "at packing %g, mix %s, skipped\n", (int)sizes[s], packing[f],
+                    mix_name);
+            continue;
+        }
+        n = state->n_objects();
+        fprintf(stderr, "%d objects at packing %g, mix %s, %d threads\n",
+                n, packing[f], mix_name, (int)n_threads[t]);
+
+        start = wall_time();                // First energy
+        state->energy(the_forces);
+        t_energy = wall_time() - start;
+
+        the_integrator = new integrator(the_forces);
+        the_integrator->dl_max = min(state->x_size, state->y_size)/2.0;
+        the_integrator->delayed = delayed;
+        the_clusters = new cluster(NULL, the_forces, 1.1, false, 0.0,
+                (int)n_threads[t]);
+        energies = new blocking();
+        chunk = max(1, min(SCALING_CHUNK, n/10));
+
+        start = wall_time();                // Warm up
+        for(int k = 0; k < n_warmup*n && wall_time() - start < max_time; k++)
+            the_integrator->run(&state, beta, 1.0, 1);
+        t_warmup = wall_time() - start;
+
+        n_steps = n_accepted = 0;
+        t_integrate = t_analysis = 0.0;
+        moved = 0.0;
+        stopped = false;
+        unwrapped(state, x0, y0);
+        for(int k = 0; k < n_sweeps*n && !stopped; k += length){
+            length = min(chunk, n_sweeps*n - k);
+            start = wall_time();            // An accepted step replaces the
+            for(int j = 0; j < length; j++){    // configuration
+                previous = state;
+                the_integrator->run(&state, beta, 1.0, 1);
+                if(state != previous) n_accepted++;
+                n_steps++;
+                if(t_integrate + wall_time() - start >= max_time
+                        && k + j + 1 < n_sweeps*n){
+                    stopped = true;
+                    length  = j + 1;
+                }
+            }
+            t_integrate += wall_time() - start;
+            unwrapped(state, x1, y1);
+            for(int j = 0; j < n; j++){
+                dx = x1[j] - x0[j];
+                dy = y1[j] - y0[j];
+                moved += sqrt(dx*dx + dy*dy);
+            }
+            x0.swap(x1);
+            y0.swap(y1);
+            if((k + length)/n > k/n || k + length >= n_sweeps*n){
+                start = wall_time();        // A sweep is complete
+                energies->add(state->energy(the_forces));
+                the_clusters->measure(state);
+                t_analysis += wall_time() - start;
+            }
+        }
+
+        start = wall_time();                // Checkpoint
+        rewind(tmp);
+        state->write(tmp);
+        fflush(tmp);
+        t_write = wall_time() - start;
+
+        t_total = max(t_integrate, 1e-9);
+        ess = (energies->n_values() >= SCALING_MIN_SWEEPS) ? energies->ess() : -1.0;
+        printf("%d %g %s %d %d %.4g %.4g %.4g %.4g %.4g %ld %.4g %.4g %.4g %.4g "
+               "%.4g %.4g %d\n", n, packing[f], mix_name, (int)n_threads[t],
+               n_steps, n_steps/t_total, n_steps ? (double)n_accepted/n_steps : 0.0,
+               moved/t_total, ess, (ess < 0.0) ? -1.0 : ess/t_total,
+               peak_rss(), t_generate, t_energy, t_warmup, t_integrate,
+               t_analysis, t_write, stopped ? 1 : 0);
+        fflush(stdout);
+        if(!can_reset)
+            fprintf(stderr, "The peak memory could not be reset, it is that of the process\n");
+
+        delete energies;
+        delete the_clusters;
+        delete the_integrator;
+        delete state;
+    }
+
+    fclose(tmp);
+    delete the_placer;
+    delete the_forces;
+    delete the_topology;
+
+    return 0;
+}
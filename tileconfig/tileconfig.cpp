@@ -0,0 +1,243 @@
+/**
+ * \file    tileconfig.cpp
+ * \author  agent
+ * \date    October 17, 2026
+ * \version 1.0
+ * \brief   Build a large configuration by tiling a small equilibrated one.
+ *
+ * This file contains the main routine for the tileconfig program that is part
+ * of the Very Coarse Grained disc simulation programmes.
+ *
+ * Equilibrating a very large system from a random start takes a very long
+ * time, while a small periodic box equilibrates quickly. The program reads an
+ * equilibrated periodic configuration and copies it k times along x and m
+ * times along y to give a large configuration that starts close to
+ * equilibrium.
+ *
+ * To avoid the large configuration being just k x m copies of the same
+ * structure each tile is given an independent random symmetry operation of
+ * the periodic box:
+ * * a random translation (with the positions wrapped into the tile),
+ * * a rotation by 180 degrees, or by a multiple of 90 degrees if the box is
+ *   square,
+ * * a reflection, only if all the object types are mirror symmetric (so the
+ *   reflected object is the same object with a new orientation).
+ * The object orientations are transformed with the positions. Optionally
+ * pairs of object types are exchanged in a random half of the tiles.
+ *
+ * Each tile is a valid periodic configuration but the edges of neighbouring
+ * tiles no longer match, so there can be hard core overlaps along the seams
+ * (or anywhere if types of different shape are exchanged). These are removed
+ * with the relaxer used by NVT.
+ *
+ * Usage:
+ *          tileconfig [--seed s] [--plain] [--swap a b] k m < small_config > large_config
+ *
+ * The options are:
+ *      --seed s        Seed for the random number generator.
+ *      --plain         Only copy the tiles, no symmetry operations.
+ *      --swap a b      Exchange object types a and b in a random half of the
+ *                      tiles (can be repeated).
+ *
+ * Progress is reported on the standard error stream.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include "../NVT/config.h"
+#include "../NVT/relaxer.h"
+#include "../NVT/common.h"
+
+using namespace std;
+
+#define fatal_error(format, value) {\
+                    fprintf(stderr, format, value ); \
+                    usage(); \
+                    exit(EXIT_FAILURE); \
+                }
+
+#define SYM_TOL     1E-9            // Tolerance for symmetry tests
+#define MAX_RELAX   100000          // Iterations allowed to remove overlaps
+
+void usage(){
+    fprintf(stderr, "Usage: tileconfig %s\n",
+        "[--seed s] [--plain] [--swap a b] k m < small_config > large_config");
+}
+
+/**
+ * @brief Put a coordinate back into the box with periodic conditions.
+ * @param x     The coordinate.
+ * @param size  The box size in this direction.
+ * @return      The wrapped coordinate.
+ */
+double  wrap(double x, double size){
+    x = fmod(x, size);
+    if(x < 0.0) x += size;
+    return x;
+}
+
+/**
+ * @brief Is an object type symmetric by reflection in its own x axis?
+ *
+ * This is true if for every atom at (x, y) there is an atom of the same type
+ * at (x, -y). The reflection of such an object is the same object with the
+ * opposite orientation.
+ *
+ * @param the_topology  The object topologies.
+ * @param type          The object type.
+ * @return              True if the object is mirror symmetric.
+ */
+bool    mirror_symmetric(topology *the_topology, int type){
+    atom    *at1, *at2;
+    bool    found;
+
+    for(int i = 0; i < the_topology->n_atom(type); i++){
+        at1 = the_topology->atoms(type, i);
+        found = false;
+        for(int j = 0; j < the_topology->n_atom(type) && !found; j++){
+            at2 = the_topology->atoms(type, j);
+            found = (at2->type == at1->type)
+                    && (fabs(at2->x_pos - at1->x_pos) < SYM_TOL)
+                    && (fabs(at2->y_pos + at1->y_pos) < SYM_TOL);
+        }
+        if(!found) return false;
+    }
+    return true;
+}
+
+/**
+ * Read the options and configuration, tile it and write the result.
+ */
+int main(int argc, char **argv)
+{
+    int     i, k, m, n, type, turn;
+    bool    plain = false, square, mirror;
+    double  x, y, theta, t;
+    double  shift_x, shift_y;
+    bool    reflect;
+    config  *small, *large;
+    topology    *the_topology = new topology();
+    force_field *forces = new force_field();
+    cell_list   *grid;
+    relaxer *the_relaxer;
+    object  *obj;
+    vector<int> swap_a, swap_b;
+    vector<int> map;
+
+    for(i = 1; (i < argc) && (argv[i][0] == '-') && (argv[i][1] == '-'); i++){
+        if(!strcmp(argv[i], "--seed") && (i+1 < argc)){
+            srand(atol(argv[++i]));
+        } else if(!strcmp(argv[i], "--plain")){
+            plain = true;
+        } else if(!strcmp(argv[i], "--swap") && (i+2 < argc)){
+            swap_a.push_back(atoi(argv[++i]));
+            swap_b.push_back(atoi(argv[++i]));
+        } else {
+            fatal_error("Unknown option or missing value: %s\n", argv[i]);
+        }
+    }
+    if( argc - i != 2 ) fatal_error("%s\n", "Wrong number of arguments");
+    k = atoi(argv[i]);
+    m = atoi(argv[i+1]);
+    if( k < 1 || m < 1 ) fatal_error("%s\n", "Bad number of tiles");
+    for(unsigned int s = 0; s < swap_a.size(); s++)
+        if( swap_a[s] < 0 || swap_a[s] >= the_topology->n_types()
+                || swap_b[s] < 0 || swap_b[s] >= the_topology->n_types() )
+            fatal_error("No topology for swapped type %d\n", max(swap_a[s], swap_b[s]));
+    for(unsigned int s = 0; s < swap_a.size(); s++)
+        if( the_topology->n_atom(swap_a[s]) != the_topology->n_atom(swap_b[s])
+                || fabs(the_topology->extent(swap_a[s])
+                        - the_topology->extent(swap_b[s])) > SYM_TOL )
+            fprintf(stderr, "Warning: types %d and %d differ in shape, "
+                    "swapping them will create overlaps\n", swap_a[s], swap_b[s]);
+
+    small = new config(stdin);
+    n = small->n_objects();
+    if(n < 1) fatal_error("%s\n", "Empty configuration");
+
+    square = fabs(small->x_size - small->y_size) < SYM_TOL*small->x_size;
+    mirror = true;
+    for(type = 0; type < the_topology->n_types(); type++)
+        mirror = mirror && mirror_symmetric(the_topology, type);
+
+    large = new config();
+    large->x_size = k*small->x_size;
+    large->y_size = m*small->y_size;
+    large->set_periodic(true);
+    large->add_topology(the_topology);
+
+    for(int tx = 0; tx < k; tx++){
+        for(int ty = 0; ty < m; ty++){
+            map.clear();                    // Type exchanges for this tile
+            for(type = 0; type < the_topology->n_types(); type++)
+                map.push_back(type);
+            for(unsigned int s = 0; s < swap_a.size(); s++){
+                if(rand() % 2){
+                    type = map[swap_a[s]];
+                    map[swap_a[s]] = map[swap_b[s]];
+                    map[swap_b[s]] = type;
+                }
+            }
+            if(plain){                      // The symmetry operation
+                shift_x = shift_y = 0.0; turn = 0; reflect = false;
+            } else {
+                shift_x = rnd_lin(small->x_size);
+                shift_y = rnd_lin(small->y_size);
+                turn    = square ? rand() % 4 : 2*(rand() % 2);
+                reflect = mirror && (rand() % 2);
+            }
+            for(i = 0; i < n; i++){
+                obj   = small->get_object(i);
+                x     = wrap(obj->pos_x + shift_x, small->x_size);
+                y     = wrap(obj->pos_y + shift_y, small->y_size);
+                theta = obj->orientation;
+                if(reflect){
+                    x     = small->x_size - x;
+                    theta = M_PI - theta;
+                }
+                switch(turn){               // Rotation about the tile center
+                    case 1: t = x; x = small->x_size - y; y = t; break;
+                    case 2: x = small->x_size - x; y = small->y_size - y; break;
+                    case 3: t = x; x = y; y = small->y_size - t; break;
+                }
+                theta = wrap(theta + turn*M_PI_2, M_2PI);
+                x = wrap(x, small->x_size) + tx*small->x_size;
+                y = wrap(y, small->y_size) + ty*small->y_size;
+                if(obj->o_type < 0 || obj->o_type >= the_topology->n_types())
+                    fatal_error("No topology for object type %d\n", obj->o_type);
+                large->add_object(new object(map[obj->o_type], x, y, theta));
+            }
+        }
+    }
+    fprintf(stderr, "Tiled %d x %d copies of %d objects: %d objects%s\n",
+            k, m, n, large->n_objects(),
+            plain ? "" : (mirror ? " (rotations and reflections)"
+                                 : " (rotations only)"));
+
+    grid = new cell_list(large->x_size, large->y_size,
+            2.0*large->reach(forces), true);
+    large->fill_grid(grid);
+    n = 0;
+    for(i = 0; i < large->n_objects(); i++)
+        if(large->overlap(forces, large->get_object(i), i, grid)) n++;
+    if(n){                                  // Clean up the seams
+        the_relaxer = new relaxer(forces);
+        if(the_relaxer->run(large, MAX_RELAX) < 0){
+            fprintf(stderr, "Unable to remove the overlaps from %d objects\n", n);
+            exit(EXIT_FAILURE);
+        }
+        fprintf(stderr, "Removed overlaps of %d objects in %d iterations %g s\n",
+                n, the_relaxer->n_iter, the_relaxer->seconds);
+        delete the_relaxer;
+    }
+    large->write(stdout);
+
+    delete grid;
+    delete forces;
+    delete small;
+    delete large;
+
+    return 0;
+}